@@ -0,0 +1,26 @@
+#pragma once
+#include <stddef.h>
+
+// bump pointer arenas, from custom/arena.c
+//
+// allocations are carved sequentially from 64 KiB blocks of memory, and are all released at once by arena_reset or
+// arena_destroy without walking them. released blocks are kept for reuse by other arenas, as wasm memory can't shrink
+
+typedef struct __arena arena_t;
+
+typedef struct {
+  void* block;
+  char* ptr;
+} arena_mark_t;
+
+arena_t* arena_create(void);
+void arena_destroy(arena_t* arena);
+
+// 16 byte aligned like malloc, returns NULL if memory can't be grown
+void* arena_alloc(arena_t* arena, size_t size);
+// alignment must be a power of two
+void* arena_alloc_aligned(arena_t* arena, size_t size, size_t alignment);
+
+// arena_reset releases everything allocated after the mark was taken
+arena_mark_t arena_mark(arena_t* arena);
+void arena_reset(arena_t* arena, arena_mark_t mark);
@@ -1,159 +1,409 @@
 #include <stdlib.h>
 
+// segregated fit allocator with boundary tags, so malloc and free are O(1) in the number of free blocks
+//
+// every chunk starts with a 16 byte header, keeping allocations 16 byte aligned. free chunks are coalesced
+// immediately with their neighbours and stored in a list for their size class. chunks under SMALL_LIMIT bytes have a
+// size class every 16 bytes, larger chunks have SUB_BINS size classes per power of two (similar to TLSF). a bitmap of
+// non-empty classes finds the smallest class which can satisfy an allocation without walking any lists.
+//
+// the top chunk is the free space at the end of the heap, which is grown using memory.grow when needed
+//
+// memory which is known to be zero is tracked so calloc only has to clear dirty memory. new pages from memory.grow are
+// zero, so everything in the top chunk after clean_start is zero, and free chunks split from or retired with clean
+// memory are flagged CLEAN. free doesn't touch the allocation unless ALLOC_POISON is defined, which fills freed memory
+// with POISON_BYTE to help find use after free bugs
+//
+// defining ALLOC_STATS keeps the counters in struct heap_stats, which are otherwise compiled out
+
 #define PAGE_SIZE 65536
-#define ALLOC_OFFSET (sizeof(struct node))
-#define BLOCK_START(b) ((char*) (b) + ALLOC_OFFSET)
-
-static struct node {
-    struct node *prev;
-    struct node *next;
-    size_t size;
-    int padding; // pad to 16 bytes
-} alloc_list;
-
-// inspired by https://github.com/embeddedartistry/embedded-resources/blob/master/examples/c/malloc_freelist.c
-
-static void merge_blocks(struct node* node) {
-    struct node* last = NULL;
-
-    while(node && node->next) {
-        size_t end = (size_t) node + ALLOC_OFFSET + node->size;
-        struct node* next = node->next;
-
-        if (end == (size_t) next) {
-            // merge next into node
-            node->size += ALLOC_OFFSET + next->size;
-            node->next = next->next;
-            if (node->next->prev) node->next->prev = node;
-
-            // clear old allocation header to zero
-            next->prev = NULL;
-            next->next = NULL;
-            next->size = 0;
-        } else {
-            node = next;
-        }
+#define HEADER_SIZE 16
+#define MIN_CHUNK 48 // header + free list pointers only need 32 bytes, but smaller remainders aren't worth splitting off
+#define CHUNK_PTR(c) ((void*) ((char*) (c) + HEADER_SIZE))
+#define PTR_CHUNK(p) ((struct chunk*) ((char*) (p) - HEADER_SIZE))
+#define CHUNK_AT(c, offset) ((struct chunk*) ((char*) (c) + (offset)))
+
+// flags stored in the low bits of chunk sizes
+#define INUSE 1
+#define PREV_FREE 2
+#define CLEAN 4 // free chunk which is zero apart from the free list pointers
+#define CHUNK_SIZE(c) ((c)->size & ~15u)
+
+#define ALLOC_MAGIC 0xA110CA7E
+#define POISON_BYTE 0xDD
+
+#define SMALL_LIMIT 1024
+#define SMALL_LOG2 10
+#define SMALL_BINS (SMALL_LIMIT / 16)
+#define SUB_BINS 8
+#define SUB_BINS_LOG2 3
+#define NUM_BINS (SMALL_BINS + (32 - SMALL_LOG2) * SUB_BINS)
+#define MAP_WORDS ((NUM_BINS + 31) / 32)
+
+#define CLZ(x) (__wasm_i32__(1, (unsigned int) (x), 0x67)) // wasm: i32.clz
+#define CTZ(x) (__wasm_i32__(1, (unsigned int) (x), 0x68)) // wasm: i32.ctz
+
+struct chunk {
+    size_t prev_size; // size of the previous chunk, only valid when PREV_FREE is set
+    size_t size; // size including the header, with flags in the low bits
+    size_t magic; // ALLOC_MAGIC when allocated, used to ignore invalid frees
+    size_t padding;
+
+    // only valid when the chunk is free, overlapping with the allocation
+    struct chunk* next;
+    struct chunk* prev;
+};
+
+#ifdef ALLOC_STATS
+#define STATS(x) x
+static struct heap_stats stats;
+
+static void record_alloc(size_t requested, size_t size) {
+    stats.allocations++;
+    stats.in_use += size;
+    if (stats.in_use > stats.peak_in_use) stats.peak_in_use = stats.in_use;
+
+    // buckets are powers of two from 16 bytes
+    int bucket = requested <= 16 ? 0 : 28 - CLZ(requested - 1);
+    stats.size_buckets[bucket < HEAP_STATS_BUCKETS ? bucket : HEAP_STATS_BUCKETS - 1]++;
+}
+
+static void record_resize(size_t old_size, size_t new_size) {
+    stats.in_use += new_size - old_size;
+    if (stats.in_use > stats.peak_in_use) stats.peak_in_use = stats.in_use;
+}
+#else
+#define STATS(x)
+#endif
+
+static struct chunk* bins[NUM_BINS];
+static unsigned int bin_map[MAP_WORDS];
+static struct chunk* top;
+static char* clean_start; // everything from here to the end of the top chunk is zero
+static size_t dirty_bytes; // bytes at the start of the last allocation which may not be zero
+
+static int bin_index(size_t size) {
+    if (size < SMALL_LIMIT) return size >> 4;
+
+    int msb = 31 - CLZ(size);
+    return SMALL_BINS + (msb - SMALL_LOG2) * SUB_BINS + ((size >> (msb - SUB_BINS_LOG2)) & (SUB_BINS - 1));
+}
+
+static void insert_free(struct chunk* c) {
+    int bin = bin_index(CHUNK_SIZE(c));
+
+    c->prev = NULL;
+    c->next = bins[bin];
+    if (c->next) c->next->prev = c;
+    bins[bin] = c;
+    bin_map[bin >> 5] |= 1u << (bin & 31);
+    STATS(stats.free_chunks++);
+}
+
+static void remove_free(struct chunk* c) {
+    if (c->prev) {
+        c->prev->next = c->next;
+    } else {
+        int bin = bin_index(CHUNK_SIZE(c));
+        bins[bin] = c->next;
+        if (!c->next) bin_map[bin >> 5] &= ~(1u << (bin & 31));
+    }
+    if (c->next) c->next->prev = c->prev;
+    STATS(stats.free_chunks--);
+}
+
+// mark the chunk as free and set the boundary tag in the following chunk. free chunks are always coalesced, so the
+// previous chunk must be in use
+static void set_free(struct chunk* c, size_t size) {
+    c->size = size;
+    c->magic = 0;
+
+    struct chunk* next = CHUNK_AT(c, size);
+    next->prev_size = size;
+    next->size |= PREV_FREE;
+}
+
+// find a free chunk of at least size bytes
+static struct chunk* find_free(size_t size) {
+    int bin = bin_index(size);
+
+    // large classes can contain chunks smaller than size, so only check the first chunk
+    struct chunk* c = bins[bin];
+    if (c && CHUNK_SIZE(c) >= size) return c;
+
+    // every chunk in the following classes is large enough
+    bin++;
+    int word = bin >> 5;
+    if (word >= MAP_WORDS) return NULL;
+
+    unsigned int bits = bin_map[word] & (~0u << (bin & 31));
+    while (!bits) {
+        if (++word >= MAP_WORDS) return NULL;
+        bits = bin_map[word];
     }
+    return bins[(word << 5) + CTZ(bits)];
+}
+
+// mark the free chunk as allocated, splitting off any excess
+static void* use_chunk(struct chunk* c, size_t size) {
+    size_t total = CHUNK_SIZE(c);
+    int clean = c->size & CLEAN;
+
+    if (total - size >= MIN_CHUNK) {
+        struct chunk* rest = CHUNK_AT(c, size);
+        set_free(rest, total - size);
+        if (clean) rest->size |= CLEAN;
+        insert_free(rest);
+        total = size;
+    } else {
+        CHUNK_AT(c, total)->size &= ~PREV_FREE;
+    }
+
+    if (clean) {
+        // clear the free list pointers, the rest of the allocation is already zero
+        c->next = NULL;
+        c->prev = NULL;
+        dirty_bytes = 0;
+    } else {
+        dirty_bytes = total - HEADER_SIZE;
+    }
+
+    c->size = total | INUSE;
+    c->magic = ALLOC_MAGIC;
+    return CHUNK_PTR(c);
+}
+
+// make the top chunk a normal free chunk, followed by an in use fencepost as the memory after it isn't part of the heap
+static void retire_top() {
+    size_t size = CHUNK_SIZE(top);
+    if (size < MIN_CHUNK + HEADER_SIZE) {
+        // too small to be useful
+        top->size = size | INUSE;
+        top->magic = 0;
+        return;
+    }
+
+    struct chunk* fence = CHUNK_AT(top, size - HEADER_SIZE);
+    fence->size = HEADER_SIZE | INUSE;
+    fence->magic = 0;
+
+    set_free(top, size - HEADER_SIZE);
+    if ((char*) CHUNK_PTR(top) >= clean_start) top->size |= CLEAN;
+    insert_free(top);
+}
+
+// grow the heap so the top chunk has at least size bytes
+static int grow_heap(size_t size) {
+    size_t end = (size_t) __wasm_i32__(0, 0x3F, 0) * PAGE_SIZE; // wasm: memory.size
+    int contiguous = top && (size_t) top + CHUNK_SIZE(top) == end;
+
+    size_t missing = contiguous ? size - CHUNK_SIZE(top) : size;
+    int pages = (missing + PAGE_SIZE - 1) / PAGE_SIZE;
+    if (__wasm_i32__(1, pages, 0x40, 0) < 0) { // wasm: memory.grow(pages)
+        // failed to allocate...
+        return 0;
+    }
+
+    STATS(stats.grow_calls++; stats.heap_size += pages * PAGE_SIZE);
+    if (contiguous) {
+        top->size += pages * PAGE_SIZE;
+    } else {
+        // memory was grown by something else, so start a new region
+        if (top) retire_top();
+        top = (struct chunk*) end;
+        top->size = pages * PAGE_SIZE;
+        clean_start = CHUNK_PTR(top);
+    }
+    return 1;
+}
+
+static void* alloc_top(size_t size) {
+    // top always keeps space for a header so it can be used as the next chunk
+    if ((!top || CHUNK_SIZE(top) < size + HEADER_SIZE) && !grow_heap(size + HEADER_SIZE)) return NULL;
+
+    struct chunk* c = top;
+    top = CHUNK_AT(c, size);
+    top->size = CHUNK_SIZE(c) - size;
+
+    // the allocation is only zero after clean_start, and the new top header is no longer zero
+    char* ptr = CHUNK_PTR(c);
+    dirty_bytes = clean_start > ptr ? clean_start - ptr : 0;
+    if (dirty_bytes > size - HEADER_SIZE) dirty_bytes = size - HEADER_SIZE;
+    if (clean_start < (char*) CHUNK_PTR(top)) clean_start = CHUNK_PTR(top);
+
+    c->size = size | INUSE;
+    c->magic = ALLOC_MAGIC;
+    return CHUNK_PTR(c);
+}
+
+// size of the chunk needed for an allocation, or 0 if it is too large
+static size_t chunk_size(size_t size) {
+    if (size > (size_t) -1 - PAGE_SIZE) return 0;
+
+    size = (size + HEADER_SIZE + 15) & ~15u;
+    return size < MIN_CHUNK ? MIN_CHUNK : size;
 }
 
 void* malloc(size_t size) {
-    if(size > 0) {
-        size = (size + 31) & ~31; // 32 byte align
-
-        struct node *block = &alloc_list, *last = block;
-        while (block) {
-            if (block->size >= size) {
-                // found large enough block
-
-                if (block->size - size >= 48) {
-                    // split the block
-                    struct node *new_block = (struct node*) (BLOCK_START(block) + size);
-                    new_block->size = block->size - size - ALLOC_OFFSET;
-                    new_block->prev = block;
-                    new_block->next = block->next;
-
-                    block->size = size;
-                    if (block->next) block->next->prev = new_block;
-                    block->next = new_block;
-                }
-                // remove block from list
-                struct node *prev = block->prev, *next = block->next;
-
-                if (prev) prev->next = next;
-                if (next) next->prev = prev;
-
-                // place holder values which can be checked
-                block->next = (struct node *) -1;
-                block->prev = (struct node *) 7;
-
-                return BLOCK_START(block);
-            }
-
-            last = block;
-            block = block->next;
-        }
+    if (size == 0) return NULL;
 
-        // failed to find block, try allocating more webassembly memory
-        int pages = 1 + ((size + ALLOC_OFFSET) / PAGE_SIZE);
-        int result = __wasm_i32__(1, pages, 0x40, 0); // wasm: memory.grow(pages)
-        if (result < 0) {
-            // failed to allocate...
-            return NULL;
-        } else {
-            last->next = (struct node*) (result * PAGE_SIZE);
-            last->next->size = (pages * PAGE_SIZE) - ALLOC_OFFSET;
-            last->next->prev = last;
-
-            merge_blocks(last);
-            return malloc(size);
-        }
+    STATS(size_t requested = size);
+    size = chunk_size(size);
+    if (!size) return NULL;
+
+    struct chunk* c = find_free(size);
+    void* ptr;
+    if (c) {
+        remove_free(c);
+        ptr = use_chunk(c, size);
+    } else {
+        ptr = alloc_top(size);
     }
 
-    return NULL;
+    STATS(if (ptr) record_alloc(requested, CHUNK_SIZE(PTR_CHUNK(ptr))));
+    return ptr;
+}
+
+// free the chunk, merging it with its neighbours
+static void release_chunk(struct chunk* c) {
+    c->magic = 0;
+
+    size_t size = CHUNK_SIZE(c);
+#ifdef ALLOC_POISON
+    __wasm__(3, CHUNK_PTR(c), POISON_BYTE, size - HEADER_SIZE, 0xFC, 0x0B, 0x00); // memory.fill(destAddr value size)
+#endif
+    if (c->size & PREV_FREE) {
+        // merge into the previous chunk
+        c = (struct chunk*) ((char*) c - c->prev_size);
+        remove_free(c);
+        size += CHUNK_SIZE(c);
+    }
+
+    struct chunk* next = CHUNK_AT(c, size);
+    if (next == top) {
+        // merge into the top chunk
+        c->size = size + CHUNK_SIZE(top);
+        top = c;
+        return;
+    }
+    if (!(next->size & INUSE)) {
+        // merge the next chunk
+        remove_free(next);
+        size += CHUNK_SIZE(next);
+    }
+
+    set_free(c, size);
+    insert_free(c);
 }
 
 void free(void* ptr) {
     if (ptr) {
-        struct node* block = (struct node*) ((char*)ptr - ALLOC_OFFSET);
-
-        if ((int) block->next != -1 || (int) block->prev != 7) {
+        struct chunk* c = PTR_CHUNK(ptr);
+        if (c->magic != ALLOC_MAGIC || !(c->size & INUSE)) {
             // not an allocated block!
             return;
         }
 
-        // wipe block (technically not needed)
-        __wasm__(3, ptr, 0, block->size, 0xFC, 0x0B, 0x00); // memory.fill(destAddr value size)
+        STATS(stats.frees++; stats.in_use -= CHUNK_SIZE(c));
+        release_chunk(c);
+    }
+}
 
-        // find where to slot in block
-        struct node* list = &alloc_list;
-        while (list->next && list->next < block) {
-            list = list->next;
-        }
+// split off the end of an allocated chunk and free it
+static void release_tail(struct chunk* c, size_t size) {
+    struct chunk* tail = CHUNK_AT(c, size);
+    tail->size = (CHUNK_SIZE(c) - size) | INUSE;
 
-        // slot block into list
-        block->prev = list;
-        block->next = list->next;
+    c->size = size | (c->size & (INUSE | PREV_FREE));
+    release_chunk(tail);
+}
 
-        if (list->next && list->next->prev) list->next->prev = block;
-        list->next = block;
+void* realloc(void* ptr, size_t size) {
+    if (!ptr) return malloc(size);
 
-        // cleanup
-        merge_blocks(&alloc_list);
+    struct chunk* c = PTR_CHUNK(ptr);
+    if (c->magic != ALLOC_MAGIC || !(c->size & INUSE)) {
+        // not an allocated block!
+        return NULL;
     }
-}
 
-void* realloc(void* ptr, size_t size) {
-    if (ptr) {
-        struct node* block = (struct node*) ((char*)ptr - ALLOC_OFFSET);
+    size_t current = CHUNK_SIZE(c);
+    size_t needed = chunk_size(size);
+    if (!needed) return NULL;
+    STATS(stats.reallocations++);
 
-        if ((int) block->next != -1 || (int) block->prev != 7) {
-            // not an allocated block!
-            return NULL;
-        }
+    if (needed <= current) {
+        // shrink in place, freeing the end if it is large enough to be reused
+        if (current - needed >= MIN_CHUNK) release_tail(c, needed);
+        STATS(record_resize(current, CHUNK_SIZE(c)));
+        return ptr;
+    }
 
-        if (block->size > size) {
-            // block already large enough
-            return ptr;
-        }
+    struct chunk* next = CHUNK_AT(c, current);
+    if (next == top && CHUNK_SIZE(top) < needed - current + HEADER_SIZE) {
+        // may start a new region instead if memory was grown by something else, retiring top as a free chunk
+        grow_heap(needed - current + HEADER_SIZE);
+    }
+
+    if (next == top && CHUNK_SIZE(top) >= needed - current + HEADER_SIZE) {
+        // extend into the top chunk
+        top = CHUNK_AT(c, needed);
+        top->size = CHUNK_SIZE(next) - (needed - current);
+        if (clean_start < (char*) CHUNK_PTR(top)) clean_start = CHUNK_PTR(top);
+
+        c->size = needed | (c->size & (INUSE | PREV_FREE));
+        STATS(record_resize(current, needed));
+        return ptr;
+    }
+
+    if (!(next->size & INUSE) && current + CHUNK_SIZE(next) >= needed) {
+        // extend into the following free chunk
+        size_t total = current + CHUNK_SIZE(next);
+        remove_free(next);
+        CHUNK_AT(c, total)->size &= ~PREV_FREE;
+
+        c->size = total | (c->size & (INUSE | PREV_FREE));
+        if (total - needed >= MIN_CHUNK) release_tail(c, needed);
+        STATS(record_resize(current, CHUNK_SIZE(c)));
+        return ptr;
+    }
 
-        void* new_ptr = malloc(size);
-        __wasm__(3, new_ptr, ptr, block->size, 0xFC, 0x0A, 0x00, 0x00); // memory.copy(destAddr sourceAddr size)
+    void* new_ptr = malloc(size);
+    if (new_ptr) {
+        __wasm__(3, new_ptr, ptr, current - HEADER_SIZE, 0xFC, 0x0A, 0x00, 0x00); // memory.copy(destAddr sourceAddr size)
         free(ptr);
-        return new_ptr;
     }
-    return NULL;
+    return new_ptr;
 }
 
 void* calloc(size_t nobj, size_t size) {
     if (nobj && size) {
+        if (nobj > (size_t) -1 / size) return NULL;
+
         size *= nobj;
         void* ptr = malloc(size);
 
-        if (ptr) {
-            // should already be zeroed... but do it again just in case
-            __wasm__(3, ptr, 0, size, 0xFC, 0x0B, 0x00); // memory.fill(destAddr value size)
+        if (ptr && dirty_bytes) {
+            // only clear memory which isn't known to be zero
+            __wasm__(3, ptr, 0, dirty_bytes < size ? dirty_bytes : size, 0xFC, 0x0B, 0x00); // memory.fill(destAddr value size)
         }
         return ptr;
     }
     return NULL;
 }
+
+#ifdef ALLOC_STATS
+const struct heap_stats* heap_stats(void) {
+    // the largest free chunk is in the highest non-empty class, which is only searched when the stats are requested
+    stats.largest_free = top ? CHUNK_SIZE(top) - HEADER_SIZE : 0;
+    for (int word = MAP_WORDS - 1; word >= 0; word--) {
+        if (!bin_map[word]) continue;
+
+        for (struct chunk* c = bins[(word << 5) + 31 - CLZ(bin_map[word])]; c; c = c->next) {
+            if (CHUNK_SIZE(c) - HEADER_SIZE > stats.largest_free) stats.largest_free = CHUNK_SIZE(c) - HEADER_SIZE;
+        }
+        break;
+    }
+    return &stats;
+}
+#endif
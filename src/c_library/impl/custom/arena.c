@@ -0,0 +1,114 @@
+#include <c2wasm/arena.h>
+
+#define PAGE_SIZE 65536
+#define BLOCK_SIZE PAGE_SIZE
+#define DEFAULT_ALIGNMENT 16
+
+struct block {
+    struct block* prev; // previous block in the arena, or next block when released
+    size_t size; // including this header
+    size_t padding[2];
+};
+
+struct __arena {
+    struct block* block; // current block, allocations are made from ptr to end
+    char* ptr;
+    char* end;
+    size_t padding;
+};
+
+// blocks released by arenas for reuse, with larger blocks kept at the front
+static struct block* released;
+
+static struct block* get_block(size_t size) {
+    if (released && released->size >= size) {
+        struct block* block = released;
+        released = block->prev;
+        return block;
+    }
+
+    int pages = (size + PAGE_SIZE - 1) / PAGE_SIZE;
+    int result = __wasm_i32__(1, pages, 0x40, 0); // wasm: memory.grow(pages)
+    if (result < 0) return NULL;
+
+    struct block* block = (struct block*) (result * PAGE_SIZE);
+    block->size = pages * PAGE_SIZE;
+    return block;
+}
+
+static void release_block(struct block* block) {
+    if (!released || block->size >= released->size) {
+        block->prev = released;
+        released = block;
+    } else {
+        // keep the largest block first, as only the first block is checked when getting a block
+        block->prev = released->prev;
+        released->prev = block;
+    }
+}
+
+arena_t* arena_create(void) {
+    struct block* block = get_block(BLOCK_SIZE);
+    if (!block) return NULL;
+    block->prev = NULL;
+
+    // the arena is stored at the start of its first block
+    arena_t* arena = (arena_t*) (block + 1);
+    arena->block = block;
+    arena->ptr = (char*) (arena + 1);
+    arena->end = (char*) block + block->size;
+    return arena;
+}
+
+void arena_destroy(arena_t* arena) {
+    if (arena) {
+        struct block* block = arena->block;
+        while (block) {
+            struct block* prev = block->prev;
+            release_block(block);
+            block = prev;
+        }
+    }
+}
+
+void* arena_alloc_aligned(arena_t* arena, size_t size, size_t alignment) {
+    char* ptr = (char*) (((size_t) arena->ptr + alignment - 1) & ~(alignment - 1));
+
+    if (ptr + size > arena->end || ptr + size < ptr) {
+        // start a new block, large enough for the allocation
+        size_t needed = sizeof(struct block) + alignment + size;
+        if (needed < size) return NULL;
+
+        struct block* block = get_block(needed > BLOCK_SIZE ? needed : BLOCK_SIZE);
+        if (!block) return NULL;
+
+        block->prev = arena->block;
+        arena->block = block;
+        arena->end = (char*) block + block->size;
+        ptr = (char*) (((size_t) (block + 1) + alignment - 1) & ~(alignment - 1));
+    }
+
+    arena->ptr = ptr + size;
+    return ptr;
+}
+
+void* arena_alloc(arena_t* arena, size_t size) {
+    return arena_alloc_aligned(arena, size, DEFAULT_ALIGNMENT);
+}
+
+arena_mark_t arena_mark(arena_t* arena) {
+    arena_mark_t mark = {arena->block, arena->ptr};
+    return mark;
+}
+
+void arena_reset(arena_t* arena, arena_mark_t mark) {
+    // release blocks allocated after the mark
+    while (arena->block != mark.block) {
+        struct block* prev = arena->block->prev;
+        release_block(arena->block);
+        arena->block = prev;
+    }
+
+    arena->ptr = mark.ptr;
+    arena->end = (char*) arena->block + arena->block->size;
+}
@@ -0,0 +1,120 @@
+#pragma once
+
+// internal helpers for converting between doubles and decimal digits, shared by printf, strtod and scanf
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// significant digits kept when parsing, enough to decide how any decimal string rounds to a double as the halfway
+// points between doubles have at most 768 significant digits
+#define DECIMAL_MAX_DIGITS 800
+
+// the value of a parsed decimal string is digits * 10^exp10, with digits as an integer
+struct decimal {
+    int count;
+    int exp10;
+    bool truncated; // nonzero digits were dropped after the first DECIMAL_MAX_DIGITS
+    unsigned char digits[DECIMAL_MAX_DIGITS];
+};
+
+static void decimal_init(struct decimal *d) {
+    d->count = 0;
+    d->exp10 = 0;
+    d->truncated = false;
+}
+
+// appends a digit from before or after the decimal point
+static void decimal_digit(struct decimal *d, int digit, bool fraction) {
+    if (fraction) d->exp10--;
+    if (d->count == 0 && digit == 0) return;
+    if (d->count < DECIMAL_MAX_DIGITS) {
+        d->digits[d->count++] = digit;
+    } else {
+        d->exp10++;
+        if (digit) d->truncated = true;
+    }
+}
+
+// adds an exponent parsed after 'e', which callers clamp so the sum can't overflow
+static void decimal_exponent(struct decimal *d, int exp10) {
+    d->exp10 += exp10;
+}
+
+// the absolute value of d correctly rounded to the nearest double, ties to even
+double __decimal_to_double(struct decimal *d);
+
+// writes the digits of |value| rounded to ndigits significant digits, or to ndigits digits after the decimal point
+// when fixed is true, to buffer as characters. returns the number of digits without trailing zeros, which is 0 when
+// the value rounds to zero, and stores the exponent of the first digit in exp10. buffer must hold DTOA_BUFFER_SIZE
+#define DTOA_BUFFER_SIZE 800
+int __dtoa(double value, int ndigits, bool fixed, char *buffer, int *exp10);
+
+// 64 x 64 -> 128 bit multiplication, returning the low half
+static uint64_t umul128(uint64_t a, uint64_t b, uint64_t *high) {
+    uint64_t a0 = (uint32_t) a, a1 = a >> 32, b0 = (uint32_t) b, b1 = b >> 32;
+    uint64_t p00 = a0 * b0, p01 = a0 * b1, p10 = a1 * b0, p11 = a1 * b1;
+    uint64_t mid1 = p10 + (p00 >> 32);
+    uint64_t mid2 = p01 + (uint32_t) mid1;
+    *high = p11 + (mid1 >> 32) + (mid2 >> 32);
+    return (mid2 << 32) | (uint32_t) p00;
+}
+
+// arbitrary precision unsigned integers in base 10^9, least significant limb first, for the exact slow paths. 128
+// limbs fit the digits of any double and the values compared by __decimal_to_double
+#define BIG_LIMBS 128
+#define BIG_BASE 1000000000
+
+struct big {
+    int size;
+    uint32_t limbs[BIG_LIMBS];
+};
+
+static void big_set(struct big *a, uint64_t x) {
+    a->size = 0;
+    while (x) {
+        a->limbs[a->size++] = x % BIG_BASE;
+        x /= BIG_BASE;
+    }
+}
+
+static void big_mul_small(struct big *a, uint32_t x) {
+    uint64_t carry = 0;
+    for (int i = 0; i < a->size; i++) {
+        carry += (uint64_t) a->limbs[i] * x;
+        a->limbs[i] = carry % BIG_BASE;
+        carry /= BIG_BASE;
+    }
+    while (carry) {
+        a->limbs[a->size++] = carry % BIG_BASE;
+        carry /= BIG_BASE;
+    }
+}
+
+static void big_add_small(struct big *a, uint32_t x) {
+    for (int i = 0; x; i++) {
+        if (i == a->size) a->limbs[a->size++] = 0;
+        uint32_t sum = a->limbs[i] + x;
+        a->limbs[i] = sum % BIG_BASE;
+        x = sum / BIG_BASE;
+    }
+}
+
+static void big_mul_pow5(struct big *a, int n) {
+    for (; n >= 13; n -= 13) big_mul_small(a, 1220703125);
+    uint32_t x = 1;
+    while (n--) x *= 5;
+    if (x > 1) big_mul_small(a, x);
+}
+
+static void big_mul_pow2(struct big *a, int n) {
+    for (; n >= 29; n -= 29) big_mul_small(a, 1u << 29);
+    if (n) big_mul_small(a, 1u << n);
+}
+
+static int big_compare(const struct big *a, const struct big *b) {
+    if (a->size != b->size) return a->size < b->size ? -1 : 1;
+    for (int i = a->size - 1; i >= 0; i--) {
+        if (a->limbs[i] != b->limbs[i]) return a->limbs[i] < b->limbs[i] ? -1 : 1;
+    }
+    return 0;
+}
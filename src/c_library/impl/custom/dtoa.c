@@ -0,0 +1,352 @@
+#include <stdbool.h>
+#include <stdint.h>
+#include <wasm/f64.h>
+#include "decimal.h"
+
+// double to decimal conversion for printf. the shortest digits which round trip are found with Ryu (Ulf Adams, "Ryu:
+// fast float-to-string conversion", PLDI 2018), which are then rounded to the requested precision when that is exact,
+// falling back to exact big integer arithmetic otherwise
+
+// Ryu's small tables: 5^i for i < 26 and every 26th 125 bit power of five and inverse, with the error of the
+// products of the two packed in 2 bits per entry
+static const uint64_t POW5_TABLE[26] = {
+    0x0000000000000001ULL, 0x0000000000000005ULL, 0x0000000000000019ULL, 0x000000000000007dULL,
+    0x0000000000000271ULL, 0x0000000000000c35ULL, 0x0000000000003d09ULL, 0x000000000001312dULL,
+    0x000000000005f5e1ULL, 0x00000000001dcd65ULL, 0x00000000009502f9ULL, 0x0000000002e90eddULL,
+    0x000000000e8d4a51ULL, 0x0000000048c27395ULL, 0x000000016bcc41e9ULL, 0x000000071afd498dULL,
+    0x0000002386f26fc1ULL, 0x000000b1a2bc2ec5ULL, 0x000003782dace9d9ULL, 0x00001158e460913dULL,
+    0x000056bc75e2d631ULL, 0x0001b1ae4d6e2ef5ULL, 0x000878678326eac9ULL, 0x002a5a058fc295edULL,
+    0x00d3c21bcecceda1ULL, 0x0422ca8b0a00a425ULL,
+};
+
+static const uint64_t POW5_SPLIT[13][2] = {
+    {0x0000000000000000ULL, 0x1000000000000000ULL},
+    {0x0000000000000000ULL, 0x14adf4b7320334b9ULL},
+    {0x0e549208b31adb10ULL, 0x1aba4714957d300dULL},
+    {0x6dc6ad264d8f0866ULL, 0x1145b7e285bf98f5ULL},
+    {0xeb1dbd923d8596caULL, 0x1652efdc6018a1fcULL},
+    {0xb4c1b80b22ae923cULL, 0x1cda62055b2d9d83ULL},
+    {0x5bb28b4e8f7e4c30ULL, 0x12a5568b9f52f416ULL},
+    {0xf08aed437682d4fbULL, 0x1819651531f9e78fULL},
+    {0xb4ee134ad99bf150ULL, 0x1f25c186a6f04c28ULL},
+    {0x16499ecb70c25f03ULL, 0x1420eb449c8842e6ULL},
+    {0x85a56ead360865b0ULL, 0x1a03fde214caf085ULL},
+    {0x093db1d57999890bULL, 0x10cfeb353a97dad8ULL},
+    {0xcf38bb735e3f36acULL, 0x15baaf44fa52673eULL},
+};
+
+static const uint64_t POW5_INV_SPLIT[15][2] = {
+    {0x0000000000000001ULL, 0x2000000000000000ULL},
+    {0x52a6c95fc0655034ULL, 0x18c240c4aecb13bbULL},
+    {0x7ca8d50071dfc806ULL, 0x1327fc58da0f6ff5ULL},
+    {0x6520247d3556476eULL, 0x1da48ce468e7c702ULL},
+    {0x6139cdd76802e6e9ULL, 0x16ef5b40c2fc7779ULL},
+    {0xf951a7ff43de8c79ULL, 0x11bebdf578b2f391ULL},
+    {0x7be8bee8d6e957e8ULL, 0x1b758d848fac54b0ULL},
+    {0x8bd3f9e999a423eaULL, 0x153eda614071a3b7ULL},
+    {0x0848f973cb3ee3ceULL, 0x10701bd527b4978cULL},
+    {0x153285ebb9efbfa2ULL, 0x196fbb9bb44db44dULL},
+    {0xadeee7f86c07b696ULL, 0x13ae3591f5b4d936ULL},
+    {0x4d686a4eaf182222ULL, 0x1e74404f3daada91ULL},
+    {0x98c0a106e09ebd9fULL, 0x17900ea4fda7c257ULL},
+    {0x8f20e37371497d0eULL, 0x123b140576d820b2ULL},
+    {0xb043138134743d85ULL, 0x1c35f4275f7a29adULL},
+};
+
+static const uint32_t POW5_OFFSETS[21] = {
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x40000000, 0x59695995,
+    0x55545555, 0x56555515, 0x41150504, 0x40555410, 0x44555145, 0x44504540,
+    0x45555550, 0x40004000, 0x96440440, 0x55565565, 0x54454045, 0x40154151,
+    0x55559155, 0x51405555, 0x00000105,
+};
+
+static const uint32_t POW5_INV_OFFSETS[22] = {
+    0x54544554, 0x04055545, 0x10041000, 0x00400414, 0x40010000, 0x41155555,
+    0x00000454, 0x00010044, 0x40000000, 0x44000041, 0x50454450, 0x55550054,
+    0x51655554, 0x40004000, 0x01000001, 0x00010500, 0x51515411, 0x05555554,
+    0x50411500, 0x40040000, 0x05040110, 0x00000000,
+};
+
+#define POW5_BITS 125
+#define POW5_TABLE_SIZE 26
+
+static int pow5bits(int e) {
+    return ((e * 1217359) >> 19) + 1; // ceil(log2(5^e)) for 0 < e < 3529
+}
+
+static int log10_pow2(int e) {
+    return (e * 78913) >> 18; // floor(log10(2^e)) for 0 <= e <= 1650
+}
+
+static int log10_pow5(int e) {
+    return (e * 732923) >> 20; // floor(log10(5^e)) for 0 <= e <= 2620
+}
+
+static uint64_t shiftright128(uint64_t low, uint64_t high, int n) {
+    return (high << (64 - n)) | (low >> n); // 0 < n < 64
+}
+
+// 5^i as a 125 bit number
+static void compute_pow5(int i, uint64_t *result) {
+    int base = i / POW5_TABLE_SIZE, base2 = base * POW5_TABLE_SIZE;
+    const uint64_t *mul = POW5_SPLIT[base];
+    if (i == base2) {
+        result[0] = mul[0];
+        result[1] = mul[1];
+        return;
+    }
+    uint64_t m = POW5_TABLE[i - base2], high1, high0;
+    uint64_t low1 = umul128(m, mul[1], &high1);
+    uint64_t low0 = umul128(m, mul[0], &high0);
+    uint64_t sum = high0 + low1;
+    if (sum < high0) high1++;
+    int delta = pow5bits(i) - pow5bits(base2);
+    result[0] = shiftright128(low0, sum, delta) + ((POW5_OFFSETS[i / 16] >> ((i % 16) << 1)) & 3);
+    result[1] = shiftright128(sum, high1, delta);
+}
+
+// 2^(pow5bits(i) - 1 + 125) / 5^i, rounded up
+static void compute_inv_pow5(int i, uint64_t *result) {
+    int base = (i + POW5_TABLE_SIZE - 1) / POW5_TABLE_SIZE, base2 = base * POW5_TABLE_SIZE;
+    const uint64_t *mul = POW5_INV_SPLIT[base];
+    if (i == base2) {
+        result[0] = mul[0];
+        result[1] = mul[1];
+        return;
+    }
+    uint64_t m = POW5_TABLE[base2 - i], high1, high0;
+    uint64_t low1 = umul128(m, mul[1], &high1);
+    uint64_t low0 = umul128(m, mul[0] - 1, &high0);
+    uint64_t sum = high0 + low1;
+    if (sum < high0) high1++;
+    int delta = pow5bits(base2) - pow5bits(i);
+    result[0] = shiftright128(low0, sum, delta) + 1 + ((POW5_INV_OFFSETS[i / 16] >> ((i % 16) << 1)) & 3);
+    result[1] = shiftright128(sum, high1, delta);
+}
+
+// (m * mul) >> j for a 55 bit m and 64 < j < 128
+static uint64_t mul_shift(uint64_t m, const uint64_t *mul, int j) {
+    uint64_t high1, high0;
+    uint64_t low1 = umul128(m, mul[1], &high1);
+    umul128(m, mul[0], &high0);
+    uint64_t sum = high0 + low1;
+    if (sum < high0) high1++;
+    return shiftright128(sum, high1, j - 64);
+}
+
+static bool multiple_of_pow5(uint64_t value, int p) {
+    int count = 0;
+    while (value % 5 == 0) {
+        value /= 5;
+        count++;
+    }
+    return count >= p;
+}
+
+static bool multiple_of_pow2(uint64_t value, int p) {
+    return (value & ((1ULL << p) - 1)) == 0;
+}
+
+// the shortest decimal which rounds to the double with this mantissa and biased exponent, as output * 10^exp10.
+// this is Ryu's d2d, see the paper for the derivation of the bounds
+static uint64_t shortest(uint64_t ieee_mantissa, int ieee_exponent, int *exp10) {
+    int e2;
+    uint64_t m2;
+    if (ieee_exponent == 0) {
+        e2 = 1 - 1023 - 52 - 2;
+        m2 = ieee_mantissa;
+    } else {
+        e2 = ieee_exponent - 1023 - 52 - 2;
+        m2 = (1ULL << 52) | ieee_mantissa;
+    }
+    bool accept_bounds = (m2 & 1) == 0;
+
+    // the interval of decimals which round to the double is (4 * m2 - 1 - mm_shift, 4 * m2 + 2) * 2^e2
+    uint64_t mv = 4 * m2;
+    int mm_shift = ieee_mantissa != 0 || ieee_exponent <= 1 ? 1 : 0;
+
+    uint64_t vr, vp, vm, pow5[2];
+    int e10;
+    bool vm_trailing_zeros = false, vr_trailing_zeros = false;
+    if (e2 >= 0) {
+        int q = log10_pow2(e2) - (e2 > 3);
+        e10 = q;
+        int k = POW5_BITS + pow5bits(q) - 1;
+        int i = -e2 + q + k;
+        compute_inv_pow5(q, pow5);
+        vr = mul_shift(4 * m2, pow5, i);
+        vp = mul_shift(4 * m2 + 2, pow5, i);
+        vm = mul_shift(4 * m2 - 1 - mm_shift, pow5, i);
+        if (q <= 21) {
+            // only one of mp, mv and mm can be a multiple of 5
+            if (mv % 5 == 0) {
+                vr_trailing_zeros = multiple_of_pow5(mv, q);
+            } else if (accept_bounds) {
+                vm_trailing_zeros = multiple_of_pow5(mv - 1 - mm_shift, q);
+            } else {
+                if (multiple_of_pow5(mv + 2, q)) vp--;
+            }
+        }
+    } else {
+        int q = log10_pow5(-e2) - (-e2 > 1);
+        e10 = q + e2;
+        int i = -e2 - q;
+        int k = pow5bits(i) - POW5_BITS;
+        int j = q - k;
+        compute_pow5(i, pow5);
+        vr = mul_shift(4 * m2, pow5, j);
+        vp = mul_shift(4 * m2 + 2, pow5, j);
+        vm = mul_shift(4 * m2 - 1 - mm_shift, pow5, j);
+        if (q <= 1) {
+            // mv = 4 * m2 has at least 2 trailing zero bits, and mp = mv + 2 has one
+            vr_trailing_zeros = true;
+            if (accept_bounds) {
+                vm_trailing_zeros = mm_shift == 1;
+            } else {
+                vp--;
+            }
+        } else if (q < 63) {
+            vr_trailing_zeros = multiple_of_pow2(mv, q);
+        }
+    }
+
+    // remove digits while the interval still contains a shorter decimal
+    int removed = 0, last_removed = 0;
+    uint64_t output;
+    if (vm_trailing_zeros || vr_trailing_zeros) {
+        while (vp / 10 > vm / 10) {
+            vm_trailing_zeros = vm_trailing_zeros && vm % 10 == 0;
+            vr_trailing_zeros = vr_trailing_zeros && last_removed == 0;
+            last_removed = (int) (vr % 10);
+            vr /= 10;
+            vp /= 10;
+            vm /= 10;
+            removed++;
+        }
+        if (vm_trailing_zeros) {
+            while (vm % 10 == 0) {
+                vr_trailing_zeros = vr_trailing_zeros && last_removed == 0;
+                last_removed = (int) (vr % 10);
+                vr /= 10;
+                vp /= 10;
+                vm /= 10;
+                removed++;
+            }
+        }
+        // round half to even when the exact value is ...50..0
+        if (vr_trailing_zeros && last_removed == 5 && vr % 2 == 0) last_removed = 4;
+        output = vr;
+        if ((vr == vm && (!accept_bounds || !vm_trailing_zeros)) || last_removed >= 5) output++;
+    } else {
+        bool round_up = false;
+        if (vp / 100 > vm / 100) {
+            round_up = vr % 100 >= 50;
+            vr /= 100;
+            vp /= 100;
+            vm /= 100;
+            removed += 2;
+        }
+        while (vp / 10 > vm / 10) {
+            round_up = vr % 10 >= 5;
+            vr /= 10;
+            vp /= 10;
+            vm /= 10;
+            removed++;
+        }
+        output = vr;
+        if (vr == vm || round_up) output++;
+    }
+    *exp10 = e10 + removed;
+    return output;
+}
+
+// keeps the first `keep` digits, rounding up if needed, and returns the count without trailing zeros
+static int round_digits(char *buffer, int keep, bool up, int *exp10) {
+    if (up) {
+        int i = keep - 1;
+        while (i >= 0 && buffer[i] == '9') i--;
+        if (i < 0) {
+            buffer[0] = '1';
+            *exp10 += 1;
+            return 1;
+        }
+        buffer[i]++;
+        keep = i + 1;
+    }
+    while (keep > 0 && buffer[keep - 1] == '0') keep--;
+    return keep;
+}
+
+// all the digits of m * 2^e2 rounded half to even, as for __dtoa
+static int exact(uint64_t m, int e2, int ndigits, bool fixed, char *buffer, int *exp10) {
+    struct big a;
+    big_set(&a, m);
+    if (e2 >= 0) {
+        big_mul_pow2(&a, e2);
+    } else {
+        big_mul_pow5(&a, -e2); // m * 2^e2 = m * 5^-e2 * 10^e2
+    }
+
+    int n = 0;
+    for (uint32_t x = a.limbs[a.size - 1]; x; x /= 10) n++;
+    for (int i = n - 1, x = a.limbs[a.size - 1]; i >= 0; i--, x /= 10) buffer[i] = '0' + x % 10;
+    for (int limb = a.size - 2; limb >= 0; limb--) {
+        uint32_t x = a.limbs[limb];
+        for (int i = 8; i >= 0; i--, x /= 10) buffer[n + i] = '0' + x % 10;
+        n += 9;
+    }
+    *exp10 = (e2 < 0 ? e2 : 0) + n - 1;
+
+    int keep = fixed ? *exp10 + ndigits + 1 : ndigits;
+    if (keep < 0) return 0;
+    if (keep >= n) return round_digits(buffer, n, false, exp10);
+
+    bool up = buffer[keep] > '5';
+    if (buffer[keep] == '5') {
+        up = keep > 0 && (buffer[keep - 1] - '0') % 2 == 1;
+        for (int i = keep + 1; i < n; i++) {
+            if (buffer[i] != '0') up = true;
+        }
+    }
+    return round_digits(buffer, keep, up, exp10);
+}
+
+int __dtoa(double value, int ndigits, bool fixed, char *buffer, int *exp10) {
+    uint64_t bits = i64_reinterpret_f64(value);
+    uint64_t mantissa = bits & ((1ULL << 52) - 1);
+    int exponent = (bits >> 52) & 0x7ff;
+    if (exponent == 0 && mantissa == 0) return 0;
+    uint64_t m = exponent ? mantissa | (1ULL << 52) : mantissa;
+    int e2 = (exponent ? exponent : 1) - 1075;
+
+    // subnormals are exact, as they have fewer than 17 significant bits and the shortest digits can't be padded
+    if (exponent == 0) return exact(m, e2, ndigits, fixed, buffer, exp10);
+
+    int last;
+    uint64_t output = shortest(mantissa, exponent, &last);
+    int n = 0;
+    for (uint64_t x = output; x; x /= 10) n++;
+    for (int i = n - 1; i >= 0; i--, output /= 10) buffer[i] = '0' + output % 10;
+    int e = last + n - 1;
+    int pos = fixed ? -ndigits : e - ndigits + 1;
+
+    if (pos <= last) {
+        // the value is within half an ulp of the shortest digits, under half a unit of the 15th significant digit.
+        // a power of ten may be the shortest digits of a value below it, which has its first digit one place lower
+        bool pow10 = n == 1 && buffer[0] == '1';
+        if (e - pos < (pow10 ? 14 : 15)) {
+            *exp10 = e;
+            return n;
+        }
+    } else {
+        // rounding the shortest digits is the same as rounding the value, as they're the value rounded to the
+        // nearest within the interval, unless they're exactly halfway
+        int keep = e - pos + 1;
+        if (keep < 0) return 0;
+        if (keep != n - 1 || buffer[keep] != '5') {
+            *exp10 = e;
+            return round_digits(buffer, keep, buffer[keep] >= '5', exp10);
+        }
+    }
+    return exact(m, e2, ndigits, fixed, buffer, exp10);
+}
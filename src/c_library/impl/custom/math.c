@@ -1,4 +1,5 @@
 #include <math.h>
+#include <wasm/f32.h>
 #include <wasm/f64.h>
 
 // c89 simple wasm instructions
@@ -39,13 +40,53 @@ double round(double d) {
     return f64_nearest(d);
 }
 
-// other functions
-double exp(double d) {
-    double sum = 1 + d, factorial = 1, power = d;
-    for (int k = 2; k <= 5; k++) {
-        power *= d;
-        factorial *= k;
-        sum += power / factorial;
-    }
-    return sum;
+double modf(double x, double *iptr) {
+    double i = f64_trunc(x);
+    *iptr = i;
+    return f64_copysign(f64_abs(x) == INFINITY ? 0.0 : x - i, x);
+}
+
+/* float versions */
+
+float sqrtf(float f) {
+    return f32_sqrt(f);
+}
+
+float ceilf(float f) {
+    return f32_ceil(f);
+}
+
+float fabsf(float f) {
+    return f32_abs(f);
+}
+
+float floorf(float f) {
+    return f32_floor(f);
+}
+
+float fmaxf(float f1, float f2) {
+    return f32_max(f1, f2);
+}
+
+float fminf(float f1, float f2) {
+    return f32_min(f1, f2);
+}
+
+float truncf(float f) {
+    return f32_trunc(f);
+}
+
+float copysignf(float f1, float f2) {
+    return f32_copysign(f1, f2);
+}
+
+float roundf(float f) {
+    return f32_nearest(f);
+}
+
+float modff(float x, float *iptr) {
+    double i;
+    float f = (float) modf(x, &i);
+    *iptr = (float) i;
+    return f;
 }
@@ -0,0 +1,130 @@
+#include <stdlib.h>
+#include <stdint.h>
+#ifdef QSORT_SIMD
+#include <wasm/simd128.h>
+#endif
+
+// introsort: quicksort with median of three (or ninther) pivots, insertion sort for small partitions and heapsort if
+// the recursion gets too deep, so the worst case is O(n log n). when the comparator is a constant the optimiser clones
+// these functions with direct calls to it (see specialise_function_pointers)
+
+#define INSERTION_SORT_MAX 16
+#define NINTHER_MIN 128
+
+typedef int cmp_t(const void *, const void *);
+
+// swaps whole words where the element size allows, wasm loads and stores don't have to be aligned
+static void swap(char* a, char* b, size_t size) {
+#ifdef QSORT_SIMD
+    if (size % 16 == 0) {
+        for (size_t i = 0; i < size; i += 16) {
+            v128_t t = v128_load(a + i);
+            v128_store(a + i, v128_load(b + i));
+            v128_store(b + i, t);
+        }
+        return;
+    }
+#endif
+    if (size % 8 == 0) {
+        for (size_t i = 0; i < size; i += 8) {
+            uint64_t t = *(uint64_t*) (a + i);
+            *(uint64_t*) (a + i) = *(uint64_t*) (b + i);
+            *(uint64_t*) (b + i) = t;
+        }
+    } else if (size % 4 == 0) {
+        for (size_t i = 0; i < size; i += 4) {
+            uint32_t t = *(uint32_t*) (a + i);
+            *(uint32_t*) (a + i) = *(uint32_t*) (b + i);
+            *(uint32_t*) (b + i) = t;
+        }
+    } else {
+        for (size_t i = 0; i < size; i++) {
+            char t = a[i];
+            a[i] = b[i];
+            b[i] = t;
+        }
+    }
+}
+
+static char* med3(char* a, char* b, char* c, cmp_t* cmp) {
+    return cmp(a, b) < 0 ?
+           (cmp(b, c) < 0 ? b : (cmp(a, c) < 0 ? c : a)) :
+           (cmp(b, c) > 0 ? b : (cmp(a, c) < 0 ? a : c));
+}
+
+static void insertion_sort(char* base, size_t n, size_t size, cmp_t* cmp) {
+    char* end = base + n * size;
+    for (char* i = base + size; i < end; i += size) {
+        for (char* j = i; j > base && cmp(j - size, j) > 0; j -= size) swap(j - size, j, size);
+    }
+}
+
+static void sift_down(char* base, size_t root, size_t n, size_t size, cmp_t* cmp) {
+    for (;;) {
+        size_t child = 2 * root + 1;
+        if (child >= n) return;
+        if (child + 1 < n && cmp(base + child * size, base + (child + 1) * size) < 0) child++;
+        if (cmp(base + root * size, base + child * size) >= 0) return;
+        swap(base + root * size, base + child * size, size);
+        root = child;
+    }
+}
+
+static void heap_sort(char* base, size_t n, size_t size, cmp_t* cmp) {
+    for (size_t i = n / 2; i > 0; i--) sift_down(base, i - 1, n, size, cmp);
+    for (size_t i = n - 1; i > 0; i--) {
+        swap(base, base + i * size, size);
+        sift_down(base, 0, i, size, cmp);
+    }
+}
+
+static void introsort(char* base, size_t n, size_t size, cmp_t* cmp, int depth) {
+    while (n > INSERTION_SORT_MAX) {
+        if (depth-- == 0) {
+            heap_sort(base, n, size, cmp);
+            return;
+        }
+
+        char* last = base + (n - 1) * size;
+        char* pivot = base + (n / 2) * size;
+        if (n >= NINTHER_MIN) {
+            size_t d = (n / 8) * size;
+            pivot = med3(med3(base, base + d, base + 2 * d, cmp), med3(pivot - d, pivot, pivot + d, cmp),
+                         med3(last - 2 * d, last - d, last, cmp), cmp);
+        } else {
+            pivot = med3(base, pivot, last, cmp);
+        }
+        swap(base, pivot, size);
+
+        // Hoare partition around base[0], stopping on equal elements so runs of duplicates are split evenly
+        char* i = base;
+        char* j = last + size;
+        for (;;) {
+            do i += size; while (i <= last && cmp(i, base) < 0);
+            do j -= size; while (j > base && cmp(j, base) > 0);
+            if (i >= j) break;
+            swap(i, j, size);
+        }
+        swap(base, j, size);
+
+        // recurse into the smaller side and loop on the larger, limiting the stack to O(log n)
+        size_t left = (j - base) / size, right = n - left - 1;
+        if (left < right) {
+            introsort(base, left, size, cmp, depth);
+            base = j + size;
+            n = right;
+        } else {
+            introsort(j + size, right, size, cmp, depth);
+            n = left;
+        }
+    }
+    insertion_sort(base, n, size, cmp);
+}
+
+void qsort(void* base, size_t nmemb, size_t size, cmp_t* cmp) {
+    if (nmemb < 2 || size == 0) return;
+
+    int depth = 0;
+    for (size_t n = nmemb; n > 1; n >>= 1) depth += 2;
+    introsort(base, nmemb, size, cmp, depth);
+}
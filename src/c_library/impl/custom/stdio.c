@@ -28,14 +28,147 @@ int puts(const char *s) {
 #define __fhandle_stderr 2
 #define __fhandle_fname 3
 
-static FILE __stdin = {__fhandle_stdin, -1, false, false};
+#define __fhandle_flag_str 1
+#define __fhandle_flag_own_buf 2
+#define __fhandle_flag_listed 4
+#define __fhandle_flag_read_only 8
+
+static FILE __stdin = {__fhandle_stdin, -1, 0, __fhandle_flag_read_only, false, false, _IOFBF, 0, BUFSIZ};
 FILE* stdin = &__stdin;
 static FILE __stdout = {__fhandle_stdout, -1, false, false};
 FILE* stdout = &__stdout;
 static FILE __stderr = {__fhandle_stderr, -1, false, false};
 FILE* stderr = &__stderr;
 
-#define __fhandle_flag_str 1
+// files and stdin are fully buffered by default, stdout and stderr are unbuffered unless changed using setvbuf. write
+// buffers are flushed by fflush, fclose, exit, before reading or seeking the stream, and before any files are opened,
+// renamed or removed so the host always sees the written contents
+static FILE *buffered_streams;
+static bool write_unsupported, read_unsupported;
+
+// __read and __write are unsupported until the host has access to memory, so try them again once it does
+void __stdio_attached(void) {
+    write_unsupported = false;
+    read_unsupported = false;
+}
+
+// write directly to the file, using __write unless the host doesn't support it
+static int write_bytes(FILE *stream, const char *data, size_t len) {
+    if (!write_unsupported) {
+        int result = __write(stream->handle, data, len);
+        if (result != -2) {
+            if (result == len) return 0;
+            stream->error = true;
+            return EOF;
+        }
+        write_unsupported = true;
+    }
+
+    for (size_t i = 0; i < len; i++) {
+        if (__put_char(stream->handle, data[i]) < 0) {
+            stream->error = true;
+            return EOF;
+        }
+    }
+    return 0;
+}
+
+// read directly from the file, using __read unless the host doesn't support it. returns the number of bytes read, 0 at
+// the end of the file or -1 on error
+static int read_bytes(FILE *stream, char *dest, size_t len) {
+    if (!read_unsupported) {
+        int result = __read(stream->handle, dest, len);
+        if (result != -2) return result < 0 ? -1 : result;
+        read_unsupported = true;
+    }
+
+    // only read a single byte, reading more could wait for input which isn't needed yet
+    int c = __get_char(stream->handle);
+    if (c < 0) return c == EOF ? 0 : -1;
+    *dest = c;
+    return 1;
+}
+
+// drop buffered input, moving the file position back to the first unread byte
+static void discard_input(FILE *stream) {
+    int unread = stream->rbuf_end - stream->rbuf_pos;
+    stream->rbuf_pos = stream->rbuf_end = 0;
+    if (unread) __set_pos(stream->handle, __get_pos(stream->handle) - unread);
+}
+
+static int flush_buffer(FILE *stream) {
+    if (stream->buf_len == 0) return 0;
+
+    int len = stream->buf_len;
+    stream->buf_len = 0;
+    return write_bytes(stream, stream->buf, len);
+}
+
+static void link_buffered(FILE *stream) {
+    if (stream->flags & __fhandle_flag_listed) return;
+    stream->flags |= __fhandle_flag_listed;
+    stream->next_buffered = buffered_streams;
+    buffered_streams = stream;
+}
+
+static void unlink_buffered(FILE *stream) {
+    if (!(stream->flags & __fhandle_flag_listed)) return;
+    stream->flags &= ~__fhandle_flag_listed;
+
+    FILE **f = &buffered_streams;
+    while (*f != stream) f = &(*f)->next_buffered;
+    *f = stream->next_buffered;
+}
+
+static bool ensure_buffer(FILE *stream) {
+    if (stream->buf) return true;
+
+    stream->buf = malloc(stream->buf_size);
+    if (stream->buf == NULL) {
+        stream->buf_mode = _IONBF;
+        return false;
+    }
+    stream->flags |= __fhandle_flag_own_buf;
+    link_buffered(stream);
+    return true;
+}
+
+static int put_bytes(FILE *stream, const char *data, size_t len) {
+    if (stream->flags & (__fhandle_flag_str | __fhandle_flag_read_only)) return EOF;
+    if (stream->rbuf_end) discard_input(stream);
+    if (stream->buf_mode == _IONBF || !ensure_buffer(stream)) return write_bytes(stream, data, len);
+
+    if (stream->buf_len + len > stream->buf_size) {
+        if (flush_buffer(stream) < 0) return EOF;
+        // too large to be worth buffering
+        if (len >= stream->buf_size) return write_bytes(stream, data, len);
+    }
+
+    memcpy(stream->buf + stream->buf_len, data, len);
+    stream->buf_len += len;
+    if (stream->buf_mode == _IOLBF && memchr(data, '\n', len)) return flush_buffer(stream);
+    return 0;
+}
+
+// flush pending writes before reading, including stdout before waiting for input
+static void prepare_read(FILE *stream) {
+    if (stream->buf_len) flush_buffer(stream);
+    if (stream == stdin && stdout->buf_len) flush_buffer(stdout);
+}
+
+// returns the next byte, refilling the buffer if needed. EOF at the end of the file, or another negative value on error
+static int next_byte(FILE *stream) {
+    if (stream->rbuf_pos < stream->rbuf_end) return (unsigned char) stream->buf[stream->rbuf_pos++];
+
+    prepare_read(stream);
+    if (stream->buf_mode == _IONBF || !ensure_buffer(stream)) return __get_char(stream->handle);
+
+    int n = read_bytes(stream, stream->buf, stream->buf_size);
+    if (n <= 0) return n == 0 ? EOF : -2;
+    stream->rbuf_pos = 1;
+    stream->rbuf_end = n;
+    return (unsigned char) stream->buf[0];
+}
 
 static void store_fname(const char *s) {
     char *x = s;
@@ -51,6 +184,7 @@ FILE *fopen(const char *filename, const char *mode) {
 }
 
 FILE *freopen(const char *filename, const char *mode, FILE* stream) {
+    fflush(NULL);
     store_fname(filename);
     if (!__exists() && strchr(mode, 'r')) {
         return NULL;
@@ -58,15 +192,22 @@ FILE *freopen(const char *filename, const char *mode, FILE* stream) {
 
     if (stream == NULL) {
         stream = malloc(sizeof(struct __stdio_file));
+        stream->flags = 0;
+        stream->buf_mode = _IOFBF;
+        stream->buf_size = BUFSIZ;
+        stream->buf = NULL;
     }
 
     store_fname(filename);
     stream->handle = __get_fhandle();
     stream->unget = -1;
     stream->len = 0;
-    stream->flags = 0;
+    stream->flags &= __fhandle_flag_own_buf | __fhandle_flag_listed;
+    if (!strchr(mode, 'w') && !strchr(mode, 'a') && !strchr(mode, '+')) stream->flags |= __fhandle_flag_read_only;
     stream->error = false;
     stream->eof = false;
+    stream->buf_len = 0;
+    stream->rbuf_pos = stream->rbuf_end = 0;
 
     if (strchr(mode, 'a')) {
         fseek(stream, 0, SEEK_END);
@@ -82,22 +223,39 @@ void __str2file(FILE *stream, const char *data) {
     stream->flags = __fhandle_flag_str;
     stream->error = false;
     stream->eof = false;
+    stream->buf_mode = _IONBF;
+    stream->buf_len = 0;
+    stream->buf = NULL;
+    stream->rbuf_pos = stream->rbuf_end = 0;
 }
 
 int fflush(FILE* stream) {
-    return 0; // no op
+    if (stream) return flush_buffer(stream);
+
+    int result = 0;
+    for (FILE *f = buffered_streams; f; f = f->next_buffered) {
+        if (flush_buffer(f) < 0) result = EOF;
+    }
+    return result;
 }
 
 int fclose(FILE* stream) {
+    if (stream == NULL) return EOF;
+
+    int result = flush_buffer(stream);
+    unlink_buffered(stream);
+    if (stream->flags & __fhandle_flag_own_buf) free(stream->buf);
     free(stream);
-    return 0;
+    return result;
 }
 
 int remove(const char *filename) {
+    fflush(NULL);
     return rename(filename, "");
 }
 
 int rename(const char *oldname, const char *newname) {
+    fflush(NULL);
     store_fname(oldname);
     store_fname(newname);
     return __move();
@@ -116,11 +274,25 @@ FILE *tmpfile(void) {
 }
 
 int setvbuf(FILE *stream, char *buf, int mode, size_t size) {
-    return -1; // no-op
+    if (mode != _IONBF && mode != _IOLBF && mode != _IOFBF) return -1;
+    // only a buffer allocated by the library defaults to BUFSIZ, a caller's buffer must say how big it is
+    if (buf && size == 0 && mode != _IONBF) return -1;
+    if (flush_buffer(stream) < 0) return -1;
+    discard_input(stream);
+
+    if (stream->flags & __fhandle_flag_own_buf) {
+        free(stream->buf);
+        stream->flags &= ~__fhandle_flag_own_buf;
+    }
+    stream->buf_mode = mode;
+    stream->buf_size = size > 0 ? size : BUFSIZ;
+    stream->buf = mode == _IONBF ? NULL : buf;
+    if (stream->buf) link_buffered(stream);
+    return 0;
 }
 
 void setbuf(FILE *stream, char *buf) {
-    // no-op
+    setvbuf(stream, buf, buf ? _IOFBF : _IONBF, BUFSIZ);
 }
 
 
@@ -142,7 +314,7 @@ int fgetc(FILE *stream) {
         stream->error = false;
         stream->len++;
     } else {
-        c = __get_char(stream->handle);
+        c = next_byte(stream);
         stream->eof = c == EOF;
         stream->error = c < 0 && c != EOF;
         stream->len++;
@@ -153,6 +325,22 @@ int fgetc(FILE *stream) {
 char *fgets(char *s, int n, FILE *stream) {
     int i = 0;
     while (i < n - 1) {
+        int available = stream->rbuf_end - stream->rbuf_pos;
+        if (available && stream->unget < 0) {
+            // copy directly from the buffer up to the next newline
+            char *start = stream->buf + stream->rbuf_pos;
+            if (available > n - 1 - i) available = n - 1 - i;
+            char *newline = memchr(start, '\n', available);
+            if (newline) available = newline - start + 1;
+
+            memcpy(s + i, start, available);
+            i += available;
+            stream->rbuf_pos += available;
+            stream->len += available;
+            if (newline) break;
+            continue;
+        }
+
         int c = fgetc(stream);
         if (c < 0) return NULL;
         s[i++] = c;
@@ -163,21 +351,24 @@ char *fgets(char *s, int n, FILE *stream) {
 }
 
 int fputc(int c, FILE *stream) {
-    if (stream->flags & __fhandle_flag_str) return EOF;
+    if (stream->flags & (__fhandle_flag_str | __fhandle_flag_read_only)) return EOF;
+    if (stream->rbuf_end) discard_input(stream);
+
+    if (stream->buf_mode != _IONBF && ensure_buffer(stream)) {
+        stream->buf[stream->buf_len++] = c;
+        if (stream->buf_len == stream->buf_size || (stream->buf_mode == _IOLBF && c == '\n')) {
+            if (flush_buffer(stream) < 0) return EOF;
+        }
+        return c;
+    }
+
     int result = __put_char(stream->handle, c);
     if (result >= 0) return c;
     return result;
 }
 
 int fputs(const char *s, FILE *stream) {
-    if (stream->flags & __fhandle_flag_str) return EOF;
-
-    char *x = s;
-    while (*x) {
-        if (__put_char(stream->handle, *x) < 0) return EOF;
-        x++;
-    }
-    return 0;
+    return put_bytes(stream, s, strlen(s));
 }
 
 int getchar(void) {
@@ -220,39 +411,67 @@ int ungetc(int c, FILE *stream) {
 
 
 size_t fread(void *ptr, size_t size, size_t nobj, FILE *stream) {
-    int n;
-    for (n = 0; n < nobj; n++) {
-        for (int i = 0; i < size; i++) {
+    size_t total = size * nobj, n = 0;
+    char *dest = ptr;
+    if (total == 0) return 0;
+
+    if (stream->unget >= 0 || stream->flags & __fhandle_flag_str) {
+        for (; n < total; n++) {
             int c = fgetc(stream);
-            if (c < 0) return n;
-            ((char*) ptr)[(n * size) + i] = c;
+            if (c < 0) return n / size;
+            dest[n] = c;
         }
+        return nobj;
     }
-    return n;
-}
 
-size_t fwrite(const void *ptr, size_t size, size_t nobj, FILE* stream) {
-    int n;
-    for (n = 0; n < nobj; n++) {
-        for (int i = 0; i < size; i++) {
-            if (fputc(((char*) ptr)[(n * size) + i], stream) < 0) {
-                return n;
-            }
+    while (n < total) {
+        int result;
+        size_t available = stream->rbuf_end - stream->rbuf_pos;
+        if (available) {
+            // copy from the buffer
+            if (available > total - n) available = total - n;
+            memcpy(dest + n, stream->buf + stream->rbuf_pos, available);
+            stream->rbuf_pos += available;
+            result = available;
+        } else if (stream->buf_mode != _IONBF && total - n < stream->buf_size) {
+            // refill the buffer
+            result = next_byte(stream);
+            if (result >= 0) dest[n] = result;
+            result = result >= 0 ? 1 : result == EOF ? 0 : -1;
+        } else {
+            // large reads go straight into the destination
+            prepare_read(stream);
+            result = read_bytes(stream, dest + n, total - n);
+        }
+
+        if (result <= 0) {
+            stream->eof = result == 0;
+            stream->error = result < 0;
+            break;
         }
+        n += result;
     }
-    return n;
+
+    stream->len += n;
+    return n / size;
+}
+
+size_t fwrite(const void *ptr, size_t size, size_t nobj, FILE* stream) {
+    if (size == 0 || nobj == 0) return 0;
+    if (put_bytes(stream, ptr, size * nobj) < 0) return 0;
+    return nobj;
 }
 
 
 
 int fseek(FILE *stream, long offset, int origin) {
-    if (stream->flags & __fhandle_flag_str) return -1;
+    if (stream->flags & __fhandle_flag_str || flush_buffer(stream) < 0) return -1;
 
     long pos;
     if (origin == SEEK_SET) {
         pos = offset;
     } else if (origin == SEEK_CUR) {
-        pos = __get_pos(stream->handle) + offset;
+        pos = __get_pos(stream->handle) - (stream->rbuf_end - stream->rbuf_pos) + offset;
     } else if (origin == SEEK_END) {
         pos = __get_len(stream->handle) + offset;
     } else {
@@ -262,11 +481,11 @@ int fseek(FILE *stream, long offset, int origin) {
 }
 
 long ftell(FILE *stream) {
-    if (stream->flags & __fhandle_flag_str) return -1;
+    if (stream->flags & __fhandle_flag_str || flush_buffer(stream) < 0) return -1;
 
     long pos = __get_pos(stream->handle);
     if (pos < 0) return -1;
-    return pos;
+    return pos - (stream->rbuf_end - stream->rbuf_pos);
 }
 
 void rewind(FILE *stream) {
@@ -275,18 +494,19 @@ void rewind(FILE *stream) {
 }
 
 int fgetpos(FILE *stream, fpos_t *ptr) {
-    if (stream->flags & __fhandle_flag_str) return -1;
+    if (stream->flags & __fhandle_flag_str || flush_buffer(stream) < 0) return -1;
 
     long pos = __get_pos(stream->handle);
     if (pos < 0) return -1;
-    *ptr = pos;
+    *ptr = pos - (stream->rbuf_end - stream->rbuf_pos);
     return 0;
 }
 
 int fsetpos(FILE *stream, const fpos_t *ptr) {
-    if (stream->flags & __fhandle_flag_str || __set_pos(stream->handle, *ptr) != 0) {
+    if (stream->flags & __fhandle_flag_str || flush_buffer(stream) < 0 || __set_pos(stream->handle, *ptr) != 0) {
         return -1;
     }
+    stream->rbuf_pos = stream->rbuf_end = 0;
     return 0;
 }
 
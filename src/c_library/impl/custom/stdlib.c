@@ -1,4 +1,7 @@
 #include <stdlib.h>
+#ifdef FILES
+#include <stdio.h>
+#endif
 
 // stubs
 void abort() {
@@ -6,6 +9,9 @@ void abort() {
 }
 
 void exit(int code) {
+#ifdef FILES
+    fflush(NULL);
+#endif
     __wasm__(0, 0x00);
 }
 
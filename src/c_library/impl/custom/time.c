@@ -1,5 +1,46 @@
 #include <time.h>
 
+#ifdef DETERMINISTIC_TIME
+static long ticks;
+
+static long clock_ns(int clock_id) {
+    return ticks += DETERMINISTIC_TIME;
+}
+#else
+#define clock_ns __clock_ns
+#endif
+
+long __c2wasm_now_ns(void) {
+    return clock_ns(CLOCK_MONOTONIC);
+}
+
 clock_t clock() {
+#ifdef DETERMINISTIC_TIME
+    return clock_ns(CLOCK_MONOTONIC) / 1000000.0;
+#else
     return __time();
+#endif
+}
+
+time_t time(time_t *t) {
+    time_t seconds = clock_ns(CLOCK_REALTIME) / 1000000000;
+    if (t) *t = seconds;
+    return seconds;
+}
+
+int clock_gettime(clockid_t clock_id, struct timespec *ts) {
+    if (clock_id != CLOCK_REALTIME && clock_id != CLOCK_MONOTONIC) return -1;
+    long ns = clock_ns(clock_id);
+    ts->tv_sec = ns / 1000000000;
+    ts->tv_nsec = ns % 1000000000;
+    return 0;
+}
+
+int clock_getres(clockid_t clock_id, struct timespec *ts) {
+    if (clock_id != CLOCK_REALTIME && clock_id != CLOCK_MONOTONIC) return -1;
+    if (ts) {
+        ts->tv_sec = 0;
+        ts->tv_nsec = 1;
+    }
+    return 0;
 }
@@ -42,6 +42,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include "custom/decimal.h"
 
 #define FL_STAR        0x01    /* '*': skip assignment		*/
 #define FL_WIDTH       0x02    /* width is present		*/
@@ -218,29 +219,18 @@ static const char *conv_brk(FILE *stream, int width, char *addr, const char *fmt
     }
 }
 
-static const double pwr_p10[6] = {
-        1e+1, 1e+2, 1e+4, 1e+8, 1e+16, 1e+32
-};
-static const double pwr_m10[6] = {
-        1e-1, 1e-2, 1e-4, 1e-8, 1e-16, 1e-32
-};
-
 static const char pstr_nfinity[] = "nfinity";
 static const char pstr_an[] = "an";
 
 static unsigned char conv_flt(FILE *stream, int width, double *addr) {
-    union {
-        unsigned long u32;
-        double flt;
-    } x;
+    struct decimal d;
+    double flt;
     int i;
     const char *p = 0;
-    int exp;
 
     unsigned char flag;
 #define FL_MINUS   0x80    /* number is negative	*/
 #define FL_ANY     0x02    /* any digit was readed	*/
-#define FL_OVFL    0x04    /* overflow was		*/
 #define FL_DOT     0x08    /* decimal '.' was	*/
 #define FL_MEXP    0x10    /* exponent 'e' is neg.	*/
     i = getc(stream);        /* after ungetc()	*/
@@ -269,28 +259,17 @@ static unsigned char conv_flt(FILE *stream, int width, double *addr) {
                     goto err;
                 }
             }
-            x.flt = (p == pstr_an + 3) ? NAN : INFINITY;
+            flt = (p == pstr_an + 3) ? NAN : INFINITY;
             break;
 
         default:
-            exp = 0;
-            x.u32 = 0;
+            decimal_init(&d);
             do {
                 unsigned char c = i - '0';
 
                 if (c <= 9) {
                     flag |= FL_ANY;
-                    if (flag & FL_OVFL) {
-                        if (!(flag & FL_DOT))
-                            exp += 1;
-                    } else {
-                        if (flag & FL_DOT)
-                            exp -= 1;
-                        x.u32 = x.u32 * 10 + c;
-                        if (x.u32 >= (ULONG_MAX - 9) / 10)
-                            flag |= FL_OVFL;
-                    }
-
+                    decimal_digit(&d, c, flag & FL_DOT);
                 } else if (c == (('.' - '0') & 0xff) && !(flag & FL_DOT)) {
                     flag |= FL_DOT;
                 } else {
@@ -318,34 +297,22 @@ static unsigned char conv_flt(FILE *stream, int width, double *addr) {
 
                 expacc = 0;
                 do {
-                    expacc = expacc * 10 + (i - '0');
+                    if (expacc < 100000)
+                        expacc = expacc * 10 + (i - '0');
                 } while (--width && isdigit(i = getc(stream)));
                 if (flag & FL_MEXP)
                     expacc = -expacc;
-                exp += expacc;
+                decimal_exponent(&d, expacc);
             }
 
             if (width && i >= 0) ungetc(i, stream);
 
-            x.flt = (double) (x.u32);
-
-            if (exp < 0) {
-                p = (void *) (pwr_m10 + 5);
-                exp = -exp;
-            } else {
-                p = (void *) (pwr_p10 + 5);
-            }
-            for (width = 32; width; width >>= 1) {
-                for (; (unsigned) exp >= width; exp -= width) {
-                    x.flt *= *((double *)p);
-                }
-                p = p - sizeof(double);
-            }
+            flt = __decimal_to_double(&d);
     } /* switch */
 
     if (flag & FL_MINUS)
-        x.flt = -x.flt;
-    if (addr) *addr = x.flt;
+        flt = -flt;
+    if (addr) *addr = flt;
     return 1;
 
     err:
@@ -0,0 +1,539 @@
+#include <math.h>
+#include "libm.h"
+
+/*
+ * Table driven exp, log and pow based on musl's (from ARM optimized-routines), without fma or long double.
+ *
+ * exp(x) = 2^(k/N) * exp(r) with |r| <= ln2/2N, where 2^(i/N) for i < N comes from the table and exp(r) is a short
+ * polynomial. log(x) = k*ln2 + log(c) + log1p(z/c - 1) with z in [0x1.6p-1, 0x1.6p0), using one table entry per
+ * 1/128 wide interval of z. pow computes log(x) as a double-double, so that y * log(x) is accurate enough to give a
+ * correctly rounded result in almost all cases.
+ *
+ * The tables were generated with 600 digit arithmetic.
+ */
+
+// pairs of (2^(i/N) - T) / T and the bits of T - (i << 45) where T is 2^(i/N) rounded to a double
+static const uint64_t exp_table[2 * EXP_N] = {
+    0x0000000000000000ULL, 0x3ff0000000000000ULL, 0x3c9b3b4f1a88bf6eULL, 0x3feff63da9fb3335ULL,
+    0xbc7160139cd8dc5dULL, 0x3fefec9a3e778061ULL, 0xbc905e7a108766d1ULL, 0x3fefe315e86e7f85ULL,
+    0x3c8cd2523567f613ULL, 0x3fefd9b0d3158574ULL, 0xbc8bce8023f98efaULL, 0x3fefd06b29ddf6deULL,
+    0x3c60f74e61e6c861ULL, 0x3fefc74518759bc8ULL, 0x3c90a3e45b33d399ULL, 0x3fefbe3ecac6f383ULL,
+    0x3c979aa65d837b6dULL, 0x3fefb5586cf9890fULL, 0x3c8eb51a92fdeffcULL, 0x3fefac922b7247f7ULL,
+    0x3c3ebe3d702f9cd1ULL, 0x3fefa3ec32d3d1a2ULL, 0xbc6a033489906e0bULL, 0x3fef9b66affed31bULL,
+    0xbc9556522a2fbd0eULL, 0x3fef9301d0125b51ULL, 0xbc5080ef8c4eea55ULL, 0x3fef8abdc06c31ccULL,
+    0xbc91c923b9d5f416ULL, 0x3fef829aaea92de0ULL, 0x3c80d3e3e95c55afULL, 0x3fef7a98c8a58e51ULL,
+    0xbc801b15eaa59348ULL, 0x3fef72b83c7d517bULL, 0xbc8f1ff055de323dULL, 0x3fef6af9388c8deaULL,
+    0x3c8b898c3f1353bfULL, 0x3fef635beb6fcb75ULL, 0xbc96d99c7611eb26ULL, 0x3fef5be084045cd4ULL,
+    0x3c9aecf73e3a2f60ULL, 0x3fef54873168b9aaULL, 0xbc8fe782cb86389dULL, 0x3fef4d5022fcd91dULL,
+    0x3c8a6f4144a6c38dULL, 0x3fef463b88628cd6ULL, 0x3c807a05b0e4047dULL, 0x3fef3f49917ddc96ULL,
+    0x3c968efde3a8a894ULL, 0x3fef387a6e756238ULL, 0x3c875e18f274487dULL, 0x3fef31ce4fb2a63fULL,
+    0x3c80472b981fe7f2ULL, 0x3fef2b4565e27cddULL, 0xbc96b87b3f71085eULL, 0x3fef24dfe1f56381ULL,
+    0x3c82f7e16d09ab31ULL, 0x3fef1e9df51fdee1ULL, 0xbc3d219b1a6fbffaULL, 0x3fef187fd0dad990ULL,
+    0x3c8b3782720c0ab4ULL, 0x3fef1285a6e4030bULL, 0x3c6e149289cecb8fULL, 0x3fef0cafa93e2f56ULL,
+    0x3c834d754db0abb6ULL, 0x3fef06fe0a31b715ULL, 0x3c864201e2ac744cULL, 0x3fef0170fc4cd831ULL,
+    0x3c8fdd395dd3f84aULL, 0x3feefc08b26416ffULL, 0xbc86a3803b8e5b04ULL, 0x3feef6c55f929ff1ULL,
+    0xbc924aedcc4b5068ULL, 0x3feef1a7373aa9cbULL, 0xbc9907f81b512d8eULL, 0x3feeecae6d05d866ULL,
+    0xbc71d1e83e9436d2ULL, 0x3feee7db34e59ff7ULL, 0xbc991919b3ce1b15ULL, 0x3feee32dc313a8e5ULL,
+    0x3c859f48a72a4c6dULL, 0x3feedea64c123422ULL, 0xbc9312607a28698aULL, 0x3feeda4504ac801cULL,
+    0xbc58a78f4817895bULL, 0x3feed60a21f72e2aULL, 0xbc7c2c9b67499a1bULL, 0x3feed1f5d950a897ULL,
+    0x3c4363ed60c2ac11ULL, 0x3feece086061892dULL, 0x3c9666093b0664efULL, 0x3feeca41ed1d0057ULL,
+    0x3c6ecce1daa10379ULL, 0x3feec6a2b5c13cd0ULL, 0x3c93ff8e3f0f1230ULL, 0x3feec32af0d7d3deULL,
+    0x3c7690cebb7aafb0ULL, 0x3feebfdad5362a27ULL, 0x3c931dbdeb54e077ULL, 0x3feebcb299fddd0dULL,
+    0xbc8f94340071a38eULL, 0x3feeb9b2769d2ca7ULL, 0xbc87deccdc93a349ULL, 0x3feeb6daa2cf6642ULL,
+    0xbc78dec6bd0f385fULL, 0x3feeb42b569d4f82ULL, 0xbc861246ec7b5cf6ULL, 0x3feeb1a4ca5d920fULL,
+    0x3c93350518fdd78eULL, 0x3feeaf4736b527daULL, 0x3c7b98b72f8a9b05ULL, 0x3feead12d497c7fdULL,
+    0x3c9063e1e21c5409ULL, 0x3feeab07dd485429ULL, 0x3c34c7855019c6eaULL, 0x3feea9268a5946b7ULL,
+    0x3c9432e62b64c035ULL, 0x3feea76f15ad2148ULL, 0xbc8ce44a6199769fULL, 0x3feea5e1b976dc09ULL,
+    0xbc8c33c53bef4da8ULL, 0x3feea47eb03a5585ULL, 0xbc845378892be9aeULL, 0x3feea34634ccc320ULL,
+    0xbc93cedd78565858ULL, 0x3feea23882552225ULL, 0x3c5710aa807e1964ULL, 0x3feea155d44ca973ULL,
+    0xbc93b3efbf5e2228ULL, 0x3feea09e667f3bcdULL, 0xbc6a12ad8734b982ULL, 0x3feea012750bdabfULL,
+    0xbc6367efb86da9eeULL, 0x3fee9fb23c651a2fULL, 0xbc80dc3d54e08851ULL, 0x3fee9f7df9519484ULL,
+    0xbc781f647e5a3ecfULL, 0x3fee9f75e8ec5f74ULL, 0xbc86ee4ac08b7db0ULL, 0x3fee9f9a48a58174ULL,
+    0xbc8619321e55e68aULL, 0x3fee9feb564267c9ULL, 0x3c909ccb5e09d4d3ULL, 0x3feea0694fde5d3fULL,
+    0xbc7b32dcb94da51dULL, 0x3feea11473eb0187ULL, 0x3c94ecfd5467c06bULL, 0x3feea1ed0130c132ULL,
+    0x3c65ebe1abd66c55ULL, 0x3feea2f336cf4e62ULL, 0xbc88a1c52fb3cf42ULL, 0x3feea427543e1a12ULL,
+    0xbc9369b6f13b3734ULL, 0x3feea589994cce13ULL, 0xbc805e843a19ff1eULL, 0x3feea71a4623c7adULL,
+    0xbc94d450d872576eULL, 0x3feea8d99b4492edULL, 0x3c90ad675b0e8a00ULL, 0x3feeaac7d98a6699ULL,
+    0x3c8db72fc1f0eab4ULL, 0x3feeace5422aa0dbULL, 0xbc65b6609cc5e7ffULL, 0x3feeaf3216b5448cULL,
+    0x3c7bf68359f35f44ULL, 0x3feeb1ae99157736ULL, 0xbc93091fa71e3d83ULL, 0x3feeb45b0b91ffc6ULL,
+    0xbc5da9b88b6c1e29ULL, 0x3feeb737b0cdc5e5ULL, 0xbc6c23f97c90b959ULL, 0x3feeba44cbc8520fULL,
+    0xbc92434322f4f9aaULL, 0x3feebd829fde4e50ULL, 0xbc85ca6cd7668e4bULL, 0x3feec0f170ca07baULL,
+    0x3c71affc2b91ce27ULL, 0x3feec49182a3f090ULL, 0x3c6dd235e10a73bbULL, 0x3feec86319e32323ULL,
+    0xbc87c50422622263ULL, 0x3feecc667b5de565ULL, 0x3c8b1c86e3e231d5ULL, 0x3feed09bec4a2d33ULL,
+    0xbc91bbd1d3bcbb15ULL, 0x3feed503b23e255dULL, 0x3c90cc319cee31d2ULL, 0x3feed99e1330b358ULL,
+    0x3c8469846e735ab3ULL, 0x3feede6b5579fdbfULL, 0xbc82dfcd978e9db4ULL, 0x3feee36bbfd3f37aULL,
+    0x3c8c1a7792cb3387ULL, 0x3feee89f995ad3adULL, 0xbc907b8f4ad1d9faULL, 0x3feeee07298db666ULL,
+    0xbc55c3d956dcaebaULL, 0x3feef3a2b84f15fbULL, 0xbc90a40e3da6f640ULL, 0x3feef9728de5593aULL,
+    0xbc68d6f438ad9334ULL, 0x3feeff76f2fb5e47ULL, 0xbc91eee26b588a35ULL, 0x3fef05b030a1064aULL,
+    0x3c74ffd70a5fddcdULL, 0x3fef0c1e904bc1d2ULL, 0xbc91bdfbfa9298acULL, 0x3fef12c25bd71e09ULL,
+    0x3c736eae30af0cb3ULL, 0x3fef199bdd85529cULL, 0x3c8ee3325c9ffd94ULL, 0x3fef20ab5fffd07aULL,
+    0x3c84e08fd10959acULL, 0x3fef27f12e57d14bULL, 0x3c63cdaf384e1a67ULL, 0x3fef2f6d9406e7b5ULL,
+    0x3c676b2c6c921968ULL, 0x3fef3720dcef9069ULL, 0xbc808a1883ccb5d2ULL, 0x3fef3f0b555dc3faULL,
+    0xbc8fad5d3ffffa6fULL, 0x3fef472d4a07897cULL, 0xbc900dae3875a949ULL, 0x3fef4f87080d89f2ULL,
+    0x3c74a385a63d07a7ULL, 0x3fef5818dcfba487ULL, 0xbc82919e2040220fULL, 0x3fef60e316c98398ULL,
+    0x3c8e5a50d5c192acULL, 0x3fef69e603db3285ULL, 0x3c843a59ac016b4bULL, 0x3fef7321f301b460ULL,
+    0xbc82d52107b43e1fULL, 0x3fef7c97337b9b5fULL, 0xbc892ab93b470dc9ULL, 0x3fef864614f5a129ULL,
+    0x3c74b604603a88d3ULL, 0x3fef902ee78b3ff6ULL, 0x3c83c5ec519d7271ULL, 0x3fef9a51fbc74c83ULL,
+    0xbc8ff7128fd391f0ULL, 0x3fefa4afa2a490daULL, 0xbc8dae98e223747dULL, 0x3fefaf482d8e67f1ULL,
+    0x3c8ec3bc41aa2008ULL, 0x3fefba1bee615a27ULL, 0x3c842b94c3a9eb32ULL, 0x3fefc52b376bba97ULL,
+    0x3c8a64a931d185eeULL, 0x3fefd0765b6e4540ULL, 0xbc8e37bae43be3edULL, 0x3fefdbfdad9cbe14ULL,
+    0x3c77893b4d91cd9dULL, 0x3fefe7c1819e90d8ULL, 0x3c5305c14160cc89ULL, 0x3feff3c22b8f71f1ULL,
+};
+
+// 1/c rounded to 9 bits, then -log(1/c) as hi + lo, for the intervals of z starting at 0x3fe6000000000000 + (i << 45).
+// 1/c is 1.0 either side of z = 1, so that log(x) is exact for x close to 1
+static const double log_table[3 * 128] = {
+    1.44921875, -0.3710246181278727, 2.122406120993782e-17,
+    1.44140625, -0.3656191995609647, 1.3629378153461892e-17,
+    1.43359375, -0.3601844035750078, 9.183161098421605e-18,
+    1.42578125, -0.35471990910292905, 2.5723845333224125e-17,
+    1.41796875, -0.34922538978528833, 2.7353198661030995e-17,
+    1.41015625, -0.34370051385331846, 1.2044907642022741e-17,
+    1.40234375, -0.3381449440087164, 2.1615585875304225e-17,
+    1.39453125, -0.3325583373000766, 1.0452065576244321e-17,
+    1.38671875, -0.32694034499585334, 1.7491334247872663e-17,
+    1.37890625, -0.3212906124537343, 1.1275300634302997e-17,
+    1.37109375, -0.31560877898630335, 1.613154981740814e-17,
+    1.3671875, -0.3127557100038969, 1.451808353098951e-17,
+    1.359375, -0.3070250352949119, 1.2319916200101964e-17,
+    1.3515625, -0.3012613305781618, 9.048511144048564e-18,
+    1.34375, -0.2954642128938359, 2.16461086040599e-17,
+    1.3359375, -0.28963329258304266, -2.0535953219858174e-17,
+    1.328125, -0.2837681731306446, 2.032665581126656e-17,
+    1.32421875, -0.2808226629008878, 2.4827800962650586e-17,
+    1.31640625, -0.2749054858727992, -2.2401714494357158e-17,
+    1.30859375, -0.26895308734550394, -2.0567264884778372e-17,
+    1.3046875, -0.26596354849713794, -5.3393802761314314e-18,
+    1.296875, -0.25995752443692605, -2.069806938978935e-17,
+    1.2890625, -0.25391520998096345, 8.048097394424201e-18,
+    1.28515625, -0.25088030628580943, 1.2457039343986644e-17,
+    1.27734375, -0.24478272641769092, -7.690455270851944e-19,
+    1.26953125, -0.238647737850175, 2.480208795706813e-18,
+    1.265625, -0.2355660713127669, 2.3943371495187355e-18,
+    1.2578125, -0.22937410106484582, -9.927671823978025e-18,
+    1.25, -0.22314355131420976, 9.091270597324799e-18,
+    1.24609375, -0.2200136583052821, 1.0079574422441999e-17,
+    1.23828125, -0.21372432939771813, -1.1984668242736255e-17,
+    1.234375, -0.21056476910734964, 4.249405314729895e-18,
+    1.2265625, -0.2042155414286909, -2.7338281018722773e-18,
+    1.22265625, -0.20102574606059073, -9.307006919883831e-18,
+    1.21484375, -0.19461546769967167, 9.286606646402599e-18,
+    1.2109375, -0.19139485299962947, 1.2129496905792884e-17,
+    1.203125, -0.184922338494012, -3.0236614153574064e-18,
+    1.19921875, -0.18167030310763468, 5.8870920167715034e-18,
+    1.1953125, -0.1784076574728183, 1.2432553788701131e-17,
+    1.1875, -0.17185025692665923, 6.0224538210113705e-18,
+    1.18359375, -0.16855536102980667, 4.849378323802459e-18,
+    1.17578125, -0.16193282026931324, -9.773924675229098e-18,
+    1.171875, -0.15860503017663857, -1.1257003872182592e-17,
+    1.16796875, -0.15526612891112396, 5.790029056368188e-18,
+    1.16015625, -0.14855469432313714, 1.53995371858771e-19,
+    1.15625, -0.1451820098444979, -8.242418783022475e-18,
+    1.15234375, -0.14179791186025734, -1.3587228662372945e-17,
+    1.14453125, -0.13499516453750482, -1.1344320488590788e-17,
+    1.140625, -0.13157635778871926, -1.1123000879729588e-17,
+    1.13671875, -0.12814582269193003, -4.564146029872488e-18,
+    1.12890625, -0.12124924363286968, -5.284805187745387e-18,
+    1.125, -0.11778303565638346, 1.1971685747593677e-18,
+    1.12109375, -0.11430477128005863, -5.1100358927720175e-18,
+    1.1171875, -0.11081436634029011, -1.183748342825649e-18,
+    1.109375, -0.10379679368164356, -5.47772415726659e-18,
+    1.10546875, -0.10026945316367515, 1.9556371293694694e-18,
+    1.1015625, -0.09672962645855111, 5.597397486289965e-19,
+    1.09765625, -0.0931772248541833, 6.707547381997404e-18,
+    1.08984375, -0.08603433734180316, 4.235394883227454e-18,
+    1.0859375, -0.08244366921107459, -5.700437773813987e-18,
+    1.08203125, -0.07884006170777602, -3.2379150876431256e-18,
+    1.078125, -0.07522342123758753, 5.930604196293241e-18,
+    1.07421875, -0.07159365318700882, 3.804421579719008e-19,
+    1.0703125, -0.06795066190850775, 1.2802141240611733e-18,
+    1.0625, -0.06062462181643484, -2.6424025938726934e-18,
+    1.05859375, -0.056941376400138424, -4.849020418096643e-19,
+    1.0546875, -0.053244514518812285, 1.665575816973663e-18,
+    1.05078125, -0.04953393512227663, -3.3991672076404202e-18,
+    1.046875, -0.0458095360312942, -1.902959866474257e-18,
+    1.04296875, -0.04207121392068706, 3.1329038365070074e-18,
+    1.0390625, -0.0383188643021366, 2.357996157351286e-18,
+    1.03515625, -0.034552381506659735, 1.6591063781278726e-18,
+    1.03125, -0.030771658666753687, -1.0431732029005968e-18,
+    1.02734375, -0.026976587698202076, 5.651841481310676e-20,
+    1.0234375, -0.02316705928153438, 1.1769544932063305e-18,
+    1.01953125, -0.019342962843130935, 2.2760589303784623e-19,
+    1.015625, -0.015504186535965254, 3.278321022892429e-19,
+    1.01171875, -0.011650617219975274, 2.3618788515509035e-19,
+    1.0078125, -0.007782140442054949, 1.2819179123343845e-20,
+    1.0, 0.0, 0.0,
+    1.0, 0.0, 0.0,
+    0.98828125, 0.01178795575204224, 2.208154666796622e-19,
+    0.98046875, 0.01972450534777859, -1.3445979863167511e-18,
+    0.97265625, 0.027724548014854862, -1.56535712927094e-18,
+    0.966796875, 0.033766862470817484, -5.747659606863015e-19,
+    0.958984375, 0.04188049724498721, -7.52116008109174e-19,
+    0.951171875, 0.050060501956918, -2.5103449679221735e-18,
+    0.9453125, 0.05623971832287608, -3.2835149805605613e-18,
+    0.9375, 0.06453852113757118, -6.470486661692933e-18,
+    0.931640625, 0.07080813415116657, -6.234995644437558e-18,
+    0.923828125, 0.07922923654757481, 3.844009567382204e-18,
+    0.91796875, 0.08559193033540351, 6.769872319991152e-18,
+    0.91015625, 0.09413899091386191, 1.4973805419956277e-18,
+    0.904296875, 0.10059757095327371, 3.4358803555888985e-18,
+    0.8984375, 0.1070981355563671, -1.73705104015906e-18,
+    0.892578125, 0.11364123414530308, 2.8032420937866185e-18,
+    0.88671875, 0.1202274269981598, -2.8375497328444e-18,
+    0.87890625, 0.12907704227514236, -1.2940973323385866e-17,
+    0.873046875, 0.13576603042593896, -8.167832575605495e-18,
+    0.8671875, 0.14250006260728304, -9.926388234225749e-18,
+    0.861328125, 0.1492797495926618, -6.131746752560801e-18,
+    0.85546875, 0.15610571466306167, -1.2806970330932862e-17,
+    0.849609375, 0.1629785939508237, -1.0909496295368068e-17,
+    0.845703125, 0.16758689703701793, 9.08839264811261e-18,
+    0.83984375, 0.17453941635189968, -1.5833038914101321e-18,
+    0.833984375, 0.18154061181088324, -9.164261232838093e-18,
+    0.828125, 0.18859116980755003, -7.432164219196925e-18,
+    0.822265625, 0.19569179135712636, 7.081666757681142e-18,
+    0.818359375, 0.20045370511737004, 1.3565866902520394e-17,
+    0.8125, 0.2076393647782445, 1.2053243216686129e-17,
+    0.806640625, 0.21487703207847503, 1.4126186922710852e-18,
+    0.802734375, 0.21973141054327316, 1.3474032480672356e-17,
+    0.796875, 0.22705745063534608, 9.551415762738488e-18,
+    0.79296875, 0.23197146543777514, 5.774320510479237e-18,
+    0.787109375, 0.23938806309282482, -1.2664106090474698e-17,
+    0.783203125, 0.2443631977329386, -4.008556524537438e-18,
+    0.77734375, 0.2518726197550701, -1.8984402852371785e-18,
+    0.7734375, 0.2569104137850272, 2.502843296152504e-17,
+    0.76953125, 0.26197371574157396, 3.769957084925505e-18,
+    0.763671875, 0.269617065054142, 4.0706357645790495e-19,
+    0.759765625, 0.27474528142106147, 2.0578963926931158e-17,
+    0.755859375, 0.27989993200972596, 1.827816970165335e-17,
+    0.75, 0.2876820724517809, 2.607160616442564e-17,
+    0.74609375, 0.2929040164329326, -2.097144388760612e-17,
+    0.7421875, 0.29815337231907635, -1.720695867445866e-17,
+    0.73828125, 0.3034304294199201, -4.151258540103992e-18,
+    0.734375, 0.3087354816496133, -1.6199186085148102e-17,
+    0.728515625, 0.31674620539569226, -1.6212702187378312e-17,
+};
+
+static const double
+    inv_ln2_n = 184.6649652337873,          // N/ln2
+    ln2hi_n = 0.005415212347998022,         // ln2/N with 35 bits, so k * ln2hi_n is exact
+    ln2lo_n = 1.2655086083325438e-13,
+    ln2hi = 0.6931471805598903,             // ln2 with 42 bits, so k * ln2hi is exact
+    ln2lo = 5.497923018708371e-14,
+    ln2 = 0.6931471805599453,
+    ivln10hi = 0.4342944819032518,          // 1/ln10
+    ivln10lo = 1.098319650216765e-17,
+    ivln2hi = 1.4426950408889634,           // 1/ln2
+    ivln2lo = 2.0355273740931033e-17;
+
+#define top12(x) ((uint32_t) (asuint64(x) >> 52))
+#define LOG_OFF 0x3fe6000000000000ULL
+
+/* exp */
+
+// x + xtail = k*ln2/N + r, returning the bits of 2^(k/N) and setting *tmp so that exp(x + xtail) = scale * (1 + tmp)
+static uint64_t exp_reduce(double x, double xtail, long *k, double *tmp) {
+    double kd = f64_nearest(x * inv_ln2_n);
+    long ki = (long) kd;
+    double r = x - kd * ln2hi_n - kd * ln2lo_n + xtail;
+    int idx = 2 * (int) (ki & (EXP_N - 1));
+
+    // exp(r) - 1 to within 2^-60
+    double r2 = r * r;
+    *tmp = asdouble(exp_table[idx]) + r + r2 * (0.5 + r * 0.16666666666666666) +
+        r2 * r2 * (0.041666666666666664 + r * 0.008333333333333333);
+    *k = ki;
+    return exp_table[idx + 1] + ((uint64_t) ki << 45);
+}
+
+// scale * (1 + tmp) when the exponent of scale may be outside the normal range
+static double exp_special(double tmp, uint64_t sbits, long k) {
+    if (k > 0) {
+        sbits -= 1009ULL << 52;
+        double scale = asdouble(sbits);
+        return asdouble(0x7f00000000000000ULL) * (scale + scale * tmp); // 2^1009
+    }
+
+    sbits += 1022ULL << 52;
+    double scale = asdouble(sbits);
+    double y = scale + scale * tmp;
+    if (y < 1.0) {
+        // the result is subnormal, so round y to the final precision before scaling to avoid double rounding
+        double lo = scale - y + scale * tmp;
+        double hi = 1.0 + y;
+        lo = 1.0 - hi + y + lo;
+        y = (hi + lo) - 1.0;
+        if (y == 0.0) y = 0.0; // not -0.0
+    }
+    return asdouble(0x0010000000000000ULL) * y; // 2^-1022
+}
+
+double __exp_tail(double x, double xtail) {
+    uint32_t abstop = top12(x) & 0x7ff;
+    if (abstop - 0x3c9 >= 0x408 - 0x3c9) {
+        // |x| < 2^-54, |x| >= 512 or nan
+        if (abstop < 0x3c9) return 1.0 + x;
+        if (abstop >= 0x409) {
+            if (asuint64(x) == asuint64(-INFINITY)) return 0.0;
+            if (abstop == 0x7ff) return 1.0 + x;
+            return asuint64(x) >> 63 ? 0.0 : INFINITY;
+        }
+        abstop = 0; // the result may overflow or underflow
+    }
+
+    long k;
+    double tmp;
+    uint64_t sbits = exp_reduce(x, xtail, &k, &tmp);
+    if (abstop == 0) return exp_special(tmp, sbits, k);
+    double scale = asdouble(sbits);
+    return scale + scale * tmp;
+}
+
+double exp(double x) {
+    return __exp_tail(x, 0.0);
+}
+
+double exp2(double x) {
+    uint32_t abstop = top12(x) & 0x7ff;
+    if (abstop - 0x3c9 >= 0x408 - 0x3c9) {
+        if (abstop < 0x3c9) return 1.0 + x;
+        if (abstop >= 0x409) {
+            if (asuint64(x) == asuint64(-INFINITY)) return 0.0;
+            if (abstop == 0x7ff) return 1.0 + x;
+            if (!(asuint64(x) >> 63)) return INFINITY;
+            if (x <= -1075.0) return 0.0;
+        }
+        abstop = 0;
+    }
+
+    // x = k/N + r exactly
+    double kd = f64_nearest(x * EXP_N);
+    long k = (long) kd;
+    double r = (x - kd * 0.0078125) * ln2; // 1/N
+    int idx = 2 * (int) (k & (EXP_N - 1));
+    double r2 = r * r;
+    double tmp = asdouble(exp_table[idx]) + r + r2 * (0.5 + r * 0.16666666666666666) +
+        r2 * r2 * (0.041666666666666664 + r * 0.008333333333333333);
+    uint64_t sbits = exp_table[idx + 1] + ((uint64_t) k << 45);
+
+    if (abstop == 0) return exp_special(tmp, sbits, k);
+    double scale = asdouble(sbits);
+    return scale + scale * tmp;
+}
+
+double expm1(double x) {
+    uint32_t abstop = top12(x) & 0x7ff;
+    if (abstop < 0x3fd) {
+        // |x| < 0.25, Taylor series to x^13
+        if (abstop < 0x3c9) return x;
+        double p = 0.5 + x * (0.16666666666666666 + x * (0.041666666666666664 + x * (0.008333333333333333 +
+            x * (0.001388888888888889 + x * (0.0001984126984126984 + x * (2.48015873015873e-05 +
+            x * (2.7557319223985893e-06 + x * (2.755731922398589e-07 + x * (2.505210838544172e-08 +
+            x * (2.08767569878681e-09 + x * 1.6059043836821613e-10))))))))));
+        return x + x * x * p;
+    }
+    if (abstop == 0x7ff) {
+        if (asuint64(x) == asuint64(-INFINITY)) return -1.0;
+        return x + x;
+    }
+    if (x >= 709.0) return exp(x);
+    if (x <= -38.0) return -1.0; // exp(x) < 2^-54
+
+    long k;
+    double tmp;
+    double scale = asdouble(exp_reduce(x, 0.0, &k, &tmp));
+    return (scale - 1.0) + scale * tmp;
+}
+
+/* log */
+
+double __log_dd(uint64_t ix, double *lo) {
+    // x = 2^k z with z in [OFF, 2 OFF) and the interval i of z
+    uint64_t tmp = ix - LOG_OFF;
+    int i = (int) ((tmp >> 45) & 127);
+    double kd = (double) ((long) tmp >> 52);
+    uint64_t iz = ix - (tmp & (0xfffULL << 52));
+    double z = asdouble(iz);
+    const double *t = log_table + 3 * i;
+    double invc = t[0], logc = t[1], logctail = t[2];
+
+    // r = z/c - 1 = rhi + rlo exactly: zhi has 26 bits and invc 9 bits, and zhi * invc is close to 1
+    double zhi = asdouble((iz + (1ULL << 26)) & (~0ULL << 27));
+    double rhi = zhi * invc - 1.0, rlo = (z - zhi) * invc;
+    double r = rhi + rlo;
+
+    // k*ln2 + log(c) + rhi - rhi^2/2 + rlo as an unevaluated sum
+    double w = kd * ln2hi;
+    double t1 = w + logc;
+    double e1 = w - t1 + logc;
+    double t2 = t1 + rhi;
+    double bv = t2 - t1;
+    double e2 = (t1 - (t2 - bv)) + (rhi - bv);
+    double sqlo, sq = two_product(rhi, rhi, &sqlo);
+    double hr = -0.5 * sq;
+    double t3 = t2 + hr;
+    bv = t3 - t2;
+    double e3 = (t2 - (t3 - bv)) + (hr - bv);
+    double t4 = t3 + rlo;
+    bv = t4 - t3;
+    double e4 = (t3 - (t4 - bv)) + (rlo - bv);
+
+    // log1p(r) - r + r^2/2 to r^11, with |r| < 0x1p-7
+    double r2 = r * r;
+    double p = r2 * r * (0.3333333333333333 - r * 0.25 + r2 * (0.2 - r * 0.16666666666666666) +
+        r2 * r2 * (0.14285714285714285 - r * 0.125 + r2 * (0.1111111111111111 - r * 0.1 + r2 * 0.09090909090909091)));
+
+    double l = e1 + e2 + e3 + e4 - 0.5 * sqlo + kd * ln2lo + logctail - rlo * (rhi + 0.5 * rlo) + p;
+    double hi = t4 + l;
+    *lo = t4 - hi + l;
+    return hi;
+}
+
+// the bits of x for __log_dd, normalising subnormals, or 0 with the result in *special for x <= 0, inf or nan
+static uint64_t log_bits(double x, double *special) {
+    uint64_t ix = asuint64(x);
+    if (ix - 0x0010000000000000ULL < 0x7ff0000000000000ULL - 0x0010000000000000ULL) return ix;
+
+    if (ix << 1 == 0) {
+        *special = -INFINITY;
+    } else if (ix == 0x7ff0000000000000ULL) {
+        *special = x;
+    } else if ((ix >> 63) || (ix >> 52) == 0x7ff) {
+        *special = (x - x) / (x - x);
+    } else {
+        return asuint64(x * 4503599627370496.0) - (52ULL << 52); // subnormal, scale by 2^52
+    }
+    return 0;
+}
+
+double log(double x) {
+    double special, lo;
+    uint64_t ix = log_bits(x, &special);
+    if (!ix) return special;
+    return __log_dd(ix, &lo);
+}
+
+double log10(double x) {
+    double special, lo;
+    uint64_t ix = log_bits(x, &special);
+    if (!ix) return special;
+    double hi = __log_dd(ix, &lo);
+    double plo, p = two_product(hi, ivln10hi, &plo);
+    return p + (plo + lo * ivln10hi + hi * ivln10lo);
+}
+
+double log2(double x) {
+    double special, lo;
+    uint64_t ix = log_bits(x, &special);
+    if (!ix) return special;
+    double hi = __log_dd(ix, &lo);
+    double plo, p = two_product(hi, ivln2hi, &plo);
+    return p + (plo + lo * ivln2hi + hi * ivln2lo);
+}
+
+double log1p(double x) {
+    if (!(x > -1.0)) return x == -1.0 ? -INFINITY : (x - x) / (x - x);
+    if (f64_abs(x) < 7.450580596923828e-09) return x - 0.5 * x * x; // |x| < 2^-27
+    if (x == INFINITY) return x;
+
+    // log(u) where u = 1 + x rounded, corrected by the rounding error c = u - (1 + x)
+    double u = 1.0 + x;
+    double c = (u - 1.0) - x;
+    double lo, hi = __log_dd(asuint64(u), &lo);
+    return hi + (lo - c / u);
+}
+
+/* pow */
+
+// 0 if y is not an integer, 1 if it is odd and 2 if it is even
+static int checkint(uint64_t iy) {
+    int e = (int) (iy >> 52 & 0x7ff);
+    if (e < 0x3ff) return 0;
+    if (e > 0x3ff + 52) return 2;
+    if (iy & ((1ULL << (0x3ff + 52 - e)) - 1)) return 0;
+    if (iy & (1ULL << (0x3ff + 52 - e))) return 1;
+    return 2;
+}
+
+// whether x is +-0, +-inf or nan
+#define zeroinfnan(i) (2 * (i) - 1 >= 2 * 0x7ff0000000000000ULL - 1)
+
+double pow(double x, double y) {
+    uint64_t ix = asuint64(x), iy = asuint64(y);
+    uint32_t topx = ix >> 52, topy = iy >> 52;
+    int negate = 0;
+
+    if (topx - 0x001 >= 0x7ff - 0x001 || (topy & 0x7ff) - 0x3be >= 0x43e - 0x3be) {
+        // x is subnormal, zero, negative, inf or nan, or |y| < 2^-65, |y| >= 2^63, inf or nan
+        if (zeroinfnan(iy)) {
+            if (iy << 1 == 0) return 1.0;
+            if (ix == 0x3ff0000000000000ULL) return 1.0;
+            if (ix << 1 > 0xffe0000000000000ULL || iy << 1 > 0xffe0000000000000ULL) return x + y;
+            if (ix << 1 == 0x7fe0000000000000ULL) return 1.0; // (-1)^inf
+            if ((ix << 1 < 0x7fe0000000000000ULL) == !(iy >> 63)) return 0.0; // |x| < 1 and y = inf, or |x| > 1 and y = -inf
+            return y * y;
+        }
+        if (zeroinfnan(ix)) {
+            double x2 = x * x;
+            if (ix >> 63 && checkint(iy) == 1) x2 = -x2;
+            return iy >> 63 ? 1 / x2 : x2;
+        }
+
+        // x and y are finite and non-zero
+        if (ix >> 63) {
+            int yint = checkint(iy);
+            if (yint == 0) return (x - x) / (x - x);
+            negate = yint == 1;
+            ix &= 0x7fffffffffffffffULL;
+            topx &= 0x7ff;
+        }
+        if ((topy & 0x7ff) - 0x3be >= 0x43e - 0x3be) {
+            if (ix == 0x3ff0000000000000ULL) return negate ? -1.0 : 1.0;
+            if ((topy & 0x7ff) < 0x3be) return ix > 0x3ff0000000000000ULL ? 1.0 + y : 1.0 - y; // x^y ~= 1 + y log(x)
+            return (ix > 0x3ff0000000000000ULL) == (topy < 0x800) ? (negate ? -INFINITY : INFINITY) : (negate ? -0.0 : 0.0);
+        }
+        if (topx == 0) {
+            ix = asuint64(asdouble(ix) * 4503599627370496.0) - (52ULL << 52); // subnormal, scale by 2^52
+        }
+    }
+
+    // y * log(x) as ehi + elo
+    double lo, hi = __log_dd(ix, &lo);
+    double elo, ehi = two_product(y, hi, &elo);
+    elo += y * lo;
+    double result = __exp_tail(ehi, elo);
+    return negate ? -result : result;
+}
+
+/* float versions, computed in double precision */
+
+float expf(float x) {
+    return (float) exp(x);
+}
+
+float exp2f(float x) {
+    return (float) exp2(x);
+}
+
+float expm1f(float x) {
+    return (float) expm1(x);
+}
+
+float logf(float x) {
+    return (float) log(x);
+}
+
+float log10f(float x) {
+    return (float) log10(x);
+}
+
+float log2f(float x) {
+    return (float) log2(x);
+}
+
+float log1pf(float x) {
+    return (float) log1p(x);
+}
+
+float powf(float x, float y) {
+    return (float) pow(x, y);
+}
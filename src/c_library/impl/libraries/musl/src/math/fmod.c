@@ -0,0 +1,111 @@
+#include <math.h>
+#include "libm.h"
+
+// fmod, frexp and scalbn from musl, with fmod reducing 11 bits at a time
+
+double fmod(double x, double y) {
+    uint64_t ux = asuint64(x), uy = asuint64(y);
+    int ex = (int) (ux >> 52 & 0x7ff), ey = (int) (uy >> 52 & 0x7ff);
+    uint64_t sx = ux & 0x8000000000000000ULL;
+
+    if (uy << 1 == 0 || y != y || ex == 0x7ff) return (x * y) / (x * y);
+    if (ux << 1 <= uy << 1) return ux << 1 == uy << 1 ? 0 * x : x;
+
+    // integer mantissas, normalising subnormals
+    if (!ex) {
+        for (uint64_t i = ux << 12; !(i >> 63); i <<= 1) ex--;
+        ux <<= -ex + 1;
+    } else {
+        ux = (ux & 0xfffffffffffffULL) | 0x10000000000000ULL;
+    }
+    if (!ey) {
+        for (uint64_t i = uy << 12; !(i >> 63); i <<= 1) ey--;
+        uy <<= -ey + 1;
+    } else {
+        uy = (uy & 0xfffffffffffffULL) | 0x10000000000000ULL;
+    }
+
+    // the remainder is exact, so reduce the 53 bit mantissa 11 bits at a time with integer remainders
+    while (ex > ey) {
+        int shift = ex - ey < 11 ? ex - ey : 11;
+        ux = (ux << shift) % uy;
+        ex -= shift;
+        if (ux == 0) return 0 * x;
+    }
+    ux %= uy;
+    if (ux == 0) return 0 * x;
+    while (!(ux >> 52)) {
+        ux <<= 1;
+        ex--;
+    }
+
+    if (ex > 0) {
+        ux = (ux - 0x10000000000000ULL) | (uint64_t) ex << 52;
+    } else {
+        ux >>= -ex + 1; // subnormal
+    }
+    return asdouble(ux | sx);
+}
+
+double frexp(double x, int *e) {
+    uint64_t u = asuint64(x);
+    int ee = (int) (u >> 52 & 0x7ff);
+
+    if (!ee) {
+        if (x != 0) {
+            x = frexp(x * 18446744073709551616.0, e); // 2^64
+            *e -= 64;
+        } else {
+            *e = 0;
+        }
+        return x;
+    }
+    if (ee == 0x7ff) return x;
+
+    *e = ee - 0x3fe;
+    return asdouble((u & 0x800fffffffffffffULL) | 0x3fe0000000000000ULL);
+}
+
+double scalbn(double x, int n) {
+    if (n > 1023) {
+        x *= asdouble(0x7fe0000000000000ULL); // 2^1023
+        n -= 1023;
+        if (n > 1023) {
+            x *= asdouble(0x7fe0000000000000ULL);
+            n -= 1023;
+            if (n > 1023) n = 1023;
+        }
+    } else if (n < -1022) {
+        // scale by 2^-969 rather than 2^-1022 to avoid double rounding in the subnormal range
+        x *= asdouble(0x0360000000000000ULL);
+        n += 969;
+        if (n < -1022) {
+            x *= asdouble(0x0360000000000000ULL);
+            n += 969;
+            if (n < -1022) n = -1022;
+        }
+    }
+    return x * asdouble((uint64_t) (0x3ff + n) << 52);
+}
+
+double ldexp(double x, int n) {
+    return scalbn(x, n);
+}
+
+/* float versions, exact in double precision */
+
+float fmodf(float x, float y) {
+    return (float) fmod(x, y);
+}
+
+float frexpf(float x, int *e) {
+    return (float) frexp(x, e);
+}
+
+float ldexpf(float x, int n) {
+    return (float) scalbn(x, n);
+}
+
+float scalbnf(float x, int n) {
+    return (float) scalbn(x, n);
+}
@@ -0,0 +1,91 @@
+#include <math.h>
+#include "libm.h"
+
+// hyperbolic functions from expm1 and exp, as in musl, with a Taylor series for sinh of small arguments
+
+static const double
+    ln2 = 0.6931471805599453,
+    ln2hi = 0.6931471805598903,
+    ln2lo = 5.497923018708371e-14;
+
+// exp(x)/2 without overflowing early, for large positive x
+static double exp_half(double x) {
+    double hi = x - ln2;
+    double lo = (x - hi) - ln2hi - ln2lo;
+    return __exp_tail(hi, lo);
+}
+
+double cosh(double x) {
+    uint32_t ix = abshigh(x);
+    x = f64_abs(x);
+
+    if (ix < 0x3fe62e42) {
+        // |x| < log(2)
+        if (ix < 0x3e500000) return 1.0;
+        double t = expm1(x);
+        return 1.0 + t * t / (2 * (1 + t));
+    }
+    if (ix < 0x40360000) {
+        // |x| < 22
+        double t = exp(x);
+        return 0.5 * t + 0.5 / t;
+    }
+    return exp_half(x);
+}
+
+double sinh(double x) {
+    uint32_t ix = abshigh(x);
+    double h = f64_copysign(0.5, x), absx = f64_abs(x);
+
+    if (ix < 0x40862e42) {
+        // |x| < log(DBL_MAX)
+        if (ix < 0x3ff00000) {
+            // |x| < 1, Taylor series to x^19
+            if (ix < 0x3e500000) return x; // |x| < 2^-26
+            double z = x * x;
+            return x + x * z * (0.16666666666666666 + z * (0.008333333333333333 + z * (0.0001984126984126984 +
+                z * (2.7557319223985893e-06 + z * (2.505210838544172e-08 + z * (1.6059043836821613e-10 +
+                z * (7.647163731819816e-13 + z * (2.8114572543455206e-15 + z * 8.22063524662433e-18))))))));
+        }
+        double t = expm1(absx);
+        return h * (t + t / (t + 1));
+    }
+    return f64_copysign(exp_half(absx), x);
+}
+
+double tanh(double x) {
+    uint32_t ix = abshigh(x);
+    double w = f64_abs(x), t;
+
+    if (ix > 0x3fe193ea) {
+        // |x| > log(3)/2
+        if (ix > 0x40340000) {
+            t = 1 - 0 / w; // |x| > 20, or nan
+        } else {
+            t = expm1(2 * w);
+            t = 1 - 2 / (t + 2);
+        }
+    } else if (ix > 0x3fd058ae) {
+        // |x| > log(5/3)/2
+        t = expm1(2 * w);
+        t = t / (t + 2);
+    } else if (ix >= 0x00100000) {
+        t = expm1(-2 * w);
+        t = -t / (t + 2);
+    } else {
+        t = w; // subnormal
+    }
+    return f64_copysign(t, x);
+}
+
+float coshf(float x) {
+    return (float) cosh(x);
+}
+
+float sinhf(float x) {
+    return (float) sinh(x);
+}
+
+float tanhf(float x) {
+    return (float) tanh(x);
+}
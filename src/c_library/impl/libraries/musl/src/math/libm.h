@@ -0,0 +1,42 @@
+#pragma once
+
+// internal helpers shared by the math.h implementations
+
+#include <stdint.h>
+#include <wasm/f32.h>
+#include <wasm/f64.h>
+
+#define asuint64(x)     ((uint64_t) i64_reinterpret_f64(x))
+#define asdouble(x)     (f64_reinterpret_i64(x))
+#define asuint(x)       ((uint32_t) i32_reinterpret_f32(x))
+#define asfloat(x)      (f32_reinterpret_i32(x))
+
+// high 32 bits of a double without the sign
+#define abshigh(x)      ((uint32_t) (asuint64(x) >> 32) & 0x7fffffff)
+
+// x with the low 32 bits of its mantissa cleared
+#define trunclow(x)     (asdouble(asuint64(x) & 0xffffffff00000000ULL))
+
+#define EXP_TABLE_BITS 7
+#define EXP_N (1 << EXP_TABLE_BITS)
+
+// exact product a * b = hi + lo using Veltkamp splitting, as there is no fma instruction
+static double two_product(double a, double b, double *lo) {
+    double ca = 134217729.0 * a, cb = 134217729.0 * b; // 2^27 + 1
+    double ahi = ca - (ca - a), alo = a - ahi;
+    double bhi = cb - (cb - b), blo = b - bhi;
+    double hi = a * b;
+    *lo = ((ahi * bhi - hi) + ahi * blo + alo * bhi) + alo * blo;
+    return hi;
+}
+
+// kernels for |x| <= pi/4 with x + y being the reduced argument
+double __sin(double x, double y, int iy);
+double __cos(double x, double y);
+double __tan(double x, double y, int odd);
+int __rem_pio2(double x, double *y);
+
+// log(x) as hi + *lo for a positive normal x given as bits, with about 2^-68 relative error
+double __log_dd(uint64_t ix, double *lo);
+// exp(x + xtail) for |xtail| much smaller than |x|, handling overflow and underflow
+double __exp_tail(double x, double xtail);
@@ -0,0 +1,434 @@
+#include <math.h>
+#include "libm.h"
+
+/*
+ * Trigonometric functions based on FreeBSD msun (fdlibm): the argument is reduced to [-pi/4, pi/4] and polynomial
+ * kernels approximate sin, cos and tan there. Arguments below 2^20 * pi/2 are reduced with pi/2 split into 33 bit
+ * parts; larger ones use 24 bit chunks of 2/pi and integer arithmetic (Payne-Hanek).
+ */
+
+// 2/pi in 24 bit chunks, enough for any finite double
+static const int32_t ipio2[] = {
+    0xA2F983, 0x6E4E44, 0x1529FC, 0x2757D1, 0xF534DD, 0xC0DB62, 0x95993C, 0x439041, 0xFE5163, 0xABDEBB,
+    0xC561B7, 0x246E3A, 0x424DD2, 0xE00649, 0x2EEA09, 0xD1921C, 0xFE1DEB, 0x1CB129, 0xA73EE8, 0x8235F5,
+    0x2EBB44, 0x84E99C, 0x7026B4, 0x5F7E41, 0x3991D6, 0x398353, 0x39F49C, 0x845F8B, 0xBDF928, 0x3B1FF8,
+    0x97FFDE, 0x05980F, 0xEF2F11, 0x8B5A0A, 0x6D1F6D, 0x367ECF, 0x27CB09, 0xB74F46, 0x3F669E, 0x5FEA2D,
+    0x7527BA, 0xC7EBE5, 0xF17B3D, 0x0739F7, 0x8A5292, 0xEA6BFB, 0x5FB11F, 0x8D5D08, 0x560330, 0x46FC7B,
+};
+
+static const double
+    invpio2 = 0.6366197723675814,           // 2/pi
+    pio2_1 = 1.5707963267341256,            // first 33 bits of pi/2
+    pio2_1t = 6.077100506506192e-11,        // pi/2 - pio2_1
+    pio2_2 = 6.077100506303966e-11,         // second 33 bits of pi/2
+    pio2_2t = 2.0222662487959506e-21,       // pi/2 - (pio2_1 + pio2_2)
+    pio2_3 = 2.0222662487111665e-21,        // third 33 bits of pi/2
+    pio2_3t = 8.4784276603689e-32,          // pi/2 - (pio2_1 + pio2_2 + pio2_3)
+    pio2_hi = 1.5707963267948966,
+    pio2_lo = 6.123233995736766e-17,
+    pio4 = 0.7853981633974483,
+    pio4lo = 3.061616997868383e-17,
+    pi = 3.141592653589793,
+    pi_lo = 1.2246467991473532e-16;
+
+/* argument reduction */
+
+// x reduced by the nearest multiple n of pi/2 for |x| >= 2^20 * pi/2, returning n mod 8
+static int rem_pio2_large(double x, double *y) {
+    uint64_t u = asuint64(x);
+    int e = (int) (u >> 52 & 0x7ff) - 1075; // x = m * 2^e
+    uint64_t m = (u & 0xfffffffffffffULL) | 0x10000000000000ULL;
+
+    // chunks before j0 only add multiples of 8 to x * 2/pi, so they are skipped
+    int j0 = (e - 3) / 24;
+    if (j0 < 0) j0 = 0;
+
+    // shift m so the binary point of the product is on a chunk boundary
+    int q = e - 24 * j0, s = q % 24;
+    if (s < 0) s += 24;
+    int fraction = 10 - (q - s) / 24; // number of chunks after the binary point
+
+    uint64_t mm[4];
+    mm[0] = (m << s) & 0xffffff;
+    mm[1] = (m << s >> 24) & 0xffffff;
+    mm[2] = (m >> (48 - s)) & 0xffffff;
+    mm[3] = s > 19 ? m >> (72 - s) : 0;
+
+    // product of m and 10 chunks of 2/pi, least significant first
+    uint64_t r[14];
+    uint64_t carry = 0;
+    for (int k = 0; k < 14; k++) {
+        uint64_t sum = carry;
+        for (int a = 0; a < 4; a++) {
+            int b = k - a;
+            if (b >= 0 && b < 10) sum += mm[a] * (uint64_t) ipio2[j0 + 9 - b];
+        }
+        r[k] = sum & 0xffffff;
+        carry = sum >> 24;
+    }
+
+    // round to the nearest quadrant, negating the fraction if it is over a half
+    int n = (int) (r[fraction] & 7);
+    int negative = r[fraction - 1] >> 23;
+    if (negative) {
+        n++;
+        uint64_t borrow = 0;
+        for (int k = 0; k < fraction; k++) {
+            uint64_t v = 0x1000000 - r[k] - borrow;
+            borrow = v <= 0xffffff ? 1 : 0;
+            r[k] = v & 0xffffff;
+        }
+    }
+
+    // the fraction as a double-double from its top 5 non-zero chunks
+    int top = fraction - 1;
+    while (top > 4 && r[top] == 0) top--;
+    double scale = asdouble((uint64_t) (1023 - 24 * (fraction - top + 1)) << 52);
+    double fhi = (double) (r[top] << 24 | r[top - 1]) * scale;
+    double fmid = (double) (r[top - 2] << 24 | r[top - 3]) * (scale * 3.552713678800501e-15); // 2^-48
+    double flo = (double) r[top - 4] * (scale * 2.117582368135751e-22); // 2^-72
+    double f = fhi + fmid;
+    double ftail = fhi - f + fmid + flo;
+
+    // times pi/2
+    double plo, p = two_product(f, pio2_hi, &plo);
+    plo += f * pio2_lo + ftail * pio2_hi;
+    double y0 = p + plo;
+    double y1 = p - y0 + plo;
+    if (negative ^ (int) (u >> 63)) {
+        y0 = -y0;
+        y1 = -y1;
+    }
+    y[0] = y0;
+    y[1] = y1;
+    return u >> 63 ? -n : n;
+}
+
+// x - n*pi/2 as y[0] + y[1] with |y[0]| <= pi/4, returning n (mod 8 for large x)
+int __rem_pio2(double x, double *y) {
+    uint32_t ix = abshigh(x);
+
+    if (ix < 0x413921fb) {
+        // |x| < 2^20 * pi/2, subtract n*pi/2 in up to three steps, depending on the cancellation
+        double fn = f64_nearest(x * invpio2);
+        int n = (int) fn;
+        double r = x - fn * pio2_1;
+        double w = fn * pio2_1t;
+        double y0 = r - w;
+        int ex = (int) (ix >> 20);
+        if (ex - (int) (asuint64(y0) >> 52 & 0x7ff) > 16) {
+            double t = r;
+            w = fn * pio2_2;
+            r = t - w;
+            w = fn * pio2_2t - ((t - r) - w);
+            y0 = r - w;
+            if (ex - (int) (asuint64(y0) >> 52 & 0x7ff) > 49) {
+                t = r;
+                w = fn * pio2_3;
+                r = t - w;
+                w = fn * pio2_3t - ((t - r) - w);
+                y0 = r - w;
+            }
+        }
+        y[0] = y0;
+        y[1] = (r - y0) - w;
+        return n;
+    }
+
+    if (ix >= 0x7ff00000) {
+        // inf or nan
+        y[0] = y[1] = x - x;
+        return 0;
+    }
+    return rem_pio2_large(x, y);
+}
+
+/* kernels */
+
+double __sin(double x, double y, int iy) {
+    double z = x * x, w = z * z;
+    double r = 8.33333333332248946124e-03 + z * (-1.98412698298579493134e-04 + z * 2.75573137070700676789e-06) +
+        z * w * (-2.50507602534068634195e-08 + z * 1.58969099521155010221e-10);
+    double v = z * x;
+    if (iy == 0) return x + v * (-1.66666666666666324348e-01 + z * r);
+    return x - ((z * (0.5 * y - v * r) - y) - v * -1.66666666666666324348e-01);
+}
+
+double __cos(double x, double y) {
+    double z = x * x, w = z * z;
+    double r = z * (4.16666666666666019037e-02 + z * (-1.38888888888741095749e-03 + z * 2.48015872894767294178e-05)) +
+        w * w * (-2.75573143513906633035e-07 + z * (2.08757232129817482790e-09 + z * -1.13596475577881948265e-11));
+    double hz = 0.5 * z;
+    w = 1.0 - hz;
+    return w + (((1.0 - w) - hz) + (z * r - x * y));
+}
+
+static const double T[] = {
+    3.33333333333334091986e-01, 1.33333333333201242699e-01, 5.39682539762260521377e-02, 2.18694882948595424599e-02,
+    8.86323982359930005737e-03, 3.59207910759131235356e-03, 1.45620945432529025516e-03, 5.88041240820264096874e-04,
+    2.46463134818469906812e-04, 7.81794442939557092300e-05, 7.14072491382608190305e-05, -1.85586374855275456654e-05,
+    2.59073051863633712884e-05,
+};
+
+// tan(x + y), or -1/tan(x + y) if odd
+double __tan(double x, double y, int odd) {
+    int big = f64_abs(x) >= 0.6744, sign = 0;
+    if (big) {
+        // tan(x) = tan(pi/4 - x') for x close to pi/4
+        if (x < 0) {
+            x = -x;
+            y = -y;
+            sign = 1;
+        }
+        x = (pio4 - x) + (pio4lo - y);
+        y = 0.0;
+    }
+
+    double z = x * x, w = z * z;
+    double r = T[1] + w * (T[3] + w * (T[5] + w * (T[7] + w * (T[9] + w * T[11]))));
+    double v = z * (T[2] + w * (T[4] + w * (T[6] + w * (T[8] + w * (T[10] + w * T[12])))));
+    double s = z * x;
+    r = y + z * (s * (r + v) + y) + s * T[0];
+    w = x + r;
+    if (big) {
+        s = 1 - 2 * odd;
+        v = s - 2.0 * (x + (r - w * w / (w + s)));
+        return sign ? -v : v;
+    }
+    if (!odd) return w;
+
+    // -1/(x + r) accurately
+    double w0 = trunclow(w);
+    v = r - (w0 - x);
+    double a = -1.0 / w, a0 = trunclow(a);
+    return a0 + a * (1.0 + a0 * w0 + a0 * v);
+}
+
+/* sin, cos and tan */
+
+double sin(double x) {
+    uint32_t ix = abshigh(x);
+    if (ix <= 0x3fe921fb) {
+        // |x| ~<= pi/4
+        if (ix < 0x3e500000) return x; // |x| < 2^-26
+        return __sin(x, 0.0, 0);
+    }
+    if (ix >= 0x7ff00000) return x - x;
+
+    double y[2];
+    switch (__rem_pio2(x, y) & 3) {
+        case 0: return __sin(y[0], y[1], 1);
+        case 1: return __cos(y[0], y[1]);
+        case 2: return -__sin(y[0], y[1], 1);
+        default: return -__cos(y[0], y[1]);
+    }
+}
+
+double cos(double x) {
+    uint32_t ix = abshigh(x);
+    if (ix <= 0x3fe921fb) {
+        if (ix < 0x3e46a09e) return 1.0; // |x| < 2^-27 * sqrt(2)
+        return __cos(x, 0.0);
+    }
+    if (ix >= 0x7ff00000) return x - x;
+
+    double y[2];
+    switch (__rem_pio2(x, y) & 3) {
+        case 0: return __cos(y[0], y[1]);
+        case 1: return -__sin(y[0], y[1], 1);
+        case 2: return -__cos(y[0], y[1]);
+        default: return __sin(y[0], y[1], 1);
+    }
+}
+
+double tan(double x) {
+    uint32_t ix = abshigh(x);
+    if (ix <= 0x3fe921fb) {
+        if (ix < 0x3e400000) return x; // |x| < 2^-27
+        return __tan(x, 0.0, 0);
+    }
+    if (ix >= 0x7ff00000) return x - x;
+
+    double y[2];
+    int n = __rem_pio2(x, y);
+    return __tan(y[0], y[1], n & 1);
+}
+
+/* inverse functions */
+
+static const double atanhi[] = {4.636476090008061e-01, 7.853981633974483e-01, 9.82793723247329e-01, 1.5707963267948966};
+static const double atanlo[] = {2.2698777452961687e-17, 3.061616997868383e-17, 1.3903311031230998e-17, 6.123233995736766e-17};
+
+static const double aT[] = {
+    3.33333333333329318027e-01, -1.99999999998764832476e-01, 1.42857142725034663711e-01, -1.11111104054623557880e-01,
+    9.09088713343650656196e-02, -7.69187620504482999495e-02, 6.66107313738753120669e-02, -5.83357013379057348645e-02,
+    4.97687799461593236017e-02, -3.65315727442169155270e-02, 1.62858201153657823623e-02,
+};
+
+double atan(double x) {
+    uint32_t ix = abshigh(x);
+    int sign = (int) (asuint64(x) >> 63), id;
+
+    if (ix >= 0x44100000) {
+        // |x| >= 2^66
+        if (x != x) return x;
+        return sign ? -atanhi[3] - atanlo[3] : atanhi[3] + atanlo[3];
+    }
+    if (ix < 0x3fdc0000) {
+        // |x| < 0.4375
+        if (ix < 0x3e400000) return x; // |x| < 2^-27
+        id = -1;
+    } else {
+        // reduce with atan(x) = atan(c) + atan((x - c)/(1 + xc)) for c = 0.5, 1, 1.5 or inf
+        x = f64_abs(x);
+        if (ix < 0x3ff30000) {
+            if (ix < 0x3fe60000) {
+                id = 0;
+                x = (2.0 * x - 1.0) / (2.0 + x);
+            } else {
+                id = 1;
+                x = (x - 1.0) / (x + 1.0);
+            }
+        } else if (ix < 0x40038000) {
+            id = 2;
+            x = (x - 1.5) / (1.0 + 1.5 * x);
+        } else {
+            id = 3;
+            x = -1.0 / x;
+        }
+    }
+
+    double z = x * x, w = z * z;
+    double s1 = z * (aT[0] + w * (aT[2] + w * (aT[4] + w * (aT[6] + w * (aT[8] + w * aT[10])))));
+    double s2 = w * (aT[1] + w * (aT[3] + w * (aT[5] + w * (aT[7] + w * aT[9]))));
+    if (id < 0) return x - x * (s1 + s2);
+    z = atanhi[id] - ((x * (s1 + s2) - atanlo[id]) - x);
+    return sign ? -z : z;
+}
+
+double atan2(double y, double x) {
+    if (x != x || y != y) return x + y;
+    uint64_t ux = asuint64(x), uy = asuint64(y);
+    if (ux == 0x3ff0000000000000ULL) return atan(y);
+
+    int m = (int) (uy >> 63) | (int) (ux >> 62 & 2); // 2 * sign(x) + sign(y)
+    uint32_t ix = abshigh(x), iy = abshigh(y);
+
+    if (uy << 1 == 0) {
+        // y = +-0
+        return m < 2 ? y : m == 2 ? pi : -pi;
+    }
+    if (ux << 1 == 0) return m & 1 ? -pio2_hi : pio2_hi;
+    if (ix == 0x7ff00000) {
+        if (iy == 0x7ff00000) {
+            double r = m < 2 ? pio4 : 3 * pio4;
+            return m & 1 ? -r : r;
+        }
+        double r = m < 2 ? 0.0 : pi;
+        return m & 1 ? -r : r;
+    }
+    // |y/x| > 2^64 or y = +-inf
+    if (ix + (64 << 20) < iy || iy == 0x7ff00000) return m & 1 ? -pio2_hi : pio2_hi;
+
+    // |y/x| < 2^-64 with x < 0 gives +-pi
+    double z = (m & 2) && iy + (64 << 20) < ix ? 0.0 : atan(f64_abs(y / x));
+    switch (m) {
+        case 0: return z;
+        case 1: return -z;
+        case 2: return pi - (z - pi_lo);
+        default: return (z - pi_lo) - pi;
+    }
+}
+
+// rational approximation of (asin(x) - x)/x^3 in x^2 for |x| <= 0.5
+static double asin_r(double z) {
+    double p = z * (1.66666666666666657415e-01 + z * (-3.25565818622400915405e-01 + z * (2.01212532134862925881e-01 +
+        z * (-4.00555345006794114027e-02 + z * (7.91534994289814532176e-04 + z * 3.47933107596021167570e-05)))));
+    double q = 1.0 + z * (-2.40339491173441421878e+00 + z * (2.02094576023350569471e+00 +
+        z * (-6.88283971605453293030e-01 + z * 7.70381505559019352791e-02)));
+    return p / q;
+}
+
+double asin(double x) {
+    uint32_t ix = abshigh(x);
+    if (ix >= 0x3ff00000) {
+        // |x| >= 1
+        if (f64_abs(x) == 1.0) return x * pio2_hi;
+        return (x - x) / (x - x);
+    }
+    if (ix < 0x3fe00000) {
+        // |x| < 0.5
+        if (ix < 0x3e500000) return x;
+        return x + x * asin_r(x * x);
+    }
+
+    // asin(x) = pi/2 - 2 asin(sqrt((1 - x)/2))
+    double sign = x;
+    double z = (1 - f64_abs(x)) * 0.5;
+    double s = f64_sqrt(z), r = asin_r(z);
+    if (ix >= 0x3fef3333) {
+        // |x| > 0.975
+        x = pio2_hi - (2 * (s + s * r) - pio2_lo);
+    } else {
+        double f = trunclow(s);
+        double c = (z - f * f) / (s + f);
+        x = 0.5 * pio2_hi - (2 * s * r - (pio2_lo - 2 * c) - (0.5 * pio2_hi - 2 * f));
+    }
+    return f64_copysign(x, sign);
+}
+
+double acos(double x) {
+    uint32_t ix = abshigh(x);
+    if (ix >= 0x3ff00000) {
+        if (x == 1.0) return 0.0;
+        if (x == -1.0) return 2 * pio2_hi;
+        return (x - x) / (x - x);
+    }
+    if (ix < 0x3fe00000) {
+        // |x| < 0.5
+        if (ix <= 0x3c600000) return pio2_hi; // |x| < 2^-57
+        return pio2_hi - (x - (pio2_lo - x * asin_r(x * x)));
+    }
+
+    // acos(x) = 2 asin(sqrt((1 - x)/2)) = pi - 2 asin(sqrt((1 + x)/2))
+    if (x < 0) {
+        double z = (1.0 + x) * 0.5;
+        double s = f64_sqrt(z);
+        double w = asin_r(z) * s - pio2_lo;
+        return 2 * (pio2_hi - (s + w));
+    }
+    double z = (1.0 - x) * 0.5;
+    double s = f64_sqrt(z), f = trunclow(s);
+    double c = (z - f * f) / (s + f);
+    return 2 * (f + (asin_r(z) * s + c));
+}
+
+/* float versions, computed in double precision */
+
+float sinf(float x) {
+    return (float) sin(x);
+}
+
+float cosf(float x) {
+    return (float) cos(x);
+}
+
+float tanf(float x) {
+    return (float) tan(x);
+}
+
+float asinf(float x) {
+    return (float) asin(x);
+}
+
+float acosf(float x) {
+    return (float) acos(x);
+}
+
+float atanf(float x) {
+    return (float) atan(x);
+}
+
+float atan2f(float y, float x) {
+    return (float) atan2(y, x);
+}
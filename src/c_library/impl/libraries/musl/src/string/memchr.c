@@ -1,17 +1,25 @@
 #include <string.h>
-#include <stdint.h>
-#include <limits.h>
-
-#define SS (sizeof(size_t))
-#define ALIGN (sizeof(size_t)-1)
-#define ONES ((size_t)-1/UCHAR_MAX)
-#define HIGHS (ONES * (UCHAR_MAX/2+1))
-#define HASZERO(x) ((x)-ONES & ~(x) & HIGHS)
+#include "words.h"
 
 void *memchr(const void *src, int c, size_t n)
 {
 	const unsigned char *s = src;
 	c = (unsigned char)c;
+#if defined(STRING_SIMD)
+	for (; ((uintptr_t)s % VS) && n && *s != c; s++, n--);
+	if (n && *s != c) {
+		const v128_t k = i8x16_splat(c);
+		for (; n>=VS && !v128_any_true(i8x16_eq(v128_load(s), k)); s+=VS, n-=VS);
+	}
+#elif defined(STRING_WORDS)
+	for (; ((uintptr_t)s & ALIGN) && n && *s != c; s++, n--);
+	if (n && *s != c) {
+		const word *w;
+		word k = ONES * c;
+		for (w = (const void *)s; n>=SS && !HASZERO(*w^k); w++, n-=SS);
+		s = (const void *)w;
+	}
+#endif
 	for (; n && *s != c; s++, n--);
 	return n ? (void *)s : (void *)0;
 }
@@ -1,8 +1,15 @@
 #include <string.h>
+#include "words.h"
 
 int memcmp(const void *vl, const void *vr, size_t n)
 {
 	const unsigned char *l=vl, *r=vr;
+	// c2wasm: unaligned loads are fine as they stay within the n bytes
+#if defined(STRING_SIMD)
+	for (; n>=VS && i8x16_all_true(i8x16_eq(v128_load(l), v128_load(r))); n-=VS, l+=VS, r+=VS);
+#elif defined(STRING_WORDS)
+	for (; n>=SS && *(const word *)l == *(const word *)r; n-=SS, l+=SS, r+=SS);
+#endif
 	for (; n && *l == *r; n--, l++, r++);
 	return n ? *l-*r : 0;
 }
@@ -1,17 +1,27 @@
 #include <string.h>
-#include <stdint.h>
-#include <limits.h>
-
-#define ALIGN (sizeof(size_t))
-#define ONES ((size_t)-1/UCHAR_MAX)
-#define HIGHS (ONES * (UCHAR_MAX/2+1))
-#define HASZERO(x) ((x)-ONES & ~(x) & HIGHS)
+#include "words.h"
 
 char *__strchrnul(const char *s, int c)
 {
 	c = (unsigned char)c;
 	if (!c) return (char *)s + strlen(s);
 
+#if defined(STRING_SIMD)
+	for (; (uintptr_t)s % VS; s++)
+		if (!*s || *(unsigned char *)s == c) return (char *)s;
+	const v128_t k = i8x16_splat(c);
+	for (;; s += VS) {
+		v128_t v = v128_load(s);
+		if (v128_any_true(v128_or(i8x16_eq(v, v128_zero()), i8x16_eq(v, k)))) break;
+	}
+#elif defined(STRING_WORDS)
+	const word *w;
+	for (; (uintptr_t)s & ALIGN; s++)
+		if (!*s || *(unsigned char *)s == c) return (char *)s;
+	word k = ONES * c;
+	for (w = (const void *)s; !HASZERO(*w) && !HASZERO(*w^k); w++);
+	s = (const void *)w;
+#endif
 	for (; *s && *(unsigned char *)s != c; s++);
 	return (char *)s;
 }
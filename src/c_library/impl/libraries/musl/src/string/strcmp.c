@@ -1,7 +1,27 @@
 #include <string.h>
+#include "words.h"
 
 int strcmp(const char *l, const char *r)
 {
+#if defined(STRING_SIMD)
+	// c2wasm: only when both strings can be read with aligned loads
+	if ((uintptr_t)l % VS == (uintptr_t)r % VS) {
+		for (; ((uintptr_t)l % VS) && *l==*r && *l; l++, r++);
+		// continue while all lanes of l are non-zero and equal to r
+		if (!((uintptr_t)l % VS))
+			for (; i8x16_all_true(v128_and(v128_load(l), i8x16_eq(v128_load(l), v128_load(r)))); l+=VS, r+=VS);
+	}
+#elif defined(STRING_WORDS)
+	if (((uintptr_t)l & ALIGN) == ((uintptr_t)r & ALIGN)) {
+		for (; ((uintptr_t)l & ALIGN) && *l==*r && *l; l++, r++);
+		if (!((uintptr_t)l & ALIGN)) {
+			const word *wl = (const void *)l, *wr = (const void *)r;
+			for (; *wl==*wr && !HASZERO(*wl); wl++, wr++);
+			l = (const void *)wl;
+			r = (const void *)wr;
+		}
+	}
+#endif
 	for (; *l==*r && *l; l++, r++);
 	return *(unsigned char *)l - *(unsigned char *)r;
 }
@@ -1,15 +1,18 @@
 #include <string.h>
-#include <stdint.h>
-#include <limits.h>
-
-#define ALIGN (sizeof(size_t))
-#define ONES ((size_t)-1/UCHAR_MAX)
-#define HIGHS (ONES * (UCHAR_MAX/2+1))
-#define HASZERO(x) ((x)-ONES & ~(x) & HIGHS)
+#include "words.h"
 
 size_t strlen(const char *s)
 {
 	const char *a = s;
+#if defined(STRING_SIMD)
+	for (; (uintptr_t)s % VS; s++) if (!*s) return s-a;
+	for (; !v128_any_true(i8x16_eq(v128_load(s), v128_zero())); s += VS);
+#elif defined(STRING_WORDS)
+	const word *w;
+	for (; (uintptr_t)s & ALIGN; s++) if (!*s) return s-a;
+	for (w = (const void *)s; !HASZERO(*w); w++);
+	s = (const void *)w;
+#endif
 	for (; *s; s++);
 	return (size_t) (s-a);
 }
@@ -0,0 +1,22 @@
+#pragma once
+// c2wasm: shared by the word-at-a-time and v128 versions of the string functions. size_t is only 32 bits, so words are
+// uint64_t. loads are either aligned or within the given length, so reading past the end of a string never reads past
+// the end of memory.
+#include <stdint.h>
+#include <limits.h>
+
+#if !defined(STRING_BYTEWISE) && !defined(STRING_SIMD)
+#define STRING_WORDS
+#endif
+
+#ifdef STRING_SIMD
+#include <wasm/simd128.h>
+#define VS 16
+#endif
+
+typedef uint64_t word;
+#define SS (sizeof(word))
+#define ALIGN (sizeof(word)-1)
+#define ONES ((word)-1/UCHAR_MAX)
+#define HIGHS (ONES * (UCHAR_MAX/2+1))
+#define HASZERO(x) ((x)-ONES & ~(x) & HIGHS)
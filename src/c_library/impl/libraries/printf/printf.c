@@ -51,13 +51,6 @@
 #define PRINTF_NTOA_BUFFER_SIZE    32U
 #endif
 
-// 'ftoa' conversion buffer size, this must be big enough to hold one converted
-// float number including padded zeros (dynamically created on stack)
-// default: 32 byte
-#ifndef PRINTF_FTOA_BUFFER_SIZE
-#define PRINTF_FTOA_BUFFER_SIZE    32U
-#endif
-
 // support for the floating point type (%f)
 // default: activated
 #ifndef PRINTF_DISABLE_SUPPORT_FLOAT
@@ -76,12 +69,6 @@
 #define PRINTF_DEFAULT_FLOAT_PRECISION  6U
 #endif
 
-// define the largest float suitable to print with %f
-// default: 1e9
-#ifndef PRINTF_MAX_FLOAT
-#define PRINTF_MAX_FLOAT  1e9
-#endif
-
 // support for the long long types (%llu or %p)
 // default: activated
 #ifndef PRINTF_DISABLE_SUPPORT_LONG_LONG
@@ -112,9 +99,10 @@
 #define FLAGS_ADAPT_EXP (1U << 11U)
 
 
-// import float.h for DBL_MAX
+// import float.h for DBL_MAX, and the correctly rounded digits of doubles
 #if defined(PRINTF_SUPPORT_FLOAT)
 #include <float.h>
+#include "custom/decimal.h"
 #endif
 
 
@@ -329,245 +317,131 @@ static size_t _ntoa_long_long(out_fct_type out, char* buffer, size_t idx, size_t
 
 #if defined(PRINTF_SUPPORT_FLOAT)
 
-#if defined(PRINTF_SUPPORT_EXPONENTIAL)
-// forward declaration so that _ftoa can switch to exp notation for values > PRINTF_MAX_FLOAT
-static size_t _etoa(out_fct_type out, char* buffer, size_t idx, size_t maxlen, double value, unsigned int prec, unsigned int width, unsigned int flags);
-#endif
+// output the digits at 10^from down to 10^to of a conversion by __dtoa, which are zero outside of the n digits
+static size_t _out_digits(out_fct_type out, char* buffer, size_t idx, size_t maxlen, const char* digits, int n, int exp10, int from, int to)
+{
+  for (int pos = from; pos >= to; pos--) {
+    const int i = exp10 - pos;
+    out(((i >= 0) && (i < n)) ? digits[i] : '0', buffer, idx++, maxlen);
+  }
+  return idx;
+}
 
 
-// internal ftoa for fixed decimal floating point
-static size_t _ftoa(out_fct_type out, char* buffer, size_t idx, size_t maxlen, double value, unsigned int prec, unsigned int width, unsigned int flags)
+// internal dtoa for %f, %e and %g, printing every digit of the correctly rounded value like glibc
+static size_t _dtoa(out_fct_type out, char* buffer, size_t idx, size_t maxlen, double value, unsigned int prec, unsigned int width, unsigned int flags, bool exponential)
 {
-  char buf[PRINTF_FTOA_BUFFER_SIZE];
-  size_t len  = 0U;
-  double diff = 0.0;
-
-  // powers of 10
-  static const double pow10[] = { 1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000 };
-
-  // test for special values
-  if (value != value)
-    return _out_rev(out, buffer, idx, maxlen, "nan", 3, width, flags);
-  if (value < -DBL_MAX)
-    return _out_rev(out, buffer, idx, maxlen, "fni-", 4, width, flags);
-  if (value > DBL_MAX)
-    return _out_rev(out, buffer, idx, maxlen, (flags & FLAGS_PLUS) ? "fni+" : "fni", (flags & FLAGS_PLUS) ? 4U : 3U, width, flags);
-
-  // test for very large values
-  // standard printf behavior is to print EVERY whole number digit -- which could be 100s of characters overflowing your buffers == bad
-  if ((value > PRINTF_MAX_FLOAT) || (value < -PRINTF_MAX_FLOAT)) {
-#if defined(PRINTF_SUPPORT_EXPONENTIAL)
-    return _etoa(out, buffer, idx, maxlen, value, prec, width, flags);
-#else
-    return 0U;
-#endif
-  }
+  char digits[DTOA_BUFFER_SIZE];
+  const size_t start_idx = idx;
 
-  // test for negative
-  bool negative = false;
-  if (value < 0) {
-    negative = true;
-    value = 0 - value;
+  // the sign bit, so -0.0 is printed with a sign
+  union {
+    uint64_t U;
+    double   F;
+  } conv;
+  conv.F = value;
+  const char sign = (conv.U >> 63U) ? '-' : (flags & FLAGS_PLUS) ? '+' : (flags & FLAGS_SPACE) ? ' ' : 0;
+
+  // special values are padded with spaces
+  if ((value != value) || (value > DBL_MAX) || (value < -DBL_MAX)) {
+    const bool upper = flags & FLAGS_UPPERCASE;
+    const char* str = (value != value) ? (upper ? "NAN" : "nan") : (upper ? "INF" : "inf");
+    const unsigned int len = sign ? 4U : 3U;
+    if (!(flags & FLAGS_LEFT)) {
+      for (unsigned int i = len; i < width; i++) out(' ', buffer, idx++, maxlen);
+    }
+    if (sign) out(sign, buffer, idx++, maxlen);
+    while (*str) out(*(str++), buffer, idx++, maxlen);
+    if (flags & FLAGS_LEFT) {
+      while (idx - start_idx < width) out(' ', buffer, idx++, maxlen);
+    }
+    return idx;
   }
 
   // set default precision, if not set explicitly
   if (!(flags & FLAGS_PRECISION)) {
     prec = PRINTF_DEFAULT_FLOAT_PRECISION;
   }
-  // limit precision to 9, cause a prec >= 10 can lead to overflow errors
-  while ((len < PRINTF_FTOA_BUFFER_SIZE) && (prec > 9U)) {
-    buf[len++] = '0';
-    prec--;
-  }
-
-  int whole = (int)value;
-  double tmp = (value - whole) * pow10[prec];
-  unsigned long frac = (unsigned long)tmp;
-  diff = tmp - frac;
-
-  if (diff > 0.5) {
-    ++frac;
-    // handle rollover, e.g. case 0.99 with prec 1 is 1.0
-    if (frac >= pow10[prec]) {
-      frac = 0;
-      ++whole;
-    }
-  }
-  else if (diff < 0.5) {
-  }
-  else if ((frac == 0U) || (frac & 1U)) {
-    // if halfway, round up if odd OR if last digit is 0
-    ++frac;
-  }
 
-  if (prec == 0U) {
-    diff = value - (double)whole;
-    if ((!(diff < 0.5) || (diff > 0.5)) && (whole & 1)) {
-      // exactly 0.5 and ODD, then round up
-      // 1.5 -> 2, but 2.5 -> 2
-      ++whole;
-    }
-  }
-  else {
-    unsigned int count = prec;
-    // now do fractional part, as an unsigned number
-    while (len < PRINTF_FTOA_BUFFER_SIZE) {
-      --count;
-      buf[len++] = (char)(48U + (frac % 10U));
-      if (!(frac /= 10U)) {
-        break;
-      }
+  int exp10, n;
+  unsigned int frac;  // digits after the decimal point
+  if (flags & FLAGS_ADAPT_EXP) {
+    // in "%g" mode, "prec" is the number of significant figures, and the exponent after rounding decides the style
+    if (prec == 0U) {
+      prec = 1U;
     }
-    // add extra 0s
-    while ((len < PRINTF_FTOA_BUFFER_SIZE) && (count-- > 0U)) {
-      buf[len++] = '0';
+    n = __dtoa(value, (int)prec, false, digits, &exp10);
+    if (!n) {
+      exp10 = 0;
     }
-    if (len < PRINTF_FTOA_BUFFER_SIZE) {
-      // add decimal
-      buf[len++] = '.';
+    exponential = (exp10 < -4) || (exp10 >= (int)prec);
+    frac = exponential ? prec - 1U : (unsigned int)((int)prec - 1 - exp10);
+    if (!(flags & FLAGS_HASH)) {
+      // remove trailing zeros, which the digits don't have
+      const int significant = exponential ? n - 1 : n - 1 - exp10;
+      frac = (significant > 0) ? (unsigned int)significant : 0U;
     }
   }
-
-  // do whole part, number is reversed
-  while (len < PRINTF_FTOA_BUFFER_SIZE) {
-    buf[len++] = (char)(48 + (whole % 10));
-    if (!(whole /= 10)) {
-      break;
+  else {
+    n = __dtoa(value, exponential ? (int)prec + 1 : (int)prec, !exponential, digits, &exp10);
+    if (!n) {
+      exp10 = 0;
     }
+    frac = prec;
   }
 
-  // pad leading zeros
-  if (!(flags & FLAGS_LEFT) && (flags & FLAGS_ZEROPAD)) {
-    if (width && (negative || (flags & (FLAGS_PLUS | FLAGS_SPACE)))) {
-      width--;
-    }
-    while ((len < width) && (len < PRINTF_FTOA_BUFFER_SIZE)) {
-      buf[len++] = '0';
-    }
-  }
+  // the exponent format is "%+03d"
+  const int expval = (exp10 < 0) ? -exp10 : exp10;
+  const int int_digits = (exponential || (exp10 < 0)) ? 1 : exp10 + 1;
+  const bool point = frac || (flags & FLAGS_HASH);
+  const size_t len = (sign ? 1U : 0U) + (size_t)int_digits + (point ? 1U : 0U) + frac + (exponential ? ((expval < 100) ? 4U : 5U) : 0U);
 
-  if (len < PRINTF_FTOA_BUFFER_SIZE) {
-    if (negative) {
-      buf[len++] = '-';
-    }
-    else if (flags & FLAGS_PLUS) {
-      buf[len++] = '+';  // ignore the space if the '+' exists
-    }
-    else if (flags & FLAGS_SPACE) {
-      buf[len++] = ' ';
-    }
+  if (!(flags & FLAGS_LEFT) && !(flags & FLAGS_ZEROPAD)) {
+    for (size_t i = len; i < width; i++) out(' ', buffer, idx++, maxlen);
   }
-
-  return _out_rev(out, buffer, idx, maxlen, buf, len, width, flags);
-}
-
-
-#if defined(PRINTF_SUPPORT_EXPONENTIAL)
-// internal ftoa variant for exponential floating-point type, contributed by Martijn Jasperse <m.jasperse@gmail.com>
-static size_t _etoa(out_fct_type out, char* buffer, size_t idx, size_t maxlen, double value, unsigned int prec, unsigned int width, unsigned int flags)
-{
-  // check for NaN and special values
-  if ((value != value) || (value > DBL_MAX) || (value < -DBL_MAX)) {
-    return _ftoa(out, buffer, idx, maxlen, value, prec, width, flags);
+  if (sign) {
+    out(sign, buffer, idx++, maxlen);
   }
-
-  // determine the sign
-  const bool negative = value < 0;
-  if (negative) {
-    value = -value;
+  if (!(flags & FLAGS_LEFT) && (flags & FLAGS_ZEROPAD)) {
+    for (size_t i = len; i < width; i++) out('0', buffer, idx++, maxlen);
   }
 
-  // default precision
-  if (!(flags & FLAGS_PRECISION)) {
-    prec = PRINTF_DEFAULT_FLOAT_PRECISION;
+  const int first = exponential ? exp10 : int_digits - 1;
+  idx = _out_digits(out, buffer, idx, maxlen, digits, n, exp10, first, first - int_digits + 1);
+  if (point) {
+    out('.', buffer, idx++, maxlen);
   }
+  idx = _out_digits(out, buffer, idx, maxlen, digits, n, exp10, first - int_digits, first - int_digits - (int)frac + 1);
 
-  // determine the decimal exponent
-  // based on the algorithm by David Gay (https://www.ampl.com/netlib/fp/dtoa.c)
-  union {
-    uint64_t U;
-    double   F;
-  } conv;
-
-  conv.F = value;
-  int exp2 = (int)((conv.U >> 52U) & 0x07FFU) - 1023;           // effectively log2
-  conv.U = (conv.U & ((1ULL << 52U) - 1U)) | (1023ULL << 52U);  // drop the exponent so conv.F is now in [1,2)
-  // now approximate log10 from the log2 integer part and an expansion of ln around 1.5
-  int expval = (int)(0.1760912590558 + exp2 * 0.301029995663981 + (conv.F - 1.5) * 0.289529654602168);
-  // now we want to compute 10^expval but we want to be sure it won't overflow
-  exp2 = (int)(expval * 3.321928094887362 + 0.5);
-  const double z  = expval * 2.302585092994046 - exp2 * 0.6931471805599453;
-  const double z2 = z * z;
-  conv.U = (uint64_t)(exp2 + 1023) << 52U;
-  // compute exp(z) using continued fractions, see https://en.wikipedia.org/wiki/Exponential_function#Continued_fractions_for_ex
-  conv.F *= 1 + 2 * z / (2 - z + (z2 / (6 + (z2 / (10 + z2 / 14)))));
-  // correct for rounding errors
-  if (value < conv.F) {
-    expval--;
-    conv.F /= 10;
-  }
-
-  // the exponent format is "%+03d" and largest value is "307", so set aside 4-5 characters
-  unsigned int minwidth = ((expval < 100) && (expval > -100)) ? 4U : 5U;
-
-  // in "%g" mode, "prec" is the number of *significant figures* not decimals
-  if (flags & FLAGS_ADAPT_EXP) {
-    // do we want to fall-back to "%f" mode?
-    if ((value >= 1e-4) && (value < 1e6)) {
-      if ((int)prec > expval) {
-        prec = (unsigned)((int)prec - expval - 1);
-      }
-      else {
-        prec = 0;
-      }
-      flags |= FLAGS_PRECISION;   // make sure _ftoa respects precision
-      // no characters in exponent
-      minwidth = 0U;
-      expval   = 0;
-    }
-    else {
-      // we use one sigfig for the whole part
-      if ((prec > 0) && (flags & FLAGS_PRECISION)) {
-        --prec;
-      }
+  if (exponential) {
+    out((flags & FLAGS_UPPERCASE) ? 'E' : 'e', buffer, idx++, maxlen);
+    out((exp10 < 0) ? '-' : '+', buffer, idx++, maxlen);
+    if (expval >= 100) {
+      out((char)('0' + expval / 100), buffer, idx++, maxlen);
     }
+    out((char)('0' + expval / 10 % 10), buffer, idx++, maxlen);
+    out((char)('0' + expval % 10), buffer, idx++, maxlen);
   }
 
-  // will everything fit?
-  unsigned int fwidth = width;
-  if (width > minwidth) {
-    // we didn't fall-back so subtract the characters required for the exponent
-    fwidth -= minwidth;
-  } else {
-    // not enough characters, so go back to default sizing
-    fwidth = 0U;
-  }
-  if ((flags & FLAGS_LEFT) && minwidth) {
-    // if we're padding on the right, DON'T pad the floating part
-    fwidth = 0U;
+  if (flags & FLAGS_LEFT) {
+    while (idx - start_idx < width) out(' ', buffer, idx++, maxlen);
   }
+  return idx;
+}
 
-  // rescale the float value
-  if (expval) {
-    value /= conv.F;
-  }
 
-  // output the floating part
-  const size_t start_idx = idx;
-  idx = _ftoa(out, buffer, idx, maxlen, negative ? -value : value, prec, fwidth, flags & ~FLAGS_ADAPT_EXP);
+// internal ftoa for fixed decimal floating point
+static size_t _ftoa(out_fct_type out, char* buffer, size_t idx, size_t maxlen, double value, unsigned int prec, unsigned int width, unsigned int flags)
+{
+  return _dtoa(out, buffer, idx, maxlen, value, prec, width, flags, false);
+}
 
-  // output the exponent part
-  if (minwidth) {
-    // output the exponential symbol
-    out((flags & FLAGS_UPPERCASE) ? 'E' : 'e', buffer, idx++, maxlen);
-    // output the exponent value
-    idx = _ntoa_long(out, buffer, idx, maxlen, (expval < 0) ? -expval : expval, expval < 0, 10, 0, minwidth-1, FLAGS_ZEROPAD | FLAGS_PLUS);
-    // might need to right-pad spaces
-    if (flags & FLAGS_LEFT) {
-      while (idx - start_idx < width) out(' ', buffer, idx++, maxlen);
-    }
-  }
-  return idx;
+
+#if defined(PRINTF_SUPPORT_EXPONENTIAL)
+// internal ftoa variant for exponential floating-point type, and %g with FLAGS_ADAPT_EXP
+static size_t _etoa(out_fct_type out, char* buffer, size_t idx, size_t maxlen, double value, unsigned int prec, unsigned int width, unsigned int flags)
+{
+  return _dtoa(out, buffer, idx, maxlen, value, prec, width, flags, true);
 }
 #endif  // PRINTF_SUPPORT_EXPONENTIAL
 #endif  // PRINTF_SUPPORT_FLOAT
@@ -918,16 +792,185 @@ int fctprintf(void (*out)(char character, void* arg), void* arg, const char* for
 #include <stdio.h>
 #ifdef FILES
 
+// output is collected in chunks, so unbuffered streams get one write per chunk instead of one per character
+typedef struct {
+  FILE* stream;
+  size_t len;
+  char buffer[128];
+} file_out_type;
+
 static void _fprintf_out(char character, void* arg) {
-    fputc(character, (FILE*) arg);
+  file_out_type* out = (file_out_type*) arg;
+  out->buffer[out->len++] = character;
+  if (out->len == sizeof(out->buffer)) {
+    fwrite(out->buffer, 1, out->len, out->stream);
+    out->len = 0;
+  }
+}
+
+int vfprintf(FILE *stream, const char *format, va_list va) {
+  file_out_type out;
+  out.stream = stream;
+  out.len = 0;
+  const out_fct_wrap_type out_fct_wrap = { _fprintf_out, &out };
+  const int ret = _vsnprintf(_out_fct, (char*)(uintptr_t)&out_fct_wrap, (size_t)-1, format, va);
+  if (out.len) fwrite(out.buffer, 1, out.len, stream);
+  return ret;
 }
 
 int fprintf(FILE *stream, const char *format, ...) {
   va_list va;
   va_start(va, format);
-  const out_fct_wrap_type out_fct_wrap = { _fprintf_out, stream};
-  const int ret = _vsnprintf(_out_fct, (char*)(uintptr_t)&out_fct_wrap, (size_t)-1, format, va);
+  const int ret = vfprintf(stream, format, va);
   va_end(va);
   return ret;
 }
+
+int printf(const char* format, ...) {
+  va_list va;
+  va_start(va, format);
+  const int ret = vfprintf(stdout, format, va);
+  va_end(va);
+  return ret;
+}
+
+int vprintf(const char* format, va_list va) {
+  return vfprintf(stdout, format, va);
+}
+#endif
+
+// helpers for calls with constant formats, which are parsed at compile time by src/ir/transform/printf.ts. the output
+// is selected by __printf_begin_*, then written by one helper call per literal chunk or conversion until __printf_end
+#include <string.h>
+#define SPEC_BUFFER  0
+#define SPEC_PUTCHAR 1
+#define SPEC_STREAM  2
+
+static int _spec_mode;
+static out_fct_type _spec_out;
+static char* _spec_buffer;
+static size_t _spec_idx, _spec_maxlen;
+#ifdef FILES
+static file_out_type _spec_file;
+static out_fct_wrap_type _spec_wrap;
 #endif
+
+void __printf_begin_buffer(char* buffer, size_t maxlen) {
+  _spec_mode = SPEC_BUFFER;
+  _spec_out = buffer ? _out_buffer : _out_null;
+  _spec_buffer = buffer;
+  _spec_idx = 0;
+  _spec_maxlen = maxlen;
+}
+
+#ifdef FILES
+void __printf_begin_stream(FILE *stream) {
+  _spec_mode = SPEC_STREAM;
+  _spec_file.stream = stream;
+  _spec_file.len = 0;
+  _spec_wrap.fct = _fprintf_out;
+  _spec_wrap.arg = &_spec_file;
+  _spec_out = _out_fct;
+  _spec_buffer = (char*)(uintptr_t)&_spec_wrap;
+  _spec_idx = 0;
+  _spec_maxlen = (size_t)-1;
+}
+#endif
+
+void __printf_begin_stdout(void) {
+#ifdef FILES
+  __printf_begin_stream(stdout);
+#else
+  _spec_mode = SPEC_PUTCHAR;
+  _spec_out = _out_char;
+  _spec_buffer = NULL;
+  _spec_idx = 0;
+  _spec_maxlen = (size_t)-1;
+#endif
+}
+
+void __printf_literal(const char* s, size_t len) {
+  if (_spec_mode == SPEC_BUFFER) {
+    if (_spec_buffer && _spec_idx < _spec_maxlen) {
+      const size_t space = _spec_maxlen - _spec_idx;
+      memcpy(_spec_buffer + _spec_idx, s, len < space ? len : space);
+    }
+  }
+#ifdef FILES
+  else if (_spec_mode == SPEC_STREAM) {
+    // _fprintf_out expects space for at least one more character
+    if (_spec_file.len + len < sizeof(_spec_file.buffer)) {
+      memcpy(_spec_file.buffer + _spec_file.len, s, len);
+      _spec_file.len += len;
+    } else {
+      if (_spec_file.len) fwrite(_spec_file.buffer, 1, _spec_file.len, _spec_file.stream);
+      _spec_file.len = 0;
+      fwrite(s, 1, len, _spec_file.stream);
+    }
+  }
+#endif
+  else {
+    for (size_t i = 0; i < len; i++) _putchar(s[i]);
+  }
+  _spec_idx += len;
+}
+
+void __printf_signed(long value, unsigned int base, unsigned int prec, unsigned int width, unsigned int flags) {
+  _spec_idx = _ntoa_long(_spec_out, _spec_buffer, _spec_idx, _spec_maxlen, (unsigned long)(value > 0 ? value : 0 - value), value < 0, base, prec, width, flags);
+}
+
+void __printf_unsigned(unsigned long value, unsigned int base, unsigned int prec, unsigned int width, unsigned int flags) {
+  _spec_idx = _ntoa_long(_spec_out, _spec_buffer, _spec_idx, _spec_maxlen, value, false, base, prec, width, flags);
+}
+
+void __printf_double(double value, bool exponential, unsigned int prec, unsigned int width, unsigned int flags) {
+  if (exponential) {
+    _spec_idx = _etoa(_spec_out, _spec_buffer, _spec_idx, _spec_maxlen, value, prec, width, flags);
+  } else {
+    _spec_idx = _ftoa(_spec_out, _spec_buffer, _spec_idx, _spec_maxlen, value, prec, width, flags);
+  }
+}
+
+void __printf_char(int c, unsigned int width, unsigned int flags) {
+  unsigned int l = 1U;
+  if (!(flags & FLAGS_LEFT)) {
+    while (l++ < width) _spec_out(' ', _spec_buffer, _spec_idx++, _spec_maxlen);
+  }
+  _spec_out((char)c, _spec_buffer, _spec_idx++, _spec_maxlen);
+  if (flags & FLAGS_LEFT) {
+    while (l++ < width) _spec_out(' ', _spec_buffer, _spec_idx++, _spec_maxlen);
+  }
+}
+
+void __printf_string(const char* p, unsigned int prec, unsigned int width, unsigned int flags) {
+  if (!width && !(flags & FLAGS_PRECISION)) {
+    __printf_literal(p, strlen(p));
+    return;
+  }
+
+  unsigned int l = _strnlen_s(p, prec ? prec : (size_t)-1);
+  if (flags & FLAGS_PRECISION) {
+    l = (l < prec ? l : prec);
+  }
+  if (!(flags & FLAGS_LEFT)) {
+    while (l++ < width) _spec_out(' ', _spec_buffer, _spec_idx++, _spec_maxlen);
+  }
+  while ((*p != 0) && (!(flags & FLAGS_PRECISION) || prec--)) {
+    _spec_out(*(p++), _spec_buffer, _spec_idx++, _spec_maxlen);
+  }
+  if (flags & FLAGS_LEFT) {
+    while (l++ < width) _spec_out(' ', _spec_buffer, _spec_idx++, _spec_maxlen);
+  }
+}
+
+int __printf_end(void) {
+  if (_spec_mode == SPEC_BUFFER) {
+    _spec_out((char)0, _spec_buffer, _spec_idx < _spec_maxlen ? _spec_idx : _spec_maxlen - 1U, _spec_maxlen);
+  }
+#ifdef FILES
+  else if (_spec_mode == SPEC_STREAM && _spec_file.len) {
+    fwrite(_spec_file.buffer, 1, _spec_file.len, _spec_file.stream);
+  }
+#endif
+  return (int)_spec_idx;
+}
@@ -2,8 +2,14 @@
 #include <stdio.h>
 #define _putchar putchar
 
+#ifndef FILES
 #define printf_ printf
+#define vprintf_ vprintf
+#else
+// printf and vprintf write to stdout using vfprintf instead
+#define printf_ __putchar_printf
+#define vprintf_ __putchar_vprintf
+#endif
 #define sprintf_ sprintf
 #define snprintf_ snprintf
-#define vprintf_ vprintf
 #define vsnprintf_ vsnprintf
@@ -13,27 +13,75 @@ double trunc(double);
 double copysign(double, double);
 double round(double); // nearest
 
-//double acos(double);
-//double asin(double);
-//double atan(double);
-//double atan2(double, double);
-//double cos(double);
-//double sin(double);
-//double tan(double);
-//
-//double cosh(double);
-//double sinh(double);
-//double tanh(double);
-//
+// c89
+double acos(double);
+double asin(double);
+double atan(double);
+double atan2(double, double);
+double cos(double);
+double sin(double);
+double tan(double);
+
+double cosh(double);
+double sinh(double);
+double tanh(double);
+
 double exp(double);
-//double ldexp(double, int);
-//double frexp(double, int *);
-//double log(double);
-//double log10(double);
-//double modf(double, double *);
-//
-//double pow(double, double);
-//double fmod(double, double);
+double ldexp(double, int);
+double frexp(double, int *);
+double log(double);
+double log10(double);
+double modf(double, double *);
+
+double pow(double, double);
+double fmod(double, double);
+
+// c99
+double exp2(double);
+double expm1(double);
+double log2(double);
+double log1p(double);
+double scalbn(double, int);
+
+// float versions
+float sqrtf(float);
+float ceilf(float);
+float fabsf(float);
+float floorf(float);
+float fmaxf(float, float);
+float fminf(float, float);
+float truncf(float);
+float copysignf(float, float);
+float roundf(float);
+
+float acosf(float);
+float asinf(float);
+float atanf(float);
+float atan2f(float, float);
+float cosf(float);
+float sinf(float);
+float tanf(float);
+
+float coshf(float);
+float sinhf(float);
+float tanhf(float);
+
+float expf(float);
+float exp2f(float);
+float expm1f(float);
+float ldexpf(float, int);
+float scalbnf(float, int);
+float frexpf(float, int *);
+float logf(float);
+float log10f(float);
+float log2f(float);
+float log1pf(float);
+float modff(float, float *);
+
+float powf(float, float);
+float fmodf(float, float);
 
 #define INFINITY (1./0)
 #define NAN (0./0)
+#define HUGE_VAL INFINITY
+#define HUGE_VALF ((float) INFINITY)
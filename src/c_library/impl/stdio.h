@@ -9,6 +9,16 @@ int snprintf(char* buffer, size_t count, const char* format, ...);
 int vsnprintf(char* buffer, size_t count, const char* format, va_list va);
 int vprintf(const char* format, va_list va);
 int fctprintf(void (*out)(char character, void* arg), void* arg, const char* format, ...);
+// calls with constant formats are rewritten to use these instead, see src/ir/transform/printf.ts
+void __printf_begin_buffer(char* buffer, size_t maxlen);
+void __printf_begin_stdout(void);
+void __printf_literal(const char* s, size_t len);
+void __printf_signed(long value, unsigned int base, unsigned int prec, unsigned int width, unsigned int flags);
+void __printf_unsigned(unsigned long value, unsigned int base, unsigned int prec, unsigned int width, unsigned int flags);
+void __printf_double(double value, _Bool exponential, unsigned int prec, unsigned int width, unsigned int flags);
+void __printf_char(int c, unsigned int width, unsigned int flags);
+void __printf_string(const char* s, unsigned int prec, unsigned int width, unsigned int flags);
+int __printf_end(void);
 
 // from stdlib/stdio.c
 int putchar(int chr);
@@ -21,18 +31,30 @@ import void __put_char(char);
 
 #else
 import int __get_char(int handle);
+// bulk read, returns the number of bytes read (0 at the end of the file), -1 on error or -2 if unsupported
+import int __read(int handle, char *ptr, size_t len);
 import int __put_char(int handle, int c);
+// bulk write, returns len, -1 on error or -2 if unsupported (then __put_char is used instead)
+import int __write(int handle, const char *ptr, size_t len);
 import long __get_pos(int handle);
 import long __get_len(int handle);
 import int __set_pos(int handle, long pos);
 import int __exists();
 import int __move();
 import int __get_fhandle();
+// called by runtime.Files.attach through the __stdio_attach wrapper
+void __stdio_attached(void);
 
 // File support
 typedef struct __stdio_file {
     int handle, unget, len, flags;
     _Bool error, eof;
+    // buffer, allocated on first use unless provided using setvbuf. holds either pending writes (buf_len) or unread
+    // input (rbuf_pos to rbuf_end)
+    int buf_mode, buf_len, buf_size;
+    char *buf;
+    int rbuf_pos, rbuf_end;
+    struct __stdio_file *next_buffered;
 } FILE;
 typedef long fpos_t;
 
@@ -49,6 +71,8 @@ void setbuf(FILE *stream, char *buf);
 
 // printf functions
 int fprintf(FILE *stream, const char *format, ...);
+int vfprintf(FILE *stream, const char *format, va_list va);
+void __printf_begin_stream(FILE *stream);
 // scanf functions
 int vfscanf(FILE *stream, const char *fmt, va_list ap);
 int fscanf(FILE *stream, const char *fmt, ...);
@@ -82,7 +106,7 @@ int ferror(FILE *stream);
 void perror(const char *s);
 
 #define EOF -1
-#define BUFSIZ 16
+#define BUFSIZ 4096
 #define FILENAME_MAX 2048
 #define FOPEN_MAX 1073741824
 #define _IONBF 0
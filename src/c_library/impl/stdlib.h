@@ -8,6 +8,21 @@ void free(void* ptr);
 void* realloc(void* ptr, size_t size);
 void* calloc(size_t nobj, size_t size);
 
+#ifdef ALLOC_STATS
+#define HEAP_STATS_BUCKETS 16
+
+// all sizes are in bytes, see runtime.heapStats
+struct heap_stats {
+  size_t in_use, peak_in_use;        // allocated chunks, including headers
+  size_t free_chunks, largest_free;  // free chunks and the largest allocation possible without growing the heap
+  size_t heap_size, grow_calls;      // memory added by memory.grow
+  size_t allocations, reallocations, frees;
+  size_t size_buckets[HEAP_STATS_BUCKETS]; // malloc calls by requested size, 16 << n bytes
+};
+
+const struct heap_stats* heap_stats(void);
+#endif
+
 // custom/stdlib.c stubs
 void abort(void);
 void exit(int code);
@@ -15,11 +30,16 @@ int atexit(void (*fcn)(void));
 int system(const char *s);
 char *getenv(const char *name);
 
-// avrlibc
+// custom/strtod.c, correctly rounded using the Eisel-Lemire algorithm
 double strtod(const char *s, char **endp);
+
+// avrlibc
 long strtol(const char *s, char **endp, int base);
 unsigned long strtoul(const char *s, char **endp, int base);
 void *bsearch(const void * key, const void * base, size_t nmemb, size_t size, int (*cmp)(const void *, const void *));
+
+// custom/qsort.c introsort. swaps use 64 or 32 bit words when the element size allows, define QSORT_SIMD to use v128
+// for multiples of 16 bytes
 void qsort(void * base, size_t nmemb, size_t size, int (*cmp)(const void *, const void *));
 
 // custom/stdlib.c implementations
@@ -1,6 +1,9 @@
 #pragma once
 #include <stddef.h>
 
+// strlen, strchr, memchr, strnlen, strcmp and memcmp read 64 bit words at a time. define STRING_SIMD to use v128 loads
+// instead, or STRING_BYTEWISE for simple byte loops
+
 char* strcpy(char* s1, const char* s2);
 char* strncpy(char* s1, const char* s2, size_t n);
 char* strcat(char* s1, const char* s2);
@@ -1,8 +1,30 @@
 #pragma once
 #include <stddef.h>
 
+// milliseconds, see custom/time.c
 import double __time();
+// nanoseconds from the clock given by a CLOCK_ constant, runtime.timeImports provides both
+import long __clock_ns(int clock_id);
 
 typedef double clock_t;
 clock_t clock();
 #define CLOCKS_PER_SEC 1000
+
+typedef long time_t;
+typedef int clockid_t;
+
+struct timespec {
+  time_t tv_sec;
+  long tv_nsec;
+};
+
+#define CLOCK_REALTIME 0
+#define CLOCK_MONOTONIC 1
+
+time_t time(time_t *t);
+int clock_gettime(clockid_t clock_id, struct timespec *ts);
+int clock_getres(clockid_t clock_id, struct timespec *ts);
+
+// nanoseconds from the monotonic clock, for timing parts of a program. defining DETERMINISTIC_TIME replaces every
+// clock with a counter which advances by that many nanoseconds each time it's read, so runs are reproducible
+long __c2wasm_now_ns(void);
@@ -11,3 +11,6 @@
 #define f32_min(x,y)        (__wasm_f32__(2, (float) x, (float) y, 0x96))
 #define f32_max(x,y)        (__wasm_f32__(2, (float) x, (float) y, 0x97))
 #define f32_copysign(x,y)   (__wasm_f32__(2, (float) x, (float) y, 0x98))
+
+#define f32_reinterpret_i32(x)  (__wasm_f32__(1, (int) (x), 0xBE))
+#define i32_reinterpret_f32(x)  (__wasm_i32__(1, (float) (x), 0xBC))
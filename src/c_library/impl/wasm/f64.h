@@ -11,3 +11,6 @@
 #define f64_min(x,y)        (__wasm_f64__(2, (double) x, (double) y, 0xA4))
 #define f64_max(x,y)        (__wasm_f64__(2, (double) x, (double) y, 0xA5))
 #define f64_copysign(x,y)   (__wasm_f64__(2, (double) x, (double) y, 0xA6))
+
+#define f64_reinterpret_i64(x)  (__wasm_f64__(1, (long) (x), 0xBF))
+#define i64_reinterpret_f64(x)  (__wasm_i64__(1, (double) (x), 0xBD))
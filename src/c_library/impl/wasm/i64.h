@@ -0,0 +1,8 @@
+#pragma once
+
+#define i64_clz(x)          (__wasm_i64__(1, (long) (x), 0x79))
+#define i64_ctz(x)          (__wasm_i64__(1, (long) (x), 0x7A))
+#define i64_popcnt(x)       (__wasm_i64__(1, (long) (x), 0x7B))
+
+#define i64_rotl(x,y)       (__wasm_i64__(2, (long) (x), (long) (y), 0x89))
+#define i64_rotr(x,y)       (__wasm_i64__(2, (long) (x), (long) (y), 0x8A))
@@ -0,0 +1,204 @@
+#pragma once
+
+typedef __v128 v128_t;
+
+// memory
+#define v128_load(p)                        (*(const v128_t*) (p))
+#define v128_store(p,a)                     (*(v128_t*) (p) = (v128_t) (a))
+#define v128_zero()                         (__wasm_v128__(0, 0xFD, 0x0C, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0))
+
+// bitwise
+#define v128_not(a)                         (__wasm_v128__(1, (v128_t) (a), 0xFD, 0x4D))
+#define v128_and(a,b)                       (__wasm_v128__(2, (v128_t) (a), (v128_t) (b), 0xFD, 0x4E))
+#define v128_andnot(a,b)                    (__wasm_v128__(2, (v128_t) (a), (v128_t) (b), 0xFD, 0x4F))
+#define v128_or(a,b)                        (__wasm_v128__(2, (v128_t) (a), (v128_t) (b), 0xFD, 0x50))
+#define v128_xor(a,b)                       (__wasm_v128__(2, (v128_t) (a), (v128_t) (b), 0xFD, 0x51))
+#define v128_bitselect(a,b,mask)            (__wasm_v128__(3, (v128_t) (a), (v128_t) (b), (v128_t) (mask), 0xFD, 0x52))
+#define v128_any_true(a)                    (__wasm_i32__(1, (v128_t) (a), 0xFD, 0x53))
+
+// shuffles
+#define i8x16_shuffle(a,b,c0,c1,c2,c3,c4,c5,c6,c7,c8,c9,c10,c11,c12,c13,c14,c15)\
+    (__wasm_v128__(2, (v128_t) (a), (v128_t) (b), 0xFD, 0x0D, c0, c1, c2, c3, c4, c5, c6, c7, c8, c9, c10, c11, c12, c13, c14, c15))
+#define i8x16_swizzle(a,b)                  (__wasm_v128__(2, (v128_t) (a), (v128_t) (b), 0xFD, 0x0E))
+
+// i8x16
+#define i8x16_splat(x)                      (__wasm_v128__(1, (int) (x), 0xFD, 0x0F))
+#define i8x16_extract_lane_s(a,lane)        (__wasm_i32__(1, (v128_t) (a), 0xFD, 0x15, lane))
+#define i8x16_extract_lane_u(a,lane)        (__wasm_i32__(1, (v128_t) (a), 0xFD, 0x16, lane))
+#define i8x16_replace_lane(a,lane,x)        (__wasm_v128__(2, (v128_t) (a), (int) (x), 0xFD, 0x17, lane))
+#define i8x16_abs(a)                        (__wasm_v128__(1, (v128_t) (a), 0xFD, 0x60))
+#define i8x16_neg(a)                        (__wasm_v128__(1, (v128_t) (a), 0xFD, 0x61))
+#define i8x16_popcnt(a)                     (__wasm_v128__(1, (v128_t) (a), 0xFD, 0x62))
+#define i8x16_all_true(a)                   (__wasm_i32__(1, (v128_t) (a), 0xFD, 0x63))
+#define i8x16_bitmask(a)                    (__wasm_i32__(1, (v128_t) (a), 0xFD, 0x64))
+#define i8x16_shl(a,n)                      (__wasm_v128__(2, (v128_t) (a), (int) (n), 0xFD, 0x6B))
+#define i8x16_shr_s(a,n)                    (__wasm_v128__(2, (v128_t) (a), (int) (n), 0xFD, 0x6C))
+#define i8x16_shr_u(a,n)                    (__wasm_v128__(2, (v128_t) (a), (int) (n), 0xFD, 0x6D))
+#define i8x16_add(a,b)                      (__wasm_v128__(2, (v128_t) (a), (v128_t) (b), 0xFD, 0x6E))
+#define i8x16_add_sat_s(a,b)                (__wasm_v128__(2, (v128_t) (a), (v128_t) (b), 0xFD, 0x6F))
+#define i8x16_add_sat_u(a,b)                (__wasm_v128__(2, (v128_t) (a), (v128_t) (b), 0xFD, 0x70))
+#define i8x16_sub(a,b)                      (__wasm_v128__(2, (v128_t) (a), (v128_t) (b), 0xFD, 0x71))
+#define i8x16_sub_sat_s(a,b)                (__wasm_v128__(2, (v128_t) (a), (v128_t) (b), 0xFD, 0x72))
+#define i8x16_sub_sat_u(a,b)                (__wasm_v128__(2, (v128_t) (a), (v128_t) (b), 0xFD, 0x73))
+#define i8x16_min_s(a,b)                    (__wasm_v128__(2, (v128_t) (a), (v128_t) (b), 0xFD, 0x76))
+#define i8x16_min_u(a,b)                    (__wasm_v128__(2, (v128_t) (a), (v128_t) (b), 0xFD, 0x77))
+#define i8x16_max_s(a,b)                    (__wasm_v128__(2, (v128_t) (a), (v128_t) (b), 0xFD, 0x78))
+#define i8x16_max_u(a,b)                    (__wasm_v128__(2, (v128_t) (a), (v128_t) (b), 0xFD, 0x79))
+#define i8x16_avgr_u(a,b)                   (__wasm_v128__(2, (v128_t) (a), (v128_t) (b), 0xFD, 0x7B))
+#define i8x16_eq(a,b)                       (__wasm_v128__(2, (v128_t) (a), (v128_t) (b), 0xFD, 0x23))
+#define i8x16_ne(a,b)                       (__wasm_v128__(2, (v128_t) (a), (v128_t) (b), 0xFD, 0x24))
+#define i8x16_lt_s(a,b)                     (__wasm_v128__(2, (v128_t) (a), (v128_t) (b), 0xFD, 0x25))
+#define i8x16_lt_u(a,b)                     (__wasm_v128__(2, (v128_t) (a), (v128_t) (b), 0xFD, 0x26))
+#define i8x16_gt_s(a,b)                     (__wasm_v128__(2, (v128_t) (a), (v128_t) (b), 0xFD, 0x27))
+#define i8x16_gt_u(a,b)                     (__wasm_v128__(2, (v128_t) (a), (v128_t) (b), 0xFD, 0x28))
+#define i8x16_le_s(a,b)                     (__wasm_v128__(2, (v128_t) (a), (v128_t) (b), 0xFD, 0x29))
+#define i8x16_le_u(a,b)                     (__wasm_v128__(2, (v128_t) (a), (v128_t) (b), 0xFD, 0x2A))
+#define i8x16_ge_s(a,b)                     (__wasm_v128__(2, (v128_t) (a), (v128_t) (b), 0xFD, 0x2B))
+#define i8x16_ge_u(a,b)                     (__wasm_v128__(2, (v128_t) (a), (v128_t) (b), 0xFD, 0x2C))
+
+// i16x8
+#define i16x8_splat(x)                      (__wasm_v128__(1, (int) (x), 0xFD, 0x10))
+#define i16x8_extract_lane_s(a,lane)        (__wasm_i32__(1, (v128_t) (a), 0xFD, 0x18, lane))
+#define i16x8_extract_lane_u(a,lane)        (__wasm_i32__(1, (v128_t) (a), 0xFD, 0x19, lane))
+#define i16x8_replace_lane(a,lane,x)        (__wasm_v128__(2, (v128_t) (a), (int) (x), 0xFD, 0x1A, lane))
+#define i16x8_abs(a)                        (__wasm_v128__(1, (v128_t) (a), 0xFD, 0x80, 0x01))
+#define i16x8_neg(a)                        (__wasm_v128__(1, (v128_t) (a), 0xFD, 0x81, 0x01))
+#define i16x8_all_true(a)                   (__wasm_i32__(1, (v128_t) (a), 0xFD, 0x83, 0x01))
+#define i16x8_bitmask(a)                    (__wasm_i32__(1, (v128_t) (a), 0xFD, 0x84, 0x01))
+#define i16x8_shl(a,n)                      (__wasm_v128__(2, (v128_t) (a), (int) (n), 0xFD, 0x8B, 0x01))
+#define i16x8_shr_s(a,n)                    (__wasm_v128__(2, (v128_t) (a), (int) (n), 0xFD, 0x8C, 0x01))
+#define i16x8_shr_u(a,n)                    (__wasm_v128__(2, (v128_t) (a), (int) (n), 0xFD, 0x8D, 0x01))
+#define i16x8_add(a,b)                      (__wasm_v128__(2, (v128_t) (a), (v128_t) (b), 0xFD, 0x8E, 0x01))
+#define i16x8_add_sat_s(a,b)                (__wasm_v128__(2, (v128_t) (a), (v128_t) (b), 0xFD, 0x8F, 0x01))
+#define i16x8_add_sat_u(a,b)                (__wasm_v128__(2, (v128_t) (a), (v128_t) (b), 0xFD, 0x90, 0x01))
+#define i16x8_sub(a,b)                      (__wasm_v128__(2, (v128_t) (a), (v128_t) (b), 0xFD, 0x91, 0x01))
+#define i16x8_sub_sat_s(a,b)                (__wasm_v128__(2, (v128_t) (a), (v128_t) (b), 0xFD, 0x92, 0x01))
+#define i16x8_sub_sat_u(a,b)                (__wasm_v128__(2, (v128_t) (a), (v128_t) (b), 0xFD, 0x93, 0x01))
+#define i16x8_mul(a,b)                      (__wasm_v128__(2, (v128_t) (a), (v128_t) (b), 0xFD, 0x95, 0x01))
+#define i16x8_min_s(a,b)                    (__wasm_v128__(2, (v128_t) (a), (v128_t) (b), 0xFD, 0x96, 0x01))
+#define i16x8_min_u(a,b)                    (__wasm_v128__(2, (v128_t) (a), (v128_t) (b), 0xFD, 0x97, 0x01))
+#define i16x8_max_s(a,b)                    (__wasm_v128__(2, (v128_t) (a), (v128_t) (b), 0xFD, 0x98, 0x01))
+#define i16x8_max_u(a,b)                    (__wasm_v128__(2, (v128_t) (a), (v128_t) (b), 0xFD, 0x99, 0x01))
+#define i16x8_avgr_u(a,b)                   (__wasm_v128__(2, (v128_t) (a), (v128_t) (b), 0xFD, 0x9B, 0x01))
+#define i16x8_eq(a,b)                       (__wasm_v128__(2, (v128_t) (a), (v128_t) (b), 0xFD, 0x2D))
+#define i16x8_ne(a,b)                       (__wasm_v128__(2, (v128_t) (a), (v128_t) (b), 0xFD, 0x2E))
+#define i16x8_lt_s(a,b)                     (__wasm_v128__(2, (v128_t) (a), (v128_t) (b), 0xFD, 0x2F))
+#define i16x8_lt_u(a,b)                     (__wasm_v128__(2, (v128_t) (a), (v128_t) (b), 0xFD, 0x30))
+#define i16x8_gt_s(a,b)                     (__wasm_v128__(2, (v128_t) (a), (v128_t) (b), 0xFD, 0x31))
+#define i16x8_gt_u(a,b)                     (__wasm_v128__(2, (v128_t) (a), (v128_t) (b), 0xFD, 0x32))
+#define i16x8_le_s(a,b)                     (__wasm_v128__(2, (v128_t) (a), (v128_t) (b), 0xFD, 0x33))
+#define i16x8_le_u(a,b)                     (__wasm_v128__(2, (v128_t) (a), (v128_t) (b), 0xFD, 0x34))
+#define i16x8_ge_s(a,b)                     (__wasm_v128__(2, (v128_t) (a), (v128_t) (b), 0xFD, 0x35))
+#define i16x8_ge_u(a,b)                     (__wasm_v128__(2, (v128_t) (a), (v128_t) (b), 0xFD, 0x36))
+
+// i32x4
+#define i32x4_splat(x)                      (__wasm_v128__(1, (int) (x), 0xFD, 0x11))
+#define i32x4_extract_lane(a,lane)          (__wasm_i32__(1, (v128_t) (a), 0xFD, 0x1B, lane))
+#define i32x4_replace_lane(a,lane,x)        (__wasm_v128__(2, (v128_t) (a), (int) (x), 0xFD, 0x1C, lane))
+#define i32x4_abs(a)                        (__wasm_v128__(1, (v128_t) (a), 0xFD, 0xA0, 0x01))
+#define i32x4_neg(a)                        (__wasm_v128__(1, (v128_t) (a), 0xFD, 0xA1, 0x01))
+#define i32x4_all_true(a)                   (__wasm_i32__(1, (v128_t) (a), 0xFD, 0xA3, 0x01))
+#define i32x4_bitmask(a)                    (__wasm_i32__(1, (v128_t) (a), 0xFD, 0xA4, 0x01))
+#define i32x4_shl(a,n)                      (__wasm_v128__(2, (v128_t) (a), (int) (n), 0xFD, 0xAB, 0x01))
+#define i32x4_shr_s(a,n)                    (__wasm_v128__(2, (v128_t) (a), (int) (n), 0xFD, 0xAC, 0x01))
+#define i32x4_shr_u(a,n)                    (__wasm_v128__(2, (v128_t) (a), (int) (n), 0xFD, 0xAD, 0x01))
+#define i32x4_add(a,b)                      (__wasm_v128__(2, (v128_t) (a), (v128_t) (b), 0xFD, 0xAE, 0x01))
+#define i32x4_sub(a,b)                      (__wasm_v128__(2, (v128_t) (a), (v128_t) (b), 0xFD, 0xB1, 0x01))
+#define i32x4_mul(a,b)                      (__wasm_v128__(2, (v128_t) (a), (v128_t) (b), 0xFD, 0xB5, 0x01))
+#define i32x4_min_s(a,b)                    (__wasm_v128__(2, (v128_t) (a), (v128_t) (b), 0xFD, 0xB6, 0x01))
+#define i32x4_min_u(a,b)                    (__wasm_v128__(2, (v128_t) (a), (v128_t) (b), 0xFD, 0xB7, 0x01))
+#define i32x4_max_s(a,b)                    (__wasm_v128__(2, (v128_t) (a), (v128_t) (b), 0xFD, 0xB8, 0x01))
+#define i32x4_max_u(a,b)                    (__wasm_v128__(2, (v128_t) (a), (v128_t) (b), 0xFD, 0xB9, 0x01))
+#define i32x4_eq(a,b)                       (__wasm_v128__(2, (v128_t) (a), (v128_t) (b), 0xFD, 0x37))
+#define i32x4_ne(a,b)                       (__wasm_v128__(2, (v128_t) (a), (v128_t) (b), 0xFD, 0x38))
+#define i32x4_lt_s(a,b)                     (__wasm_v128__(2, (v128_t) (a), (v128_t) (b), 0xFD, 0x39))
+#define i32x4_lt_u(a,b)                     (__wasm_v128__(2, (v128_t) (a), (v128_t) (b), 0xFD, 0x3A))
+#define i32x4_gt_s(a,b)                     (__wasm_v128__(2, (v128_t) (a), (v128_t) (b), 0xFD, 0x3B))
+#define i32x4_gt_u(a,b)                     (__wasm_v128__(2, (v128_t) (a), (v128_t) (b), 0xFD, 0x3C))
+#define i32x4_le_s(a,b)                     (__wasm_v128__(2, (v128_t) (a), (v128_t) (b), 0xFD, 0x3D))
+#define i32x4_le_u(a,b)                     (__wasm_v128__(2, (v128_t) (a), (v128_t) (b), 0xFD, 0x3E))
+#define i32x4_ge_s(a,b)                     (__wasm_v128__(2, (v128_t) (a), (v128_t) (b), 0xFD, 0x3F))
+#define i32x4_ge_u(a,b)                     (__wasm_v128__(2, (v128_t) (a), (v128_t) (b), 0xFD, 0x40))
+
+// i64x2
+#define i64x2_splat(x)                      (__wasm_v128__(1, (long) (x), 0xFD, 0x12))
+#define i64x2_extract_lane(a,lane)          (__wasm_i64__(1, (v128_t) (a), 0xFD, 0x1D, lane))
+#define i64x2_replace_lane(a,lane,x)        (__wasm_v128__(2, (v128_t) (a), (long) (x), 0xFD, 0x1E, lane))
+#define i64x2_abs(a)                        (__wasm_v128__(1, (v128_t) (a), 0xFD, 0xC0, 0x01))
+#define i64x2_neg(a)                        (__wasm_v128__(1, (v128_t) (a), 0xFD, 0xC1, 0x01))
+#define i64x2_all_true(a)                   (__wasm_i32__(1, (v128_t) (a), 0xFD, 0xC3, 0x01))
+#define i64x2_bitmask(a)                    (__wasm_i32__(1, (v128_t) (a), 0xFD, 0xC4, 0x01))
+#define i64x2_shl(a,n)                      (__wasm_v128__(2, (v128_t) (a), (int) (n), 0xFD, 0xCB, 0x01))
+#define i64x2_shr_s(a,n)                    (__wasm_v128__(2, (v128_t) (a), (int) (n), 0xFD, 0xCC, 0x01))
+#define i64x2_shr_u(a,n)                    (__wasm_v128__(2, (v128_t) (a), (int) (n), 0xFD, 0xCD, 0x01))
+#define i64x2_add(a,b)                      (__wasm_v128__(2, (v128_t) (a), (v128_t) (b), 0xFD, 0xCE, 0x01))
+#define i64x2_sub(a,b)                      (__wasm_v128__(2, (v128_t) (a), (v128_t) (b), 0xFD, 0xD1, 0x01))
+#define i64x2_mul(a,b)                      (__wasm_v128__(2, (v128_t) (a), (v128_t) (b), 0xFD, 0xD5, 0x01))
+#define i64x2_eq(a,b)                       (__wasm_v128__(2, (v128_t) (a), (v128_t) (b), 0xFD, 0xD6, 0x01))
+#define i64x2_ne(a,b)                       (__wasm_v128__(2, (v128_t) (a), (v128_t) (b), 0xFD, 0xD7, 0x01))
+#define i64x2_lt_s(a,b)                     (__wasm_v128__(2, (v128_t) (a), (v128_t) (b), 0xFD, 0xD8, 0x01))
+#define i64x2_gt_s(a,b)                     (__wasm_v128__(2, (v128_t) (a), (v128_t) (b), 0xFD, 0xD9, 0x01))
+#define i64x2_le_s(a,b)                     (__wasm_v128__(2, (v128_t) (a), (v128_t) (b), 0xFD, 0xDA, 0x01))
+#define i64x2_ge_s(a,b)                     (__wasm_v128__(2, (v128_t) (a), (v128_t) (b), 0xFD, 0xDB, 0x01))
+
+// f32x4
+#define f32x4_splat(x)                      (__wasm_v128__(1, (float) (x), 0xFD, 0x13))
+#define f32x4_extract_lane(a,lane)          (__wasm_f32__(1, (v128_t) (a), 0xFD, 0x1F, lane))
+#define f32x4_replace_lane(a,lane,x)        (__wasm_v128__(2, (v128_t) (a), (float) (x), 0xFD, 0x20, lane))
+#define f32x4_abs(a)                        (__wasm_v128__(1, (v128_t) (a), 0xFD, 0xE0, 0x01))
+#define f32x4_neg(a)                        (__wasm_v128__(1, (v128_t) (a), 0xFD, 0xE1, 0x01))
+#define f32x4_sqrt(a)                       (__wasm_v128__(1, (v128_t) (a), 0xFD, 0xE3, 0x01))
+#define f32x4_ceil(a)                       (__wasm_v128__(1, (v128_t) (a), 0xFD, 0x67))
+#define f32x4_floor(a)                      (__wasm_v128__(1, (v128_t) (a), 0xFD, 0x68))
+#define f32x4_trunc(a)                      (__wasm_v128__(1, (v128_t) (a), 0xFD, 0x69))
+#define f32x4_nearest(a)                    (__wasm_v128__(1, (v128_t) (a), 0xFD, 0x6A))
+#define f32x4_add(a,b)                      (__wasm_v128__(2, (v128_t) (a), (v128_t) (b), 0xFD, 0xE4, 0x01))
+#define f32x4_sub(a,b)                      (__wasm_v128__(2, (v128_t) (a), (v128_t) (b), 0xFD, 0xE5, 0x01))
+#define f32x4_mul(a,b)                      (__wasm_v128__(2, (v128_t) (a), (v128_t) (b), 0xFD, 0xE6, 0x01))
+#define f32x4_div(a,b)                      (__wasm_v128__(2, (v128_t) (a), (v128_t) (b), 0xFD, 0xE7, 0x01))
+#define f32x4_min(a,b)                      (__wasm_v128__(2, (v128_t) (a), (v128_t) (b), 0xFD, 0xE8, 0x01))
+#define f32x4_max(a,b)                      (__wasm_v128__(2, (v128_t) (a), (v128_t) (b), 0xFD, 0xE9, 0x01))
+#define f32x4_pmin(a,b)                     (__wasm_v128__(2, (v128_t) (a), (v128_t) (b), 0xFD, 0xEA, 0x01))
+#define f32x4_pmax(a,b)                     (__wasm_v128__(2, (v128_t) (a), (v128_t) (b), 0xFD, 0xEB, 0x01))
+#define f32x4_eq(a,b)                       (__wasm_v128__(2, (v128_t) (a), (v128_t) (b), 0xFD, 0x41))
+#define f32x4_ne(a,b)                       (__wasm_v128__(2, (v128_t) (a), (v128_t) (b), 0xFD, 0x42))
+#define f32x4_lt(a,b)                       (__wasm_v128__(2, (v128_t) (a), (v128_t) (b), 0xFD, 0x43))
+#define f32x4_gt(a,b)                       (__wasm_v128__(2, (v128_t) (a), (v128_t) (b), 0xFD, 0x44))
+#define f32x4_le(a,b)                       (__wasm_v128__(2, (v128_t) (a), (v128_t) (b), 0xFD, 0x45))
+#define f32x4_ge(a,b)                       (__wasm_v128__(2, (v128_t) (a), (v128_t) (b), 0xFD, 0x46))
+
+// f64x2
+#define f64x2_splat(x)                      (__wasm_v128__(1, (double) (x), 0xFD, 0x14))
+#define f64x2_extract_lane(a,lane)          (__wasm_f64__(1, (v128_t) (a), 0xFD, 0x21, lane))
+#define f64x2_replace_lane(a,lane,x)        (__wasm_v128__(2, (v128_t) (a), (double) (x), 0xFD, 0x22, lane))
+#define f64x2_abs(a)                        (__wasm_v128__(1, (v128_t) (a), 0xFD, 0xEC, 0x01))
+#define f64x2_neg(a)                        (__wasm_v128__(1, (v128_t) (a), 0xFD, 0xED, 0x01))
+#define f64x2_sqrt(a)                       (__wasm_v128__(1, (v128_t) (a), 0xFD, 0xEF, 0x01))
+#define f64x2_ceil(a)                       (__wasm_v128__(1, (v128_t) (a), 0xFD, 0x74))
+#define f64x2_floor(a)                      (__wasm_v128__(1, (v128_t) (a), 0xFD, 0x75))
+#define f64x2_trunc(a)                      (__wasm_v128__(1, (v128_t) (a), 0xFD, 0x7A))
+#define f64x2_nearest(a)                    (__wasm_v128__(1, (v128_t) (a), 0xFD, 0x94, 0x01))
+#define f64x2_add(a,b)                      (__wasm_v128__(2, (v128_t) (a), (v128_t) (b), 0xFD, 0xF0, 0x01))
+#define f64x2_sub(a,b)                      (__wasm_v128__(2, (v128_t) (a), (v128_t) (b), 0xFD, 0xF1, 0x01))
+#define f64x2_mul(a,b)                      (__wasm_v128__(2, (v128_t) (a), (v128_t) (b), 0xFD, 0xF2, 0x01))
+#define f64x2_div(a,b)                      (__wasm_v128__(2, (v128_t) (a), (v128_t) (b), 0xFD, 0xF3, 0x01))
+#define f64x2_min(a,b)                      (__wasm_v128__(2, (v128_t) (a), (v128_t) (b), 0xFD, 0xF4, 0x01))
+#define f64x2_max(a,b)                      (__wasm_v128__(2, (v128_t) (a), (v128_t) (b), 0xFD, 0xF5, 0x01))
+#define f64x2_pmin(a,b)                     (__wasm_v128__(2, (v128_t) (a), (v128_t) (b), 0xFD, 0xF6, 0x01))
+#define f64x2_pmax(a,b)                     (__wasm_v128__(2, (v128_t) (a), (v128_t) (b), 0xFD, 0xF7, 0x01))
+#define f64x2_eq(a,b)                       (__wasm_v128__(2, (v128_t) (a), (v128_t) (b), 0xFD, 0x47))
+#define f64x2_ne(a,b)                       (__wasm_v128__(2, (v128_t) (a), (v128_t) (b), 0xFD, 0x48))
+#define f64x2_lt(a,b)                       (__wasm_v128__(2, (v128_t) (a), (v128_t) (b), 0xFD, 0x49))
+#define f64x2_gt(a,b)                       (__wasm_v128__(2, (v128_t) (a), (v128_t) (b), 0xFD, 0x4A))
+#define f64x2_le(a,b)                       (__wasm_v128__(2, (v128_t) (a), (v128_t) (b), 0xFD, 0x4B))
+#define f64x2_ge(a,b)                       (__wasm_v128__(2, (v128_t) (a), (v128_t) (b), 0xFD, 0x4C))
+
+// conversions
+#define i32x4_trunc_sat_f32x4_s(a)          (__wasm_v128__(1, (v128_t) (a), 0xFD, 0xF8, 0x01))
+#define i32x4_trunc_sat_f32x4_u(a)          (__wasm_v128__(1, (v128_t) (a), 0xFD, 0xF9, 0x01))
+#define f32x4_convert_i32x4_s(a)            (__wasm_v128__(1, (v128_t) (a), 0xFD, 0xFA, 0x01))
+#define f32x4_convert_i32x4_u(a)            (__wasm_v128__(1, (v128_t) (a), 0xFD, 0xFB, 0x01))
+#define f64x2_convert_low_i32x4_s(a)        (__wasm_v128__(1, (v128_t) (a), 0xFD, 0xFE, 0x01))
+#define f64x2_convert_low_i32x4_u(a)        (__wasm_v128__(1, (v128_t) (a), 0xFD, 0xFF, 0x01))
+#define f32x4_demote_f64x2_zero(a)          (__wasm_v128__(1, (v128_t) (a), 0xFD, 0x5E))
+#define f64x2_promote_low_f32x4(a)          (__wasm_v128__(1, (v128_t) (a), 0xFD, 0x5F))
@@ -39,10 +39,96 @@ function encodeInt(num: number) {
 }
 
 export function mainWrapper(instance: WebAssembly.Exports, args: string[]): number | bigint | void {
+    let result;
     if ((instance.main as Function).length > 0) {
         const [argc, argv] = injectArgs(instance, args);
-        return (instance as {main: (argc: number, argv: number) => number | bigint | void}).main(argc, argv);
+        result = (instance as {main: (argc: number, argv: number) => number | bigint | void}).main(argc, argv);
     } else {
-        return (instance as {main: () => number | bigint | void}).main();
+        result = (instance as {main: () => number | bigint | void}).main();
+    }
+
+    // returning from main flushes stdio buffers like exit does, needs FILES
+    if (typeof instance.__stdio_flush === "function") instance.__stdio_flush();
+    return result;
+}
+
+export interface InstancePoolOptions {
+    /** Idle instances kept for reuse, default 4 */
+    maxIdle?: number;
+    /**
+     * Instances whose memory has grown by more than this many bytes are discarded after a run, default 16 MiB. Memory
+     * can't shrink and grown pages aren't reused after restoring the snapshot, so this is the total over all its runs
+     */
+    maxGrowth?: number;
+}
+
+/**
+ * Keeps warm instances of a module for running many short programs. The memory and globals of each instance are
+ * snapshotted after instantiation and copied back after every run, which is much cheaper than instantiating again.
+ * Instances which trap (including exit and abort) or have grown memory by more than maxGrowth are discarded. Runs
+ * share the imports, so per-run state like runtime.Files has to be swapped in by the caller, and attached in the run.
+ */
+export class InstancePool {
+    private readonly idle: PooledInstance[] = [];
+    private readonly maxIdle: number;
+    private readonly maxGrowth: number;
+
+    constructor(private readonly module: WebAssembly.Module, private readonly imports: WebAssembly.Imports,
+                options: InstancePoolOptions = {}) {
+        this.maxIdle = options.maxIdle ?? 4;
+        this.maxGrowth = options.maxGrowth ?? 16 * 1024 * 1024;
+    }
+
+    /** Calls fn with an instance in its initial state, which must not be used after fn (or its promise) completes */
+    async run<T>(fn: (instance: WebAssembly.Exports) => T | PromiseLike<T>): Promise<T> {
+        const pooled = this.idle.pop() ?? new PooledInstance(await WebAssembly.instantiate(this.module, this.imports));
+
+        // discard the instance if fn throws or rejects, as a trap can leave memory in any state. the result is awaited
+        // so the instance isn't restored while an async fn is still using it
+        const result = await fn(pooled.exports);
+
+        if (pooled.grownBytes() <= this.maxGrowth && this.idle.length < this.maxIdle) {
+            pooled.restore();
+            this.idle.push(pooled);
+        }
+        return result;
+    }
+
+    /** Runs main like mainWrapper */
+    main(args: string[]): Promise<number | bigint | void> {
+        return this.run(instance => mainWrapper(instance, args));
+    }
+}
+
+class PooledInstance {
+    readonly exports: WebAssembly.Exports;
+    private readonly memory: WebAssembly.Memory;
+    private readonly snapshot: Uint8Array;
+    private readonly globals: [global: WebAssembly.Global, value: unknown][];
+
+    constructor(instance: WebAssembly.Instance) {
+        const {__mem} = instance.exports;
+        if (!(__mem instanceof WebAssembly.Memory)) {
+            throw new Error("Needs __mem export");
+        }
+        this.exports = instance.exports;
+        this.memory = __mem;
+        this.snapshot = new Uint8Array(__mem.buffer).slice();
+        this.globals = Object.values(this.exports)
+            .filter((x): x is WebAssembly.Global => x instanceof WebAssembly.Global)
+            .map(global => [global, global.value] as [WebAssembly.Global, unknown]);
+    }
+
+    grownBytes(): number {
+        return this.memory.buffer.byteLength - this.snapshot.length;
+    }
+
+    restore(): void {
+        // memory can't shrink, so pages grown by previous runs are left unused as malloc starts a new region after them
+        new Uint8Array(this.memory.buffer).set(this.snapshot);
+        for (const [global, value] of this.globals) {
+            // immutable globals can't be set, but never change
+            if (global.value !== value) global.value = value;
+        }
     }
 }
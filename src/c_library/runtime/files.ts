@@ -3,16 +3,28 @@ export class Files {
     private handleMap = new Map<number, FileLike>();
     private nameMap = new Map<string, number>();
     private fileNameBuffer = "";
+    private memory?: WebAssembly.Memory;
 
     constructor(output: (char: string) => void, input?: () => string, files?: Map<string, Uint8Array | FileLike>) {
         // handle 0 - stdin
         if (input) {
-            const currentInput: number[] = [];
-            this.setupIoHandle(0, () => {
-                if (currentInput.length === 0) currentInput.push(...new TextEncoder().encode(input() ?? ""));
-                if (currentInput.length === 0) return -1;
-                return currentInput.shift() ?? -1;
-            }, () => false);
+            const encoder = new TextEncoder();
+            let currentInput = new Uint8Array(0), inputPos = 0;
+            const available = () => {
+                if (inputPos >= currentInput.length) {
+                    currentInput = encoder.encode(input() ?? "");
+                    inputPos = 0;
+                }
+                return currentInput.length - inputPos;
+            };
+
+            this.setupIoHandle(0, () => available() > 0 ? currentInput[inputPos++] : -1, () => false, (dest) => {
+                // only request more input once the current input has been read
+                const n = Math.min(dest.length, available());
+                dest.set(currentInput.subarray(inputPos, inputPos + n));
+                inputPos += n;
+                return n;
+            });
         } else {
             this.setupIoHandle(0, () => -1, () => false);
         }
@@ -39,8 +51,7 @@ export class Files {
             for (const [fname, contents] of files.entries()) {
                 let file;
                 if (contents instanceof Uint8Array) {
-                    file = new File();
-                    file.bytes = [...contents];
+                    file = new File(contents);
                 } else {
                     file = contents;
                 }
@@ -50,15 +61,27 @@ export class Files {
         }
     }
 
-    private setupIoHandle(handle: number, get: () => number | -1, put: (c: number) => boolean) {
+    private setupIoHandle(handle: number, get: () => number | -1, put: (c: number) => boolean,
+                          read?: (dest: Uint8Array) => number) {
         this.handleMap.set(handle, {
-            get, put,
+            get, put, read,
             pos: () => 0n,
             len: () => 0n,
             set_pos: () => false
         });
     }
 
+    /** Allows __read and __write to access the instance's memory, otherwise each byte uses __get_char or __put_char */
+    public attach(instance: WebAssembly.Exports): void {
+        if (!(instance.__mem instanceof WebAssembly.Memory)) {
+            throw new Error("Needs __mem export");
+        }
+        this.memory = instance.__mem;
+
+        // stdio stops trying __read and __write after they return unsupported, which they do before attaching
+        if (typeof instance.__stdio_attach === "function") instance.__stdio_attach();
+    }
+
     private getFilenames(n = 1): string[] {
         const filenames = this.fileNameBuffer.split('\0');
         if (filenames.pop() !== "" || filenames.length !== n) {
@@ -80,6 +103,39 @@ export class Files {
         return -1;
     }
 
+    private __read(handle: number, ptr: number, len: number): number {
+        if (!this.memory) return -2; // not attached, fall back to __get_char
+
+        const file = this.handleMap.get(handle);
+        if (!file) return -1;
+
+        const dest = new Uint8Array(this.memory.buffer, ptr >>> 0, len >>> 0);
+        if (file.read) return file.read(dest);
+
+        let n = 0;
+        for (; n < dest.length; n++) {
+            const c = file.get();
+            if (c < 0) return n === 0 && c !== -1 ? -1 : n;
+            dest[n] = c;
+        }
+        return n;
+    }
+
+    private __write(handle: number, ptr: number, len: number): number {
+        if (!this.memory) return -2; // not attached, fall back to __put_char
+
+        const file = this.handleMap.get(handle);
+        if (!file) return -1;
+
+        const src = new Uint8Array(this.memory.buffer, ptr >>> 0, len >>> 0);
+        if (file.write) return file.write(src) ? len : -1;
+
+        for (const c of src) {
+            if (!file.put(c)) return -1;
+        }
+        return len;
+    }
+
     private __get_pos(handle: number): bigint {
         return this.handleMap.get(handle)?.pos() ?? -1n;
     }
@@ -137,7 +193,9 @@ export class Files {
     public getImports() {
         return {
             __get_char: this.__get_char.bind(this),
+            __read: this.__read.bind(this),
             __put_char: this.__put_char.bind(this),
+            __write: this.__write.bind(this),
             __get_pos: this.__get_pos.bind(this),
             __get_len: this.__get_len.bind(this),
             __set_pos: this.__set_pos.bind(this),
@@ -147,9 +205,10 @@ export class Files {
         };
     }
 
+    /** Returns a view of the file's contents without copying, which is only valid until the file is next written */
     public getContents(filename: string): Uint8Array | undefined {
         const file = this.handleMap.get(this.nameMap.get(filename) ?? -Infinity);
-        if (file instanceof File) return new Uint8Array(file.bytes);
+        if (file instanceof File) return file.contents;
     }
 
     public delete(filename: string): boolean {
@@ -165,48 +224,77 @@ export class Files {
 export interface FileLike {
     get(): number | -1;
     put(c: number): boolean;
+    /** Optional bulk read into dest, returning the number of bytes read */
+    read?(dest: Uint8Array): number;
+    /** Optional bulk write, src is a view of the instance's memory so must be copied */
+    write?(src: Uint8Array): boolean;
     pos(): bigint;
     len(): bigint;
     set_pos(pos: bigint): boolean;
 }
 
+// contents are stored in a Uint8Array which doubles in size when full
 class File implements FileLike {
-    private _bytes: number[] = [];
-    private _pos = 0n;
+    private _buffer: Uint8Array;
+    private _length: number;
+    private _pos = 0;
+
+    /** Takes ownership of contents without copying it, so the array is modified by writes until the file grows */
+    constructor(contents?: Uint8Array) {
+        this._buffer = contents ?? new Uint8Array(256);
+        this._length = contents?.length ?? 0;
+    }
 
     get(): number | -1 {
-        if (this._pos >= this._bytes.length) return -1;
-        const b = this._bytes[Number(this._pos)];
-        this._pos++;
-        return b;
+        if (this._pos >= this._length) return -1;
+        return this._buffer[this._pos++];
+    }
+
+    read(dest: Uint8Array): number {
+        const n = Math.max(0, Math.min(dest.length, this._length - this._pos));
+        dest.set(this._buffer.subarray(this._pos, this._pos + n));
+        this._pos += n;
+        return n;
     }
 
     put(c: number): boolean {
-        this._bytes[Number(this._pos)] = c;
-        this._pos++;
+        if (this._pos >= this._buffer.length) this.reserve(this._pos + 1);
+        this._buffer[this._pos++] = c;
+        if (this._pos > this._length) this._length = this._pos;
         return true;
     }
 
+    write(src: Uint8Array): boolean {
+        const end = this._pos + src.length;
+        if (end > this._buffer.length) this.reserve(end);
+        this._buffer.set(src, this._pos);
+        this._pos = end;
+        if (end > this._length) this._length = end;
+        return true;
+    }
+
+    private reserve(size: number) {
+        const buffer = new Uint8Array(Math.max(size, this._buffer.length * 2, 256));
+        buffer.set(this._buffer.subarray(0, this._length));
+        this._buffer = buffer;
+    }
+
     pos(): bigint {
-        return this._pos;
+        return BigInt(this._pos);
     }
 
     len(): bigint {
-        return BigInt(this._bytes.length);
+        return BigInt(this._length);
     }
 
     set_pos(pos: bigint): boolean {
-        if (pos < 0 || pos > this._bytes.length) return false;
-        this._pos = pos;
+        if (pos < 0 || pos > this._length) return false;
+        this._pos = Number(pos);
         return true;
     }
 
-    get bytes(): number[] {
-        return this._bytes;
-    }
-
-    set bytes(value: number[]) {
-        this._bytes = value;
-        this._pos = 0n;
+    /** View of the current contents, which is only valid until the file is next written */
+    get contents(): Uint8Array {
+        return this._buffer.subarray(0, this._length);
     }
 }
@@ -0,0 +1,31 @@
+const BUCKETS = 16;
+
+export interface HeapStats {
+    inUse: number;
+    peakInUse: number;
+    freeChunks: number;
+    largestFree: number;
+    heapSize: number;
+    growCalls: number;
+    allocations: number;
+    reallocations: number;
+    frees: number;
+    /** malloc calls by requested size, bucket n is up to 16 << n bytes and the last bucket includes everything larger */
+    sizeBuckets: number[];
+}
+
+/** Read the allocator counters from a module compiled with {ALLOC_STATS: "1"} */
+export function heapStats(instance: WebAssembly.Exports): HeapStats {
+    const {__mem, __heap_stats} = instance;
+    if (typeof __heap_stats !== "function") {
+        throw new Error("Needs __heap_stats export, compile with custom definition ALLOC_STATS");
+    }
+    if (!(__mem instanceof WebAssembly.Memory)) {
+        throw new Error("Needs __mem export");
+    }
+
+    const ptr = (__heap_stats as () => number)();
+    const [inUse, peakInUse, freeChunks, largestFree, heapSize, growCalls, allocations, reallocations, frees, ...sizeBuckets] =
+        new Uint32Array(__mem.buffer, ptr, 9 + BUCKETS);
+    return {inUse, peakInUse, freeChunks, largestFree, heapSize, growCalls, allocations, reallocations, frees, sizeBuckets};
+}
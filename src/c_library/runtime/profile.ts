@@ -0,0 +1,31 @@
+import type {Profile} from "../../generation/profile";
+
+/** Read the execution counters from a module compiled with {instrument: true} */
+export function dumpProfile(instance: WebAssembly.Exports): Profile {
+    const {__mem, __profile_counters, __profile_layout} = instance;
+    if (!(__profile_counters instanceof WebAssembly.Global) || !(__profile_layout instanceof WebAssembly.Global)) {
+        throw new Error("Needs __profile_counters and __profile_layout global exports, compile with {instrument: true}");
+    }
+    if (!(__mem instanceof WebAssembly.Memory)) {
+        throw new Error("Needs __mem export");
+    }
+
+    const bytes = new Uint8Array(__mem.buffer);
+    const layoutAddr = __profile_layout.value as number;
+    const names = JSON.parse(new TextDecoder().decode(bytes.subarray(layoutAddr, bytes.indexOf(0, layoutAddr)))) as string[];
+    const counters = new BigUint64Array(__mem.buffer, __profile_counters.value as number, names.length);
+
+    const profile: Profile = {functions: {}, branches: {}};
+    for (const [i, name] of names.entries()) {
+        // branch counters end in ":n", function names may also contain ":" through the file of a static function
+        const count = Number(counters[i]), separator = name.lastIndexOf(":");
+        if (separator < 0 || !/^\d+$/.test(name.slice(separator + 1))) {
+            profile.functions[name] = (profile.functions[name] ?? 0) + count;
+        } else {
+            const fnName = name.slice(0, separator), index = Number(name.slice(separator + 1));
+            const branches = profile.branches[fnName] ??= [];
+            branches[index] = (branches[index] ?? 0) + count;
+        }
+    }
+    return profile;
+}
@@ -0,0 +1,14 @@
+// must match CLOCK_REALTIME in time.h
+const CLOCK_REALTIME = 0;
+
+/** Imports for time.h: __time for clock() in milliseconds, and __clock_ns for clock_gettime, time and
+ * __c2wasm_now_ns. The monotonic clock uses process.hrtime in node, otherwise performance.now() */
+export function timeImports(): {__time: () => number, __clock_ns: (clockId: number) => bigint} {
+    const monotonic = typeof process !== "undefined" && process.hrtime?.bigint
+        ? () => process.hrtime.bigint()
+        : () => BigInt(Math.round(performance.now() * 1e6));
+    return {
+        __time: () => performance.now(),
+        __clock_ns: (clockId: number) => clockId === CLOCK_REALTIME ? BigInt(Date.now()) * 1000000n : monotonic()
+    };
+}
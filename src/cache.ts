@@ -0,0 +1,71 @@
+import fs from "fs";
+import {createHash} from "crypto";
+import {id as buildId} from "./_build_id.json";
+import {compile} from "./compile";
+import type {CompileOptions} from "./generation/profile";
+import {getFlags} from "./optimisation/flags";
+import {CompiledModule} from "./wasm";
+
+// modules kept in memory, least recently used first
+const MEMORY_ENTRIES = 64;
+const memoryCache = new Map<string, CompiledModule>();
+
+/**
+ * Compiles like compile(), but reuses the result for identical inputs: the sources, custom definitions, options,
+ * optimisation flags and compiler build (a hash of its sources). Modules are kept in memory, and in cacheDir when given
+ * (node only), so repeated calls skip the whole pipeline and the engine compiles each module once per process.
+ */
+export function compileCached(files: ReadonlyMap<string, string> | string,
+                              customDefinitions?: {[key: string]: string},
+                              options?: CompileOptions,
+                              cacheDir?: string): CompiledModule {
+    const key = cacheKey(files, customDefinitions, options);
+
+    let module = memoryCache.get(key);
+    if (module) {
+        memoryCache.delete(key);
+    } else {
+        let bytes: Uint8Array | undefined;
+        let fileName: string | undefined;
+        if (cacheDir !== undefined) {
+            // crypto is only used for the disk cache, as it isn't available in browsers
+            fileName = createHash("sha256").update(key).digest("hex");
+            bytes = readCache(cacheDir, fileName);
+        }
+        if (bytes === undefined) {
+            bytes = compile(files, customDefinitions, options).toBytes();
+            if (cacheDir !== undefined && fileName !== undefined) writeCache(cacheDir, fileName, bytes);
+        }
+        module = new CompiledModule(bytes);
+
+        if (memoryCache.size >= MEMORY_ENTRIES) memoryCache.delete(memoryCache.keys().next().value);
+    }
+    memoryCache.set(key, module);
+    return module;
+}
+
+// the inputs as a string, which is used directly as the memory cache key
+function cacheKey(files: ReadonlyMap<string, string> | string, customDefinitions?: {[key: string]: string},
+                  options?: CompileOptions): string {
+    const sources = typeof files === "string"
+        ? [["main.c", files]]
+        : [...files.entries()].sort((a, b) => a[0] < b[0] ? -1 : 1);
+    const definitions = Object.entries(customDefinitions ?? {}).sort();
+    return JSON.stringify([buildId, getFlags(), sources, definitions, options ?? {}]);
+}
+
+function readCache(cacheDir: string, fileName: string): Uint8Array | undefined {
+    try {
+        return fs.readFileSync(`${cacheDir}/${fileName}.wasm`);
+    } catch {
+        return undefined;
+    }
+}
+
+function writeCache(cacheDir: string, fileName: string, bytes: Uint8Array): void {
+    // write then rename, so other processes never read a partial file
+    fs.mkdirSync(cacheDir, {recursive: true});
+    const tmp = `${cacheDir}/${fileName}.${process.pid}.tmp`;
+    fs.writeFileSync(tmp, bytes);
+    fs.renameSync(tmp, `${cacheDir}/${fileName}.wasm`);
+}
@@ -1,24 +1,42 @@
 import {STANDARD_LIBRARY} from "./c_library/standard_library";
 import {WGenerator} from "./generation";
+import type {CompileOptions} from "./generation/profile";
 import {Linker} from "./linker";
 import {ModuleBuilder} from "./wasm";
 
 export function compile(files: ReadonlyMap<string, string> | string,
-                        customDefinitions?: {[key: string]: string}): ModuleBuilder {
+                        customDefinitions?: {[key: string]: string},
+                        options?: CompileOptions): ModuleBuilder {
     if (typeof files === "string") {
         const f = new Map<string, string>();
         f.set("main.c", files);
         files = f;
     }
 
+    // library functions aren't exported, so add wrappers for the ones used by the runtime helpers
+    const runtimeExports = Object.entries(RUNTIME_EXPORTS).filter(([name]) => customDefinitions?.[name] !== undefined);
+    if (runtimeExports.length > 0) {
+        const f = new Map(files);
+        for (const [name, source] of runtimeExports) f.set(`__runtime_${name.toLowerCase()}.c`, source);
+        files = f;
+    }
+
     // "linker" also calls preprocessor, lexer, parser and pt transformation into IR
     const linker = new Linker(files, true, customDefinitions);
     linker.link(stdLibrary(customDefinitions));
 
-    const generator = new WGenerator(linker);
+    const generator = new WGenerator(linker, options);
     return generator.module;
 }
 
+// wrappers added when the custom definition is set
+const RUNTIME_EXPORTS: {[name: string]: string} = {
+    // runtime.heapStats
+    ALLOC_STATS: "#include <stdlib.h>\nconst struct heap_stats* __heap_stats(void) { return heap_stats(); }\n",
+    // runtime.mainWrapper flushes stdio buffers after main returns, and runtime.Files.attach enables __read and __write
+    FILES: "#include <stdio.h>\nvoid __stdio_flush(void) { fflush(NULL); }\nvoid __stdio_attach(void) { __stdio_attached(); }\n"
+};
+
 /** No access to standard library! */
 export function compileSnippet(source: string): ModuleBuilder {
     const fileMap = new Map<string, string>();
@@ -4,12 +4,12 @@ import {CIdentifier} from "../ir/expressions";
 import * as c from "../ir/expressions";
 import {evalExpression} from "../ir/transform/constant_expressions";
 import {CType, CArithmetic, CPointer, CArray, CSizeT, CUnion, CStruct, CFuncType, integerPromotion} from "../ir/types";
-import {i32Type, Instructions, i64Type, f32Type, f64Type, ValueType} from "../wasm";
+import {i32Type, Instructions, i64Type, f32Type, f64Type, v128Type, ValueType} from "../wasm";
 import {WInstruction} from "../wasm/instructions";
 import {GenError} from "./gen_error";
 import {WFnGenerator} from "./generator";
-import {storageGet, storageSet, storageUpdate, storageGetThenUpdate, getAddress} from "./storage";
-import {ImplementationType, implType, conversion, valueType, realType, largeReturn, returnType} from "./type_conversion";
+import {storageGet, storageSet, storageUpdate, storageGetThenUpdate, getAddress, loadScalarMembers, storeScalarMembers} from "./storage";
+import {ImplementationType, implType, conversion, valueType, realType, largeReturn, returnType, scalarMembers, ScalarMember} from "./type_conversion";
 import {internalFunctions} from "./wasm_functions";
 
 function constant(ctx: WFnGenerator, e: c.CConstant, discard: boolean): WInstruction[] {
@@ -42,16 +42,19 @@ function stringLiteral(ctx: WFnGenerator, e: c.CStringLiteral, discard: boolean)
  * If any argument (or function pointer) is varadic then it will try to manipulate the same region so need to call all
  * child expressions before storing. This means pushing everything onto the stack in the right order.
  * - evaluate normal function arguments
- * - (allocate space for large return struct/union, push as hidden extra argument)
+ * - (allocate space for returned struct/union, push as hidden extra argument if a large return)
  * - (evaluate indirect function id)
  * - (evaluate variadic arguments)
  * - (store variadic arguments)
  * - increment shadow stack pointer
  * - call function (and cleanup)
  * - decrement shadow stack pointer
- * - (push large return ptr)
+ * - (store struct returned as multiple values, unless memberValues is set)
+ * - (push return struct/union ptr)
+ *
+ * If memberValues is set, a struct returned as multiple values is left on the stack as those values.
  */
-function functionCall(ctx: WFnGenerator, e: c.CFunctionCall, discard: boolean): WInstruction[] {
+function functionCall(ctx: WFnGenerator, e: c.CFunctionCall, discard: boolean, memberValues = false): WInstruction[] {
     const indirectValue: WInstruction[] = [];
     if (e.body instanceof c.CIdentifier && (e.body.value instanceof CFuncDefinition || e.body.value instanceof CFuncDeclaration)) {
         // normal function call
@@ -68,10 +71,18 @@ function functionCall(ctx: WFnGenerator, e: c.CFunctionCall, discard: boolean):
         return internalExpression;
     }
 
-    const instr = e.fnType.parameterTypes.flatMap((t, i) => subExpr(ctx, e.args[i], t));
+    const instr = e.fnType.parameterTypes.flatMap((t, i) => {
+        const paramMembers = scalarMembers(t);
+        if (paramMembers) {
+            // struct passed as a separate argument per member
+            return scalarMemberValues(ctx, e.args[i], t, paramMembers);
+        }
+        return subExpr(ctx, e.args[i], t);
+    });
 
+    const members = scalarMembers(e.fnType.returnType);
     let largeReturnPtr: WInstruction[] | undefined;
-    if (largeReturn(e.fnType.returnType)) {
+    if (largeReturn(e.fnType.returnType) || (members && !discard && !memberValues)) {
         largeReturnPtr = [ // address allocated for storing return value
             Instructions.global.get(ctx.gen.shadowStackPtr),
             Instructions.i32.const(ctx.shadowStackUsage),
@@ -80,7 +91,7 @@ function functionCall(ctx: WFnGenerator, e: c.CFunctionCall, discard: boolean):
         // allocate space for return value
         ctx.shadowStackUsage += 4 * Math.ceil(e.fnType.returnType.bytes / 4);
         // push pointer onto stack as hidden argument
-        instr.push(...largeReturnPtr);
+        if (!members) instr.push(...largeReturnPtr);
     }
 
     if (indirectValue.length > 0) {
@@ -128,9 +139,9 @@ function functionCall(ctx: WFnGenerator, e: c.CFunctionCall, discard: boolean):
         instr.push(Instructions.call(ctx.gen.functionIndex(fn)));
     }
 
-    if (discard && returnType(e.fnType.returnType).length) {
-        // cleanup return value if needed
-        instr.push(Instructions.drop());
+    if (discard) {
+        // cleanup return values if needed
+        for (let i = returnType(e.fnType.returnType).length; i > 0; i--) instr.push(Instructions.drop());
     }
     if (shadowUsage > 0) {
         // restore shadow stack pointer
@@ -140,12 +151,31 @@ function functionCall(ctx: WFnGenerator, e: c.CFunctionCall, discard: boolean):
             Instructions.global.set(ctx.gen.shadowStackPtr));
     }
     if (!discard && largeReturnPtr) {
+        // struct returned as multiple values, which are stored so the struct can be used like any other
+        if (members) instr.push(...storeScalarMembers(ctx, members, largeReturnPtr));
         // return value is the struct/union returned via the largeReturnPtr
         instr.push(...largeReturnPtr);
     }
     return instr;
 }
 
+/** The call if e is a direct call which returns a struct as multiple values, ignoring casts to the same struct */
+function scalarMembersCall(e: c.CExpression): c.CFunctionCall | undefined {
+    while (e instanceof c.CCast && e.type instanceof CStruct && e.type.equals(e.body.type)) e = e.body;
+    if (e instanceof c.CFunctionCall && scalarMembers(e.fnType.returnType)) return e;
+    return undefined;
+}
+
+/**
+ * Pushes each member of a struct which is passed or returned as multiple values. Calls returning the struct as multiple
+ * values are used directly, so the struct is only loaded from memory when it already has an address.
+ */
+export function scalarMemberValues(ctx: WFnGenerator, e: c.CExpression, type: CType, members: ScalarMember[]): WInstruction[] {
+    const call = scalarMembersCall(e);
+    if (call) return functionCall(ctx, call, false, true);
+    return [...subExpr(ctx, e, type), ...loadScalarMembers(ctx, members)];
+}
+
 function memberAccess(ctx: WFnGenerator, e: c.CMemberAccess, discard: boolean): WInstruction[] {
     if (discard) return expressionGeneration(ctx, e.body, true);
 
@@ -435,6 +465,17 @@ function assignment(ctx: WFnGenerator, e: c.CAssignment, discard: boolean): WIns
         if (!discard) instr.push(...expressionGeneration(ctx, e.lhs, false));
         return instr;
     } else {
+        const members = scalarMembers(e.lhs.type);
+        const call = scalarMembersCall(e.rhs);
+        if (discard && members && call) {
+            // store each returned value directly, instead of copying from a temporary struct
+            return ctx.withTemporaryLocal(i32Type, addr => [
+                ...getAddress(ctx, e.lhs),
+                Instructions.local.set(addr),
+                ...functionCall(ctx, call, false, true),
+                ...storeScalarMembers(ctx, members, [Instructions.local.get(addr)])
+            ]);
+        }
         return storageSet(ctx, e.lhs.type, e.lhs, e.rhs, !discard);
     }
 }
@@ -545,6 +586,9 @@ export function gInstr(t: ImplementationType, op: (keyof typeof Instructions.i32
     } else if (t === f64Type) {
         // @ts-ignore
         return Instructions.f64[op](...args);
+    } else if (t === v128Type && (op === "const" || op === "load" || op === "store")) {
+        // @ts-ignore
+        return Instructions.v128[op](...args);
     }
     throw new Error("Invalid value type?");
 }
@@ -4,7 +4,7 @@ import {getFlags} from "../optimisation/flags";
 import {CFuncDefinition, CFuncDeclaration} from "../ir/declarations";
 import type {CExpression} from "../ir/expressions";
 import type {CStatement} from "../ir/statements";
-import {CArithmetic, CFuncType, CPointer} from "../ir/types";
+import {CArithmetic, CFuncType, CPointer, CVector} from "../ir/types";
 import {ModuleBuilder, WFunctionBuilder, WFunction, Instructions, WImportedFunction, ValueType, i32Type} from "../wasm";
 import type {funcidx, tableidx, typeidx} from "../wasm/base_types";
 import type {WLocal} from "../wasm/functions";
@@ -13,9 +13,11 @@ import type {WInstruction} from "../wasm/instructions";
 import {FunctionType} from "../wasm/wtypes";
 import {expressionGeneration} from "./expressions";
 import {GenError} from "./gen_error";
+import {preinitialise} from "./preinitialise";
+import {CompileOptions, Profiler, profileName} from "./profile";
 import {statementGeneration} from "./statements";
 import {storageSetupStaticVar} from "./storage";
-import {realType, returnType, largeReturn} from "./type_conversion";
+import {parameterType, returnType, largeReturn} from "./type_conversion";
 
 export const SHADOW_STACK_SIZE = 2 ** 20;
 export const FIRST_STATIC_ADDR = 32; // reserve first 32 bytes as 0
@@ -23,13 +25,15 @@ export const FIRST_STATIC_ADDR = 32; // reserve first 32 bytes as 0
 export class WGenerator {
     readonly module: ModuleBuilder;
     readonly functions = new Map<CFuncDefinition | CFuncDeclaration, WFunction | WImportedFunction>();
+    readonly profiler: Profiler;
 
     // current memory pointers
     nextStaticAddr = FIRST_STATIC_ADDR;
     _shadowStackPtr?: WGlobal;
 
-    constructor(linker: Linker) {
+    constructor(linker: Linker, options: CompileOptions = {}) {
         this.module = new ModuleBuilder();
+        this.profiler = new Profiler(this, options.instrument ?? false, options.profile);
 
         const staticInitializers = [];
         for (const variable of linker.emitVariables) {
@@ -54,6 +58,7 @@ export class WGenerator {
         interproceduralOptimise(this.module);
 
         this.module.emitCallback = () => {
+            this.profiler.emit();
             const staticSize = Math.ceil(this.nextStaticAddr / 1024) * 1024;
             if (this._shadowStackPtr) {
                 const shadowStackStart = staticSize + 1024; // between 1024-2047 byte buffer
@@ -63,6 +68,8 @@ export class WGenerator {
                 this.module.setupMemory(Math.ceil(staticSize / 65536));
             }
         };
+
+        if (options.initialise !== undefined) preinitialise(this.module, options.initialise);
     }
 
     get shadowStackPtr(): WGlobal {
@@ -99,6 +106,10 @@ export class WGenerator {
             // would be hard to correctly call, so don't export
             name = undefined;
         }
+        if ([func.type.returnType, ...func.type.parameterTypes].some(t => t instanceof CVector)) {
+            // v128 values can't be passed to or from JavaScript
+            name = undefined;
+        }
         if (name && !func.type.parameterTypes.every(t => t instanceof CArithmetic)) {
             // ensure ssp is included for argument passing when exported unless arguments are all numbers
             this.shadowStackPtr;
@@ -106,12 +117,13 @@ export class WGenerator {
 
         const wasmFunc = this.module.function(...WGenerator.funcType(func.type), undefined, name);
         wasmFunc.hints.inline = func.hints.inline;
+        wasmFunc.hints.profile = this.profiler.hint(profileName(func));
         this.functions.set(func, wasmFunc);
     }
 
     private functionBody(s: CFuncDefinition, b: WFunctionBuilder): WInstruction[] {
-        const fnGenerator = new WFnGenerator(this, b, s.name);
-        const body = fnGenerator.statement(s.body);
+        const fnGenerator = new WFnGenerator(this, b, s.name, profileName(s));
+        const body = [...this.profiler.counter(fnGenerator.profileName), ...fnGenerator.statement(s.body)];
 
         if (fnGenerator.shadowStackUsage > 0 && getFlags().generation_zero_shadow_stack) {
             // use memory.fill to ensure shadow stack space is 0 before fn runs
@@ -128,7 +140,7 @@ export class WGenerator {
 
     private importFunction(func: CFuncDeclaration) {
         const wasmFunc = this.module.importFunction(
-            func.type.parameterTypes.map(realType),
+            func.type.parameterTypes.flatMap(parameterType),
             returnType(func.type.returnType),
             "c2wasm",
             func.name);
@@ -148,7 +160,7 @@ export class WGenerator {
     }
 
     private static funcType(fnType: CFuncType): FunctionType {
-        const paramTypes = fnType.parameterTypes.map(realType);
+        const paramTypes = fnType.parameterTypes.flatMap(parameterType);
         if (largeReturn(fnType.returnType)) {
             paramTypes.push(i32Type); // add additional argument for large return pointer
         }
@@ -171,8 +183,10 @@ export class WGenerator {
 
 export class WFnGenerator {
     shadowStackUsage: number = 0;
+    private branches: number = 0;
 
-    constructor(readonly gen: WGenerator, readonly builder: WFunctionBuilder, readonly fnName: string) {
+    constructor(readonly gen: WGenerator, readonly builder: WFunctionBuilder, readonly fnName: string,
+                readonly profileName: string = fnName) {
     }
 
     statement(s: CStatement): WInstruction[] {
@@ -183,6 +197,16 @@ export class WFnGenerator {
         return expressionGeneration(this, e, discardResult);
     }
 
+    // next branch counter in this function, returning the instructions to increment it (when instrumenting) and the
+    // count from the profile if one was provided
+    profileBranch(): [instr: WInstruction[], count: number | undefined] {
+        const index = this.branches++;
+        return [
+            this.gen.profiler.counter(`${this.profileName}:${index}`),
+            this.gen.profiler.branchCount(this.profileName, index)
+        ];
+    }
+
     withTemporaryLocal<T>(type: ValueType, expressionFn: (local: WLocal) => T): T {
         const local = this.builder.getTempLocal(type);
         const expression = expressionFn(local);
@@ -0,0 +1,70 @@
+import {removeUnusedFns} from "../optimisation/interprocedural/functions";
+import type {ModuleBuilder} from "../wasm";
+
+// zero runs at least this long split the snapshot into separate data segments. shorter gaps cost less than the
+// overhead of a new segment, and are merged again by _encodeDataSegments anyway
+const MIN_ZERO_RUN = 16;
+
+/**
+ * Runs the exported init function at compile time, like Wizer, and replaces the module's data segments and global
+ * initial values with the resulting state. init is then no longer exported, as running it again would repeat its
+ * effects on the snapshot, and it's removed along with any functions only it used unless other functions call it.
+ * init must not take arguments, return a value or call imports, as their effects couldn't be part of the snapshot.
+ * Node only, as the module is compiled synchronously and browsers limit that to small modules.
+ */
+export function preinitialise(module: ModuleBuilder, initExport: string): void {
+    if (typeof process === "undefined" || !process.versions?.node) {
+        throw new Error("Pre-initialisation is only supported in node");
+    }
+    const init = module.functions.find(fn => fn.exportName === initExport);
+    if (!init) throw new Error(`No exported function '${initExport}' to pre-initialise with`);
+    if (init.type[0].length > 0 || init.type[1].length > 0) {
+        throw new Error(`Pre-initialisation function '${initExport}' can't take arguments or return a value`);
+    }
+    for (const g of module.globals) {
+        if (g.mutable && g.exportName === undefined) {
+            throw new Error("Can't snapshot mutable globals which aren't exported");
+        }
+    }
+
+    const imports: {[module: string]: {[name: string]: () => never}} = {};
+    for (const fn of module.functionImports) {
+        (imports[fn.module] ??= {})[fn.name] = () => {
+            throw new Error(`Pre-initialisation function '${initExport}' called import '${fn.name}'`);
+        };
+    }
+
+    // instantiating runs the start function too, so its effects are also part of the snapshot
+    const instance = new WebAssembly.Instance(new WebAssembly.Module(module.toBytes()), imports);
+    (instance.exports[initExport] as () => void)();
+
+    // encoding sets up memory and the shadow stack pointer, which are now part of the snapshot
+    module.emitCallback = undefined;
+    module.startFunction = undefined;
+
+    const {__mem} = instance.exports;
+    if (__mem instanceof WebAssembly.Memory) {
+        const memory = new Uint8Array(__mem.buffer);
+        module.setupMemory(memory.length / 65536);
+        module._clearDataSegments();
+
+        for (let start = 0; ;) {
+            while (start < memory.length && memory[start] === 0) start++;
+            if (start === memory.length) break;
+
+            // dataSegment trims the zeros from the end of the chunk
+            let end = start, zeros = 0;
+            while (end < memory.length && zeros < MIN_ZERO_RUN) zeros = memory[end++] === 0 ? zeros + 1 : 0;
+            module.dataSegment(start, Array.from(memory.subarray(start, end)));
+            start = end;
+        }
+    }
+
+    for (const g of module.globals) {
+        if (g.mutable) g.initialValue = (instance.exports[g.exportName as string] as WebAssembly.Global).value;
+    }
+
+    init.exportName = undefined;
+    removeUnusedFns(module);
+    module.changed();
+}
@@ -0,0 +1,106 @@
+import type {CFuncDefinition} from "../ir/declarations";
+import {Instructions, i32Type} from "../wasm";
+import type {WGlobal} from "../wasm/global";
+import type {WInstruction} from "../wasm/instructions";
+import type {WGenerator} from "./generator";
+
+/**
+ * Execution counts collected from an instrumented module, keyed by profileName. Branch counters are numbered in the
+ * order they are generated within each function, so a profile is only valid for the same source code.
+ */
+export interface Profile {
+    functions: {[name: string]: number};
+    branches: {[name: string]: number[]};
+}
+
+export type CompileOptions = {
+    /** Add execution counters to every function and branch, see runtime.dumpProfile */
+    instrument?: boolean;
+    /** Profile from a previous instrumented run */
+    profile?: Profile;
+    /** Exported function run at compile time, with the resulting memory and globals becoming the initial state */
+    initialise?: string;
+};
+
+// functions with fewer calls than this fraction of the most called function aren't considered hot
+const HOT_FRACTION = 0.01;
+
+/** Name of fn's counters in a profile. Static functions in different files can share a name, so they're qualified
+ * with their file, e.g. "helper@util.c" */
+export function profileName(fn: CFuncDefinition): string {
+    return fn.linkage === "internal" && fn.translationUnit.file !== undefined
+        ? `${fn.name}@${fn.translationUnit.file}`
+        : fn.name;
+}
+
+export class Profiler {
+    // "name" for function counters, "name:n" for branch counters
+    readonly counterNames: string[] = [];
+    private _counters?: WGlobal;
+    private _layout?: WGlobal;
+    private addresses?: [counters: number, layout: number];
+    private readonly maxCount: number;
+
+    constructor(readonly gen: WGenerator, readonly instrument: boolean, readonly profile?: Profile) {
+        this.maxCount = Math.max(0, ...Object.values(profile?.functions ?? {}));
+    }
+
+    functionCount(name: string): number | undefined {
+        if (!this.profile) return undefined;
+        return this.profile.functions[name] ?? 0;
+    }
+
+    branchCount(name: string, index: number): number | undefined {
+        if (!this.profile) return undefined;
+        return this.profile.branches[name]?.[index] ?? 0;
+    }
+
+    hint(name: string): "hot" | "cold" | undefined {
+        const count = this.functionCount(name);
+        if (count === undefined) return undefined;
+        if (count === 0) return "cold";
+        return count >= this.maxCount * HOT_FRACTION ? "hot" : undefined;
+    }
+
+    /** Instructions to increment a new counter */
+    counter(name: string): WInstruction[] {
+        if (!this.instrument) return [];
+
+        const offset = this.counterNames.push(name) * 8 - 8;
+        return [
+            Instructions.global.get(this.counters),
+            Instructions.global.get(this.counters),
+            Instructions.i64.load(3, offset),
+            Instructions.i64.const(1n),
+            Instructions.i64.add(),
+            Instructions.i64.store(3, offset)
+        ];
+    }
+
+    private get counters(): WGlobal {
+        if (!this._counters) {
+            this._counters = this.gen.module.global(i32Type, false, 0n, "__profile_counters");
+            this._layout = this.gen.module.global(i32Type, false, 0n, "__profile_layout");
+        }
+        return this._counters;
+    }
+
+    /** Allocate static memory for the counters and a null terminated JSON list of their names. Called on every encode,
+     * so the memory is only allocated the first time */
+    emit(): void {
+        if (!this._counters || !this._layout) return;
+
+        if (this.addresses === undefined) {
+            const countersAddr = Math.ceil(this.gen.nextStaticAddr / 8) * 8;
+            const layoutAddr = countersAddr + this.counterNames.length * 8;
+            const layout = [...new TextEncoder().encode(JSON.stringify(this.counterNames)), 0];
+
+            this.gen.module.dataSegment(layoutAddr, layout);
+            this.gen.nextStaticAddr = layoutAddr + layout.length;
+            this.addresses = [countersAddr, layoutAddr];
+        }
+
+        this._counters.initialValue = BigInt(this.addresses[0]);
+        this._layout.initialValue = BigInt(this.addresses[1]);
+    }
+}
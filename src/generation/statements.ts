@@ -5,11 +5,12 @@ import {CArithmetic, CPointer} from "../ir/types";
 import {Instructions, i32Type, i64Type} from "../wasm";
 import {labelidx} from "../wasm/base_types";
 import {WInstruction} from "../wasm/instructions";
-import {subExpr, condition, expressionGeneration, gInstr} from "./expressions";
+import {subExpr, condition, expressionGeneration, gInstr, scalarMemberValues} from "./expressions";
 import {GenError} from "./gen_error";
 import {WFnGenerator} from "./generator";
 import {storageSetupScope, memcpy} from "./storage";
-import {valueType, largeReturn} from "./type_conversion";
+import {valueType, largeReturn, scalarMembers} from "./type_conversion";
+import {vectorizeLoop} from "./vectorize";
 
 function _compoundStatement(ctx: WFnGenerator, s: c.CCompoundStatement): WInstruction[] {
     const [instr, finishCallback] = storageSetupScope(ctx, s.scope);
@@ -47,8 +48,12 @@ function _nop(ctx: WFnGenerator, s: c.CNop): WInstruction[] {
 }
 
 function _if(ctx: WFnGenerator, s: c.CIf): WInstruction[] {
+    const [ifCounter] = ctx.profileBranch(), [elseCounter] = ctx.profileBranch();
     const ifBody = s.ifBody === undefined ? [Instructions.nop()] : statementGeneration(ctx, s.ifBody);
-    const elseBody = s.elseBody === undefined ? undefined : statementGeneration(ctx, s.elseBody);
+    let elseBody = s.elseBody === undefined ? undefined : statementGeneration(ctx, s.elseBody);
+
+    ifBody.unshift(...ifCounter);
+    if (elseCounter.length) elseBody = [...elseCounter, ...elseBody ?? []];
 
     return [...condition(ctx, s.test), Instructions.if(null, ifBody, elseBody)];
 }
@@ -72,7 +77,8 @@ function _forLoop(ctx: WFnGenerator, s: c.CForLoop): WInstruction[] {
     let update: WInstruction[] = [];
     if (s.update !== undefined) update = ctx.expression(s.update, true);
 
-    instr.push(...init,
+    // when vectorized, the scalar loop handles any remaining iterations
+    instr.push(...init, ...vectorizeLoop(ctx, s),
         Instructions.loop(null, [
             ...test,
             Instructions.if(null, [
@@ -121,6 +127,9 @@ function _switch(ctx: WFnGenerator, s: c.CSwitch): WInstruction[] {
             Instructions.local.set(value)
         ];
 
+        // counter for each case body
+        const profile = s.children.map(() => ctx.profileBranch());
+
         let defaultIndex = s.children.findIndex(x => x.default);
         if (defaultIndex === -1) defaultIndex = s.children.length;
 
@@ -156,9 +165,11 @@ function _switch(ctx: WFnGenerator, s: c.CSwitch): WInstruction[] {
             checks.push(Instructions.br_table(defaultIndex, table));
 
         } else {
-            // use manual jump table
-            for (const [depth, child] of s.children.entries()) {
-                for (const sCase of child.cases) {
+            // use manual jump table, checking the most frequent cases first if there is a profile
+            const order = [...s.children.keys()];
+            order.sort((a, b) => (profile[b][1] ?? 0) - (profile[a][1] ?? 0));
+            for (const depth of order) {
+                for (const sCase of s.children[depth].cases) {
                     if (sCase.type instanceof CPointer) throw new GenError("Invalid switch case", ctx, s.node);
                     const constant = new CConstant(s.node, sCase.type, sCase.value);
                     checks.push(Instructions.local.get(value), ...subExpr(ctx, constant, s.expression.type), gInstr(type, "eq"));
@@ -174,6 +185,7 @@ function _switch(ctx: WFnGenerator, s: c.CSwitch): WInstruction[] {
         for (let i = 0; i < s.children.length; i++) {
             block = Instructions.block(null, [
                 block,
+                ...profile[i][0],
                 ...ctx.statement(s.children[i].body)
             ], i === s.children.length - 1 ? storeBreakDepth(s) : undefined); // final case body is also break target
         }
@@ -225,9 +237,15 @@ function _return(ctx: WFnGenerator, s: c.CReturn): WInstruction[] {
         // copy return value to large return parameter (the last parameter)
         return [...memcpy(
             subExpr(ctx, s.value, s.func.type.returnType),
-            [Instructions.local.get(s.func.type.parameterTypes.length)],
+            [Instructions.local.get(ctx.builder.args[ctx.builder.args.length - 1])],
             s.value.type.bytes),
         Instructions.return()];
+    }
+
+    const members = scalarMembers(s.func.type.returnType);
+    if (members) {
+        // return each member of the struct as a separate value
+        return [...scalarMemberValues(ctx, s.value, s.func.type.returnType, members), Instructions.return()];
     } else {
         return [...subExpr(ctx, s.value, s.func.type.returnType), Instructions.return()];
     }
@@ -2,7 +2,7 @@ import {CArgument, CDeclaration, CVarDefinition, CVarDeclaration} from "../ir/de
 import {CExpression} from "../ir/expressions";
 import * as e from "../ir/expressions";
 import {Scope} from "../ir/scope";
-import {CType, CArithmetic, CPointer, CStruct, CUnion, CArray, CVoid, CFuncType} from "../ir/types";
+import {CType, CArithmetic, CPointer, CStruct, CUnion, CArray, CVoid, CFuncType, CVector} from "../ir/types";
 import {Instructions, i32Type} from "../wasm";
 import {localidx} from "../wasm/base_types";
 import {WLocal} from "../wasm/functions";
@@ -10,7 +10,7 @@ import {WInstruction} from "../wasm/instructions";
 import {GenError} from "./gen_error";
 import {WFnGenerator, WGenerator} from "./generator";
 import {staticInitializer} from "./static_initializer";
-import {realType, conversion} from "./type_conversion";
+import {realType, conversion, parameterType, scalarMembers, ScalarMember} from "./type_conversion";
 
 export type StorageLocation =
     {type: "local", "index": {getIndex(d: number): localidx}} |
@@ -42,7 +42,30 @@ export function storageSetupScope(ctx: WFnGenerator, s: Scope): [setup: WInstruc
 
     for (const declaration of s.declarations) {
         if (declaration instanceof CArgument) {
-            if (declaration.type instanceof CStruct || declaration.type instanceof CUnion) {
+            // index of the first wasm argument, as some arguments are passed as multiple values
+            const argIndex = s.func?.type.parameterTypes.slice(0, declaration.index)
+                .reduce((total, t) => total + parameterType(t).length, 0) ?? declaration.index;
+            const members = scalarMembers(declaration.type);
+
+            if (members && !declaration.addressUsed) {
+                // only members are accessed, so each member stays in the argument it was passed in
+                setMemberLocals(declaration, members.map((_, i) => ctx.builder.args[argIndex + i]));
+
+            } else if (members) {
+                // reassemble the struct on the shadow stack from the members
+                ctx.shadowStackUsage = Math.ceil(ctx.shadowStackUsage / declaration.type.alignment) * declaration.type.alignment;
+                setStorageLocation(declaration, {
+                    type: "shadow",
+                    shadowOffset: ctx.shadowStackUsage
+                });
+                members.forEach((m, i) => instr.push(
+                    Instructions.global.get(ctx.gen.shadowStackPtr),
+                    Instructions.local.get(ctx.builder.args[argIndex + i]),
+                    store(m.type, ctx.shadowStackUsage + m.offset)));
+
+                ctx.shadowStackUsage += declaration.type.bytes;
+
+            } else if (declaration.type instanceof CStruct || declaration.type instanceof CUnion) {
                 // argument is effectively a pointer to a struct/union to copy
 
                 // align
@@ -54,7 +77,7 @@ export function storageSetupScope(ctx: WFnGenerator, s: Scope): [setup: WInstruc
                 });
                 // copy from given pointer
                 instr.push(...memcpy(
-                    [Instructions.local.get(ctx.builder.args[declaration.index])],
+                    [Instructions.local.get(ctx.builder.args[argIndex])],
                     [Instructions.global.get(ctx.gen.shadowStackPtr), Instructions.i32.const(ctx.shadowStackUsage), Instructions.i32.add()],
                     declaration.type.bytes
                 ));
@@ -68,21 +91,21 @@ export function storageSetupScope(ctx: WFnGenerator, s: Scope): [setup: WInstruc
                 });
                 // copy value onto shadow stack
                 instr.push(Instructions.global.get(ctx.gen.shadowStackPtr));
-                instr.push(Instructions.local.get(ctx.builder.args[declaration.index]));
+                instr.push(Instructions.local.get(ctx.builder.args[argIndex]));
                 instr.push(store(declaration.type, ctx.shadowStackUsage));
 
                 ctx.shadowStackUsage += declaration.type.bytes; // 4 byte align
             } else {
                 setStorageLocation(declaration, {
                     type: "local",
-                    index: ctx.builder.args[declaration.index]
+                    index: ctx.builder.args[argIndex]
                 });
             }
         }
 
         if (declaration instanceof CVarDefinition) {
             if (declaration.storage === "local") {
-                if (declaration.addressUsed || !(declaration.type instanceof CArithmetic || declaration.type instanceof CPointer)) {
+                if (declaration.addressUsed || !(declaration.type instanceof CArithmetic || declaration.type instanceof CPointer || declaration.type instanceof CVector)) {
                     // have to place on shadow stack
                     ctx.shadowStackUsage = Math.ceil(ctx.shadowStackUsage / declaration.type.alignment) * declaration.type.alignment;
                     setStorageLocation(declaration, {
@@ -323,6 +346,13 @@ function fromExpression(ctx: WFnGenerator, s: e.CExpression): [WInstruction[], S
         }
 
     } else if (s instanceof e.CMemberAccess) {
+        if (s.body instanceof e.CAddressOf && s.body.body instanceof e.CIdentifier) {
+            // member of a struct argument passed as separate values
+            const locals = getMemberLocals(s.body.body.value);
+            const index = s.structUnion instanceof CStruct ? s.structUnion.members.findIndex(m => m.name === s.member) : -1;
+            if (locals && index >= 0) return [[], {type: "local", index: locals[index]}];
+        }
+
         const address = ctx.expression(s.body, false);
         if (s.structUnion instanceof CStruct) {
             let offset = 0;
@@ -347,6 +377,11 @@ export function getStaticAddress(s: CDeclaration): number | undefined {
     return loc?.type === "static" ? loc.address : undefined;
 }
 
+export function storedInLocal(s: CDeclaration): boolean {
+    if (s instanceof CVarDeclaration && s.definition) s = s.definition;
+    return getStorageLocation(s)?.type === "local";
+}
+
 // helpers for storing storage location on variables using a Symbol
 
 const locationSymbol = Symbol("storage location");
@@ -358,12 +393,24 @@ function getStorageLocation(s: CDeclaration): StorageLocation | undefined {
     return (s as any as Record<typeof locationSymbol, StorageLocation | undefined>)[locationSymbol];
 }
 
+const memberLocalsSymbol = Symbol("member locals");
+function setMemberLocals(s: CArgument, locals: WLocal[]) {
+    (s as any as Record<typeof memberLocalsSymbol, WLocal[]>)[memberLocalsSymbol] = locals;
+}
+
+function getMemberLocals(s: CDeclaration): WLocal[] | undefined {
+    return (s as any as Record<typeof memberLocalsSymbol, WLocal[] | undefined>)[memberLocalsSymbol];
+}
+
 // helpers returning the instructions to read/write a type from memory
 
 function load(type: CType, offset: number): WInstruction {
     if (type instanceof CPointer) {
         return Instructions.i32.load(2, offset);
     }
+    if (type instanceof CVector) {
+        return Instructions.v128.load(4, offset);
+    }
     if (type instanceof CStruct || type instanceof CUnion || type instanceof CArray) {
         throw new Error("Invalid " + type.typeName + " load");
     }
@@ -405,6 +452,9 @@ function store(type: CType, offset: number): WInstruction {
     if (type instanceof CPointer) {
         return Instructions.i32.store(2, offset);
     }
+    if (type instanceof CVector) {
+        return Instructions.v128.store(4, offset);
+    }
     if (type instanceof CStruct || type instanceof CUnion || type instanceof CArray) {
         throw new Error("Invalid " + type.typeName + " store");
     }
@@ -430,6 +480,24 @@ function store(type: CType, offset: number): WInstruction {
     }
 }
 
+/** Load each member from the struct address on top of the stack */
+export function loadScalarMembers(ctx: WFnGenerator, members: ScalarMember[]): WInstruction[] {
+    return ctx.withTemporaryLocal(i32Type, addr => [
+        Instructions.local.set(addr),
+        ...members.flatMap(m => [Instructions.local.get(addr), load(m.type, m.offset)])
+    ]);
+}
+
+/** Store the member values on top of the stack (last member on top) to the struct at address */
+export function storeScalarMembers(ctx: WFnGenerator, members: ScalarMember[], address: WInstruction[]): WInstruction[] {
+    const locals = members.map(m => ctx.builder.getTempLocal(realType(m.type)));
+    const instr: WInstruction[] = locals.map(l => Instructions.local.set(l)).reverse();
+    members.forEach((m, i) => instr.push(...address, Instructions.local.get(locals[i]), store(m.type, m.offset)));
+
+    locals.forEach(l => ctx.builder.freeTempLocal(l));
+    return instr;
+}
+
 export function memcpy(sourceAddr: WInstruction[], destAddr: WInstruction[], bytes: number): WInstruction[] {
     return [
         ...destAddr,
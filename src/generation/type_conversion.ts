@@ -1,5 +1,5 @@
-import {CType, CArithmetic, CPointer, CArray, CVoid, CFuncType, CStruct, CUnion} from "../ir/types";
-import {Instructions, ValueType, f32Type, f64Type, i64Type, i32Type} from "../wasm";
+import {CType, CArithmetic, CPointer, CArray, CVoid, CFuncType, CStruct, CUnion, CVector} from "../ir/types";
+import {Instructions, ValueType, f32Type, f64Type, i64Type, i32Type, v128Type} from "../wasm";
 import {WInstruction} from "../wasm/instructions";
 import {ResultType} from "../wasm/wtypes";
 
@@ -8,11 +8,12 @@ export type ImplementationType = CPointer | CArray | CStruct | CUnion | CVoid |
 
 /**
  * Types used when computing the type of WebAssembly expressions.
- * CArithmetic is mapped to corresponding WebAssembly ValueTypes.
+ * CArithmetic and CVector are mapped to corresponding WebAssembly ValueTypes.
  * Otherwise the same C types are used.
  */
 export function implType(type: CType): ImplementationType {
     if (type instanceof CArithmetic) return valueType(type);
+    if (type instanceof CVector) return v128Type;
     return type;
 }
 
@@ -22,6 +23,7 @@ export function implType(type: CType): ImplementationType {
 export function realType(type: CType): ValueType {
     if (type instanceof CArithmetic) return valueType(type);
     if (type instanceof CPointer) return i32Type;
+    if (type instanceof CVector) return v128Type;
     if (type instanceof CStruct || type instanceof CUnion) {
         // passed around as pointer
         return i32Type;
@@ -155,10 +157,41 @@ export function valueType(type: CArithmetic): ValueType {
 
 export function returnType(type: CType): ResultType {
     if (type instanceof CVoid || largeReturn(type)) return [];
+
+    const members = scalarMembers(type);
+    if (members) return members.map(m => realType(m.type));
     return [realType(type)];
 }
 
 export function largeReturn(type: CType): boolean {
-    // functions that return structs/unions as they cannot be returned as a single Wasm value
-    return type instanceof CStruct || type instanceof CUnion;
+    // functions that return structs/unions which cannot be returned as Wasm values
+    return (type instanceof CStruct || type instanceof CUnion) && scalarMembers(type) === undefined;
+}
+
+/** Wasm parameters used to pass a C argument, with structs of scalar members flattened into one per member */
+export function parameterType(type: CType): ValueType[] {
+    const members = scalarMembers(type);
+    if (members) return members.map(m => realType(m.type));
+    return [realType(type)];
+}
+
+export type ScalarMember = {type: CArithmetic | CPointer, offset: number};
+
+/**
+ * Structs containing up to 4 arithmetic or pointer members are passed to and returned from functions as multiple Wasm
+ * values, one per member, instead of being copied through memory.
+ */
+export function scalarMembers(type: CType): ScalarMember[] | undefined {
+    if (!(type instanceof CStruct) || type.incomplete || type.members.length > 4) return undefined;
+
+    const members: ScalarMember[] = [];
+    let offset = 0;
+    for (const member of type.members) {
+        if (!(member.type instanceof CArithmetic || member.type instanceof CPointer)) return undefined;
+
+        offset = Math.ceil(offset / member.type.alignment) * member.type.alignment;
+        members.push({type: member.type, offset});
+        offset += member.type.bytes;
+    }
+    return members;
 }
@@ -0,0 +1,268 @@
+import {CDeclaration, CVarDeclaration} from "../ir/declarations";
+import * as e from "../ir/expressions";
+import * as c from "../ir/statements";
+import {CArithmetic, CArray, CPointer} from "../ir/types";
+import {getFlags} from "../optimisation/flags";
+import {Instructions, v128Type} from "../wasm";
+import {simd128Supported} from "../wasm/features";
+import {WLocal} from "../wasm/functions";
+import {WInstruction} from "../wasm/instructions";
+import {subExpr} from "./expressions";
+import {WFnGenerator} from "./generator";
+import {storageUpdate, storedInLocal} from "./storage";
+
+type VectorOp = "add" | "sub" | "mul" | "div" | "and" | "or" | "xor";
+type VectorTree =
+    {type: "element", base: e.CIdentifier} |
+    {type: "scalar", expr: e.CExpression, local?: WLocal} |
+    {type: "op", op: VectorOp, lhs: VectorTree, rhs: VectorTree};
+
+const ASSIGNMENT_OPS: {[k: string]: VectorOp | undefined} = {
+    add: "add", sub: "sub", mul: "mul", div: "div", bitwiseAnd: "and", bitwiseOr: "or", bitwiseXor: "xor"
+};
+
+type VectorLoop = {
+    index: e.CIdentifier;
+    limit: e.CExpression;
+    elementType: CArithmetic;
+    store: e.CIdentifier;
+    value: VectorTree;
+};
+
+// Vectorize simple element-wise loops such as
+//   for (i = 0; i < n; i++) a[i] = b[i] * x + c[i];
+// using 128-bit SIMD. The returned instructions process as many full vectors as possible, leaving the remaining
+// iterations to the scalar loop which follows. Loops with loop-carried dependencies (e.g. reductions) aren't matched.
+export function vectorizeLoop(ctx: WFnGenerator, s: c.CForLoop): WInstruction[] {
+    if (!getFlags().generation_vectorize_loops || !simd128Supported()) return [];
+
+    const loop = matchLoop(s);
+    if (loop === undefined) return [];
+
+    const {index, limit, elementType, store, value} = loop;
+    const lanes = 16 / elementType.bytes;
+    const align = Math.log2(elementType.bytes);
+
+    // splat loop invariant scalars before the loop
+    const scalars = leaves(value).filter(x => x.type === "scalar") as {type: "scalar", expr: e.CExpression, local?: WLocal}[];
+    const instr: WInstruction[] = [];
+    for (const scalar of scalars) {
+        scalar.local = ctx.builder.getTempLocal(v128Type);
+        instr.push(...subExpr(ctx, scalar.expr, elementType), splat(elementType), Instructions.local.set(scalar.local));
+    }
+
+    const address = (base: e.CIdentifier) => [
+        ...ctx.expression(base, false),
+        ...ctx.expression(index, false),
+        Instructions.i32.const(elementType.bytes),
+        Instructions.i32.mul(),
+        Instructions.i32.add()
+    ];
+    const vector = (tree: VectorTree): WInstruction[] => {
+        if (tree.type === "element") return [...address(tree.base), Instructions.v128.load(align, 0)];
+        if (tree.type === "scalar") return [Instructions.local.get(tree.local as WLocal)];
+        return [...vector(tree.lhs), ...vector(tree.rhs), vectorOp(elementType, tree.op)];
+    };
+    const asI64 = (x: e.CExpression) => [
+        ...subExpr(ctx, x, index.type),
+        (index.type as CArithmetic).type === "signed" ? Instructions.i64.extend_i32_s() : Instructions.i64.extend_i32_u()
+    ];
+
+    const vectorLoop = Instructions.loop(null, [
+        // while (limit - i >= lanes), computed using i64 to avoid overflow
+        ...asI64(limit),
+        ...asI64(index),
+        Instructions.i64.sub(),
+        Instructions.i64.const(BigInt(lanes)),
+        Instructions.i64.ge_s(),
+        Instructions.if(null, [
+            ...address(store),
+            ...vector(value),
+            Instructions.v128.store(align, 0),
+            ...storageUpdate(ctx, index.type, index, [Instructions.i32.const(lanes), Instructions.i32.add()], false),
+            Instructions.br(1)
+        ])
+    ]);
+
+    // the vector loop loads each source vector before storing, which is only equivalent to the scalar loop if no store
+    // in the scalar loop would've changed a later load. This happens when load pointer < store pointer < load pointer + 16
+    const checks = aliasChecks(ctx, store, value);
+    if (checks.length === 0) {
+        instr.push(vectorLoop);
+    } else {
+        instr.push(Instructions.block(null, [...checks, Instructions.i32.eqz(), Instructions.br_if(0), vectorLoop]));
+    }
+
+    for (const scalar of scalars) ctx.builder.freeTempLocal(scalar.local as WLocal);
+    return instr;
+}
+
+function matchLoop(s: c.CForLoop): VectorLoop | undefined {
+    // test: i < limit
+    if (!(s.test instanceof c.CExpressionStatement)) return undefined;
+    const test = s.test.expression;
+    if (!(test instanceof e.CRelational) || test.op !== "LT" || !(test.lhs instanceof e.CIdentifier)) return undefined;
+
+    const index = test.lhs;
+    const indexType = index.type;
+    if (!(indexType instanceof CArithmetic) || indexType.type === "float" || indexType.bytes !== 4) return undefined;
+    if (!storedInLocal(index.value)) return undefined;
+
+    const limit = test.rhs;
+    if (limit instanceof e.CConstant) {
+        if (limit.value < 0 || limit.value > indexType.maxValue) return undefined;
+    } else if (!(limit instanceof e.CIdentifier) || !limit.type.equals(indexType) || !isLocalScalar(limit, index)) {
+        return undefined;
+    }
+
+    // update: i++, ++i or i += 1
+    const update = s.update;
+    if (update instanceof e.CIncrDecr) {
+        if (update.op !== "++" || !isVariable(update.body, index)) return undefined;
+    } else if (update instanceof e.CAssignment) {
+        if (update.assignmentType !== "add" || !isVariable(update.lhs, index)) return undefined;
+        if (!(update.rhs instanceof e.CConstant) || Number(update.rhs.value) !== 1) return undefined;
+    } else {
+        return undefined;
+    }
+
+    // body: a single assignment to an element
+    let body = s.body;
+    if (body instanceof c.CCompoundStatement && body.statements.length === 1 && body.scope.declarations.length === 0) {
+        body = body.statements[0];
+    }
+    if (!(body instanceof c.CExpressionStatement) || !(body.expression instanceof e.CAssignment)) return undefined;
+    const assignment = body.expression;
+    if (assignment.rhs instanceof e.CInitializer) return undefined;
+
+    const store = elementBase(assignment.lhs, index);
+    const elementType = assignment.lhs.type;
+    if (store === undefined || !(elementType instanceof CArithmetic) || elementType.equals(CArithmetic.BOOL)) return undefined;
+
+    let value = matchTree(assignment.rhs, index, elementType);
+    if (value === undefined) return undefined;
+    if (assignment.assignmentType) {
+        // a[i] op= x is a[i] = a[i] op x
+        const op = ASSIGNMENT_OPS[assignment.assignmentType];
+        if (op === undefined || !vectorOpSupported(elementType, op)) return undefined;
+        const rhsType = assignment.rhs.type;
+        if (!(rhsType instanceof CArithmetic)) return undefined;
+        if (elementType.type === "float" ? !rhsType.equals(elementType) : rhsType.type === "float") return undefined;
+        value = {type: "op", op, lhs: {type: "element", base: store}, rhs: value};
+    }
+
+    return {index, limit, elementType, store, value};
+}
+
+function matchTree(x: e.CExpression, index: e.CIdentifier, elementType: CArithmetic): VectorTree | undefined {
+    const base = elementBase(x, index);
+    if (base !== undefined) {
+        const type = x.type;
+        if (!(type instanceof CArithmetic) || type.bytes !== elementType.bytes || type.equals(CArithmetic.BOOL)) return undefined;
+        if ((type.type === "float") !== (elementType.type === "float")) return undefined;
+        return {type: "element", base};
+    }
+
+    // converted to the element type then splat, which matches the scalar loop as any operations on the scalar are
+    // checked to be compatible with the element type
+    if (x instanceof e.CConstant || isLocalScalar(x, index)) return {type: "scalar", expr: x};
+
+    let op: VectorOp;
+    if (x instanceof e.CAddSub) op = x.op === "+" ? "add" : "sub";
+    else if (x instanceof e.CMulDiv) op = x.op === "*" ? "mul" : "div";
+    else if (x instanceof e.CBitwiseAndOr) op = x.op;
+    else return undefined;
+
+    // integer add, sub, mul & bitwise operations only depend on the lower bits, so can be performed in narrower lanes
+    const type = x.type;
+    if (!(type instanceof CArithmetic) || type.equals(CArithmetic.BOOL)) return undefined;
+    if (elementType.type === "float" ? !type.equals(elementType) : (type.type === "float" || type.bytes < elementType.bytes)) {
+        return undefined;
+    }
+    if (!vectorOpSupported(elementType, op)) return undefined;
+
+    const lhs = matchTree(x.lhs, index, elementType);
+    const rhs = lhs && matchTree(x.rhs, index, elementType);
+    if (lhs === undefined || rhs === undefined) return undefined;
+    return {type: "op", op, lhs, rhs};
+}
+
+// *(base + i) where base is an array or a pointer held in a local, returning base
+function elementBase(x: e.CExpression, index: e.CIdentifier): e.CIdentifier | undefined {
+    if (!(x instanceof e.CDereference) || !(x.body instanceof e.CAddSub) || x.body.op !== "+") return undefined;
+
+    const [base, offset] = x.body.lhs.type instanceof CPointer ? [x.body.lhs, x.body.rhs] : [x.body.rhs, x.body.lhs];
+    if (!isVariable(offset, index) || !(base instanceof e.CIdentifier)) return undefined;
+    if (!(base.value.type instanceof CArray) && !(base.value.type instanceof CPointer && storedInLocal(base.value))) return undefined;
+    return base;
+}
+
+// loop invariant local variable
+function isLocalScalar(x: e.CExpression, index: e.CIdentifier): boolean {
+    return x instanceof e.CIdentifier && x.type instanceof CArithmetic && !isVariable(x, index) && storedInLocal(x.value);
+}
+
+function isVariable(x: e.CExpression, variable: e.CIdentifier): boolean {
+    return x instanceof e.CIdentifier && definition(x.value) === definition(variable.value);
+}
+
+function definition(d: CDeclaration): CDeclaration {
+    return d instanceof CVarDeclaration && d.definition ? d.definition : d;
+}
+
+function leaves(tree: VectorTree): VectorTree[] {
+    if (tree.type === "op") return [...leaves(tree.lhs), ...leaves(tree.rhs)];
+    return [tree];
+}
+
+function aliasChecks(ctx: WFnGenerator, store: e.CIdentifier, value: VectorTree): WInstruction[] {
+    const loads = new Map<CDeclaration, e.CIdentifier>();
+    for (const leaf of leaves(value)) {
+        if (leaf.type !== "element" || isVariable(leaf.base, store)) continue;
+        // distinct arrays can't overlap
+        if (leaf.base.value.type instanceof CArray && store.value.type instanceof CArray) continue;
+        loads.set(definition(leaf.base.value), leaf.base);
+    }
+
+    const instr: WInstruction[] = [];
+    let first = true;
+    for (const load of loads.values()) {
+        // safe if (store - load - 1) >= 15 as unsigned, which is false for load < store < load + 16
+        instr.push(
+            ...ctx.expression(store, false),
+            ...ctx.expression(load, false),
+            Instructions.i32.sub(),
+            Instructions.i32.const(1),
+            Instructions.i32.sub(),
+            Instructions.i32.const(15),
+            Instructions.i32.ge_u()
+        );
+        if (!first) instr.push(Instructions.i32.and());
+        first = false;
+    }
+    return instr;
+}
+
+function vectorOpSupported(t: CArithmetic, op: VectorOp): boolean {
+    if (t.type === "float") return op === "add" || op === "sub" || op === "mul" || op === "div";
+    if (op === "div") return false;
+    return op !== "mul" || t.bytes > 1;
+}
+
+function vectorOp(t: CArithmetic, op: VectorOp): WInstruction {
+    if (op === "and" || op === "or" || op === "xor") return Instructions.v128[op]();
+    if (t.type === "float") {
+        return (t.bytes === 4 ? Instructions.f32x4 : Instructions.f64x2)[op]();
+    } else if (op === "div") {
+        throw new Error("Integer vector division is not supported");
+    } else if (t.bytes === 1) {
+        if (op === "mul") throw new Error("i8x16 multiplication is not supported");
+        return Instructions.i8x16[op]();
+    }
+    return ({2: Instructions.i16x8, 4: Instructions.i32x4, 8: Instructions.i64x2} as const)[t.bytes as 2 | 4 | 8][op]();
+}
+
+function splat(t: CArithmetic): WInstruction {
+    if (t.type === "float") return t.bytes === 4 ? Instructions.f32x4.splat() : Instructions.f64x2.splat();
+    return ({1: Instructions.i8x16, 2: Instructions.i16x8, 4: Instructions.i32x4, 8: Instructions.i64x2} as const)[t.bytes as 1 | 2 | 4 | 8].splat();
+}
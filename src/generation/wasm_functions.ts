@@ -1,7 +1,7 @@
 import {CFunctionCall, CIdentifier, CConstant} from "../ir/expressions";
 import {INTERNAL_FNS} from "../ir/internal_scope";
 import {CArithmetic, CStruct, CUnion, CPointer} from "../ir/types";
-import {ValueType, i32Type, i64Type, f32Type, f64Type} from "../wasm";
+import {ValueType, i32Type, i64Type, f32Type, f64Type, v128Type} from "../wasm";
 import {byte} from "../wasm/base_types";
 import {WInstruction, Instructions} from "../wasm/instructions";
 import {GenError} from "./gen_error";
@@ -58,6 +58,8 @@ export function internalFunctions(ctx: WFnGenerator, e: CFunctionCall, discard:
         return arbitrary(ctx, e, f32Type);
     case INTERNAL_FNS.wasm_f64:
         return arbitrary(ctx, e, f64Type);
+    case INTERNAL_FNS.wasm_v128:
+        return arbitrary(ctx, e, v128Type);
 
     case INTERNAL_FNS.wasm_ssp:
         return discard ? [] : [Instructions.global.get(ctx.gen.shadowStackPtr)];
@@ -1,19 +1,48 @@
 export declare function compile(files: ReadonlyMap<string, string> | string, customDefinitions?: {
     [key: string]: string;
-}): CModule;
+}, options?: CompileOptions): CModule;
+
+export interface CompileOptions {
+    /** Add execution counters to every function and branch, see runtime.dumpProfile */
+    instrument?: boolean;
+    /** Profile from a previous instrumented run */
+    profile?: Profile;
+    /** Exported function run at compile time, with the resulting memory and globals becoming the initial state. The
+     * function is no longer exported afterwards. Node only */
+    initialise?: string;
+}
+
+export interface Profile {
+    functions: {[name: string]: number};
+    branches: {[name: string]: number[]};
+}
 
 /** No access to standard library! */
 export declare function compileSnippet(source: string): CModule;
 
+/**
+ * Compiles like compile(), but reuses the module for identical sources, definitions, options, flags and compiler
+ * build. Modules are kept in memory, and in cacheDir when given (node only), so repeated calls skip the pipeline
+ */
+export declare function compileCached(files: ReadonlyMap<string, string> | string, customDefinitions?: {
+    [key: string]: string;
+}, options?: CompileOptions, cacheDir?: string): CompiledModule;
+
 export declare function setFlags(flags: Partial<OptimisationFlags> | "none" | "default"): void;
 
 export declare function getFlags(): OptimisationFlags;
 
 export declare function getDefaultFlags(): OptimisationFlags;
 
-export interface CModule {
+export interface CompiledModule {
+    /** Encoded once and shared, so mustn't be modified */
     toBytes(): Uint8Array;
+    /** Compiled by the engine once, for creating many instances */
+    compileModule(): Promise<WebAssembly.Module>;
     execute(imports: WebAssembly.Imports): Promise<WebAssembly.Exports>;
+}
+
+export interface CModule extends CompiledModule {
     functions: ReadonlyArray<{readonly type: FunctionType, readonly exportName?: string}>;
     functionImports: ReadonlyArray<{readonly type: FunctionType, readonly module: string, readonly name: string}>;
 }
@@ -28,9 +57,49 @@ export namespace runtime {
 
     export function mainWrapper(instance: WebAssembly.Exports, args: string[]): number | bigint | void;
 
+    export interface InstancePoolOptions {
+        /** Idle instances kept for reuse, default 4 */
+        maxIdle?: number;
+        /** Instances whose memory has grown by more than this many bytes in total over all their runs are discarded, default 16 MiB */
+        maxGrowth?: number;
+    }
+
+    /** Warm instances whose memory and globals are restored from a snapshot after each run */
+    export class InstancePool {
+        constructor(module: WebAssembly.Module, imports: WebAssembly.Imports, options?: InstancePoolOptions);
+
+        /** Calls fn with an instance in its initial state, discarding the instance if fn throws or its promise rejects */
+        run<T>(fn: (instance: WebAssembly.Exports) => T | PromiseLike<T>): Promise<T>;
+
+        main(args: string[]): Promise<number | bigint | void>;
+    }
+
+    export function dumpProfile(instance: WebAssembly.Exports): Profile;
+
+    /** Needs the ALLOC_STATS custom definition */
+    export function heapStats(instance: WebAssembly.Exports): HeapStats;
+
+    /** __time and __clock_ns imports for time.h, not needed with the DETERMINISTIC_TIME custom definition */
+    export function timeImports(): {__time: () => number, __clock_ns: (clockId: number) => bigint};
+
+    export interface HeapStats {
+        inUse: number;
+        peakInUse: number;
+        freeChunks: number;
+        largestFree: number;
+        heapSize: number;
+        growCalls: number;
+        allocations: number;
+        reallocations: number;
+        frees: number;
+        sizeBuckets: number[];
+    }
+
     export interface FileLike {
         get(): number | -1;
         put(c: number): boolean;
+        read?(dest: Uint8Array): number;
+        write?(src: Uint8Array): boolean;
         pos(): bigint;
         len(): bigint;
         set_pos(pos: bigint): boolean;
@@ -39,9 +108,14 @@ export namespace runtime {
     export class Files {
         constructor(output: (char: string) => void, input?: () => string, files?: Map<string, Uint8Array | runtime.FileLike>);
 
+        /** Lets __read and __write access the instance's memory, otherwise they fall back to __get_char and __put_char */
+        attach(instance: WebAssembly.Exports): void;
+
         getImports(): {
             __get_char: (handle: number) => number;
+            __read: (handle: number, ptr: number, len: number) => number;
             __put_char: (handle: number, char: number) => number;
+            __write: (handle: number, ptr: number, len: number) => number;
             __get_pos: (handle: number) => bigint;
             __get_len: (handle: number) => bigint;
             __set_pos: (handle: number, pos: bigint) => number;
@@ -50,6 +124,7 @@ export namespace runtime {
             __get_fhandle: () => number;
         };
 
+        /** Files passed to the constructor are used without copying, and getContents returns a view not a copy */
         getContents(filename: string): Uint8Array | undefined;
     }
 }
@@ -1,7 +1,11 @@
 export {compile, compileSnippet} from "./compile";
+export {compileCached} from "./cache";
 export {getFlags, getDefaultFlags, setFlags} from "./optimisation/flags";
 
 // runtime
-import {injectArgs, mainWrapper} from "./c_library/runtime/args";
+import {injectArgs, mainWrapper, InstancePool} from "./c_library/runtime/args";
 import {Files} from "./c_library/runtime/files";
-export const runtime = {injectArgs, mainWrapper, Files};
+import {dumpProfile} from "./c_library/runtime/profile";
+import {heapStats} from "./c_library/runtime/heap_stats";
+import {timeImports} from "./c_library/runtime/time";
+export const runtime = {injectArgs, mainWrapper, InstancePool, Files, dumpProfile, heapStats, timeImports};
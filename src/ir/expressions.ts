@@ -171,14 +171,23 @@ export class CAddressOf { // &
     readonly type: CPointer;
     readonly body: CExpression;
 
-    constructor(readonly node: ParseNode, body: CExpression) {
+    /** memberAccess is set when transforming `e.member` to `(&e)->member` */
+    constructor(readonly node: ParseNode, body: CExpression, memberAccess = false) {
         const bodyType = body.type instanceof CPointer ? (body.type.original ?? body.type) : body.type; // no pointer gen
         if (!(body instanceof CIdentifier && bodyType instanceof CFuncType)) checks.checkLvalue(body, true);
         this.type = new CPointer(node, bodyType);
 
         if (body instanceof CIdentifier) {
-            // when translating to wasm all variables which have their address taken have to be stored on the shadow stack
-            (body.value as CVariable | CArgument).addressUsed = true;
+            // when translating to wasm all variables which have their address taken have to be stored on the shadow stack,
+            // except struct arguments which are only used to access members, as those can be kept in separate locals
+            const value = body.value as CVariable | CArgument;
+            if (!memberAccess || value.storage !== "argument") value.addressUsed = true;
+        } else if (!memberAccess) {
+            // taking the address of a member (or element of a member) also requires struct arguments to be in memory
+            for (const id of body.identifiers()) {
+                const value = id.value as CVariable | CArgument;
+                if (value.storage === "argument" && value.type instanceof CStruct) value.addressUsed = true;
+            }
         }
         this.body = body;
     }
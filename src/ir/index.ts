@@ -2,7 +2,7 @@ import {parse} from "../parsing";
 import {Scope} from "./scope";
 import {ptTransform} from "./transform/transform";
 
-export function toIR(source: string): Scope {
+export function toIR(source: string, file?: string): Scope {
     const translationUnit = parse(source);
-    return ptTransform(translationUnit);
+    return ptTransform(translationUnit, file);
 }
@@ -1,7 +1,7 @@
 import {ParseNode} from "../parsing";
 import {CFuncDeclaration} from "./declarations";
 import {Scope} from "./scope";
-import {CFuncType, CVoid, CArithmetic, CPointer} from "./types";
+import {CFuncType, CVoid, CArithmetic, CPointer, CVector} from "./types";
 
 const fakeParseNode: ParseNode = new class extends ParseNode {
     readonly type: string = "__internal__";
@@ -51,6 +51,13 @@ export const INTERNAL_FNS = {
         new CFuncType(fakeParseNode, CArithmetic.Fp64, [CArithmetic.U32], undefined, true),
         "internal"
     ),
+    /** For executing arbitrary Wasm* returning v128 */
+    wasm_v128: new CFuncDeclaration(
+        fakeParseNode,
+        "__wasm_v128__",
+        new CFuncType(fakeParseNode, CVector.V128, [CArithmetic.U32], undefined, true),
+        "internal"
+    ),
     /** For getting the value of the shadow stack pointer
      *
      * __wasm_ssp__();
@@ -76,5 +83,11 @@ export const INTERNAL_FNS = {
     )
 };
 
+/** Types which can't be written using C type specifiers. The names are also registered as type names in the parser */
+export const INTERNAL_TYPES = {
+    __v128: CVector.V128
+};
+
 export const INTERNAL_SCOPE = new Scope();
 Object.values(INTERNAL_FNS).forEach(x => INTERNAL_SCOPE.addIdentifier(x));
+Object.entries(INTERNAL_TYPES).forEach(([name, type]) => INTERNAL_SCOPE.addTypedef(name, type));
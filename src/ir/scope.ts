@@ -21,7 +21,8 @@ export class Scope {
 
     constructor(readonly node?: ParseNode,
                 readonly parent?: Scope,
-                readonly func: CFuncDefinition | undefined = parent?.func) {
+                readonly func: CFuncDefinition | undefined = parent?.func,
+                readonly file: string | undefined = parent?.file) {
     }
 
     private _getTag(tag: string): CCompound | undefined {
@@ -55,6 +56,11 @@ export class Scope {
         return result;
     }
 
+    /** lookupIdentifier without an error if the identifier isn't found */
+    findIdentifier(name: string): CDeclaration | undefined {
+        return this._getId(name);
+    }
+
     addIdentifier(value: CDeclaration): void {
         const existing = this.identifiers.get(value.name); // allowing redefining identifiers defined in parent scopes
         if (existing) {
@@ -1,14 +1,27 @@
 import {ParseNode, ParseTreeValidationError, pt} from "../../parsing";
+import {CArgument} from "../declarations";
 import {
     CExpression, CConstant, CIdentifier, CFunctionCall, CMemberAccess, CDereference, CConditional,
     CAssignment, CStringLiteral, CIncrDecr, CAddressOf, CUnaryPlusMinus, CBitwiseNot, CLogicalNot, CSizeof, CAddSub,
     CCast, CComma, CMulDiv, CMod, CShift, CRelational, CEquality, CBitwiseAndOr, CLogicalAndOr, CValue
 } from "../expressions";
 import {Scope} from "../scope";
-import {CArithmetic, CArray} from "../types";
+import {CArithmetic, CArray, CStruct, CUnion} from "../types";
 import {constInteger} from "./constant_expressions";
+import {specialisePrintf} from "./printf";
 import {getType} from "./type_transform";
 
+function ptIdentifier(e: pt.Identifier, scope: Scope, memberAccess: boolean): CIdentifier {
+    const id = new CIdentifier(e, scope.lookupIdentifier(e.name, e));
+    if (scope.func) scope.func.dependencies.set(id.value, true);
+
+    if (!memberAccess && id.value instanceof CArgument && (id.value.type instanceof CStruct || id.value.type instanceof CUnion)) {
+        // struct/union values are used through their address, so the argument has to be stored in memory
+        id.value.addressUsed = true;
+    }
+    return id;
+}
+
 /** Transform expressions from the parse tree */
 export function ptExpression(e: pt.Expression, scope: Scope): CExpression {
     if (e instanceof pt.ConstantExpression) {
@@ -19,9 +32,7 @@ export function ptExpression(e: pt.Expression, scope: Scope): CExpression {
         return ptConstant(e);
 
     } else if (e instanceof pt.Identifier) {
-        const id = new CIdentifier(e, scope.lookupIdentifier(e.name, e));
-        if (scope.func) scope.func.dependencies.set(id.value, true);
-        return id;
+        return ptIdentifier(e, scope, false);
 
     } else if (e instanceof pt.StringLiteral) {
         const arr: bigint[] = []; // split the literal into characters taking into account escape sequences
@@ -55,14 +66,15 @@ export function ptExpression(e: pt.Expression, scope: Scope): CExpression {
         return new CCast(e, getType(e.targetType, scope), ptExpression(e.body, scope));
 
     } else if (e instanceof pt.FunctionCallExpression) {
-        return new CFunctionCall(e, ptExpression(e.fn, scope), (e.args ?? []).map(e => ptExpression(e, scope)));
+        const args = (e.args ?? []).map(e => ptExpression(e, scope));
+        return specialisePrintf(e, args, scope) ?? new CFunctionCall(e, ptExpression(e.fn, scope), args);
 
     } else if (e instanceof pt.MemberAccessExpression) {
-        let body = ptExpression(e.lhs, scope);
-        if (!e.pointer) { // transform into pointer access
-            body = new CAddressOf(e, body);
-        }
-        return new CMemberAccess(e, body, e.rhs);
+        if (e.pointer) return new CMemberAccess(e, ptExpression(e.lhs, scope), e.rhs);
+
+        // transform into pointer access
+        const body = e.lhs instanceof pt.Identifier ? ptIdentifier(e.lhs, scope, true) : ptExpression(e.lhs, scope);
+        return new CMemberAccess(e, new CAddressOf(e, body, true), e.rhs);
 
     } else if (e instanceof pt.ConditionalExpression) {
         return new CConditional(e, ptExpression(e.condition, scope), ptExpression(e.trueValue, scope), ptExpression(e.falseValue, scope));
@@ -0,0 +1,259 @@
+import {ParseNode, pt} from "../../parsing";
+import {getFlags} from "../../optimisation/flags";
+import {CFuncDeclaration, CFuncDefinition, CVarDefinition, CArgument} from "../declarations";
+import {
+    CExpression, CConstant, CIdentifier, CFunctionCall, CMemberAccess, CDereference, CConditional, CAssignment,
+    CStringLiteral, CIncrDecr, CAddressOf, CUnaryPlusMinus, CBitwiseNot, CLogicalNot, CSizeof, CAddSub, CCast, CComma,
+    CMulDiv, CMod, CShift, CRelational, CEquality, CBitwiseAndOr, CLogicalAndOr
+} from "../expressions";
+import {Scope} from "../scope";
+import {CArithmetic, CArray, CFuncType, CPointer, CQualifiedType, CType} from "../types";
+
+// matches FLAGS_* in libraries/printf/printf.c
+const FLAGS_ZEROPAD = 1, FLAGS_LEFT = 2, FLAGS_PLUS = 4, FLAGS_SPACE = 8, FLAGS_HASH = 16, FLAGS_UPPERCASE = 32,
+    FLAGS_CHAR = 64, FLAGS_SHORT = 128, FLAGS_LONG = 256, FLAGS_LONG_LONG = 512, FLAGS_PRECISION = 1024,
+    FLAGS_ADAPT_EXP = 2048;
+const FLAG_CHARS: {[c: string]: number} = {"0": FLAGS_ZEROPAD, "-": FLAGS_LEFT, "+": FLAGS_PLUS, " ": FLAGS_SPACE, "#": FLAGS_HASH};
+
+// index of the format argument for each function
+const FORMAT_INDEX: {[name: string]: number} = {printf: 0, fprintf: 1, sprintf: 1, snprintf: 2};
+
+const PERCENT = 0x25;
+
+class Specialiser {
+    readonly calls: CExpression[] = [];
+    literal: number[] = [];
+
+    constructor(readonly node: ParseNode, readonly scope: Scope) {
+    }
+
+    /** Add a call to a helper, returning false if it isn't declared (stdio.h not included) */
+    call(name: string, ...args: (CExpression | number)[]): boolean {
+        const decl = this.scope.findIdentifier(name);
+        if (!(decl instanceof CFuncDeclaration)) return false;
+
+        const params = decl.type.parameterTypes;
+        this.calls.push(new CFunctionCall(this.node, new CIdentifier(this.node, decl), args.map((a, i) => {
+            const value = typeof a === "number" ? new CConstant(this.node, CArithmetic.U32, BigInt(a)) : a;
+            return new CCast(this.node, params[i], value);
+        })));
+        return true;
+    }
+
+    flushLiteral(): boolean {
+        if (this.literal.length === 0) return true;
+        const chars = this.literal;
+        this.literal = [];
+
+        if (chars.length === 1) return this.call("__printf_char", chars[0], 0, 0);
+        const str = new CStringLiteral(this.node, [...chars.map(c => BigInt(c)), 0n]);
+        return this.call("__printf_literal", str, chars.length);
+    }
+}
+
+/**
+ * Rewrite printf, fprintf, sprintf and snprintf calls with a string literal format into calls to the __printf_*
+ * helpers in printf.c, parsing the format at compile time. Each literal chunk is written with a single call and each
+ * conversion calls the formatter for its type directly, so the generic format interpreter is only linked if it is
+ * still used elsewhere.
+ *
+ * The helpers share static state between __printf_begin_* and __printf_end, so the variadic arguments, which are
+ * evaluated in between, must not contain calls. Unsupported formats (e.g. `*` widths) are left to the library.
+ */
+export function specialisePrintf(e: pt.FunctionCallExpression, args: CExpression[], scope: Scope): CExpression | undefined {
+    if (!getFlags().specialise_printf || !scope.func || !(e.fn instanceof pt.Identifier)) return undefined;
+
+    const formatIndex = FORMAT_INDEX[e.fn.name];
+    if (formatIndex === undefined) return undefined;
+
+    // only library declarations, not user definitions
+    const decl = scope.findIdentifier(e.fn.name);
+    if (!(decl instanceof CFuncDeclaration) || decl.definition !== undefined) return undefined;
+    const call = new CFunctionCall(e, new CIdentifier(e.fn, decl), args); // check the arguments as normal
+
+    let format = call.args[formatIndex];
+    while (format instanceof CCast) format = format.body;
+    if (!(format instanceof CStringLiteral)) return undefined;
+
+    // writes to a buffer could change values read from memory by later arguments
+    const buffered = e.fn.name === "sprintf" || e.fn.name === "snprintf";
+    const varArgs = call.args.slice(formatIndex + 1);
+    if (!varArgs.every(a => isPure(a, !buffered, scope.func as CFuncDefinition))) return undefined;
+
+    const s = new Specialiser(e, scope);
+    const begun = e.fn.name === "printf" ? s.call("__printf_begin_stdout") :
+        e.fn.name === "fprintf" ? s.call("__printf_begin_stream", call.args[0]) :
+            s.call("__printf_begin_buffer", call.args[0], e.fn.name === "snprintf" ? call.args[1] : 0xFFFFFFFF);
+    if (!begun || !specialiseFormat(s, format.value.map(Number), varArgs)) return undefined;
+
+    if (!s.call("__printf_end")) return undefined;
+
+    // the helpers replace the dependency on the original function
+    for (const helper of s.calls) {
+        for (const id of helper.identifiers()) {
+            if (id.value instanceof CFuncDeclaration) scope.func.dependencies.set(id.value, true);
+        }
+    }
+    return s.calls.slice(1).reduce((lhs, rhs) => new CComma(e, lhs, rhs), s.calls[0]);
+}
+
+/** Add helper calls for each part of the format, mirroring _vsnprintf in printf.c */
+function specialiseFormat(s: Specialiser, format: number[], args: CExpression[]): boolean {
+    const end = format.indexOf(0);
+    const isDigit = (i: number) => format[i] >= 0x30 && format[i] <= 0x39;
+    let i = 0, arg = 0;
+
+    while (i < end) {
+        if (format[i] !== PERCENT) {
+            s.literal.push(format[i++]);
+            continue;
+        }
+        i++;
+
+        let flags = 0, width = 0, precision = 0;
+        for (;;) {
+            const flag = FLAG_CHARS[String.fromCharCode(format[i])];
+            if (flag === undefined) break;
+            flags |= flag;
+            i++;
+        }
+        while (isDigit(i)) width = (width * 10 + format[i++] - 0x30) >>> 0;
+        if (format[i] === 0x2A) return false; // '*'
+        if (format[i] === 0x2E) { // '.'
+            flags |= FLAGS_PRECISION;
+            i++;
+            while (isDigit(i)) precision = (precision * 10 + format[i++] - 0x30) >>> 0;
+            if (format[i] === 0x2A) return false;
+        }
+
+        const length = String.fromCharCode(format[i]);
+        if (length === "l" || length === "h") {
+            i++;
+            if (format[i] === format[i - 1]) {
+                flags |= length === "l" ? FLAGS_LONG | FLAGS_LONG_LONG : FLAGS_SHORT | FLAGS_CHAR;
+                i++;
+            } else {
+                flags |= length === "l" ? FLAGS_LONG : FLAGS_SHORT;
+            }
+        } else if (length === "t" || length === "j" || length === "z") {
+            // long and long long are the same size, so these are always read as 64 bit values
+            flags |= FLAGS_LONG;
+            i++;
+        }
+        if (i >= end) return false;
+
+        const spec = String.fromCharCode(format[i++]);
+        if (!"diuxXobfFeEgGcsp".includes(spec)) {
+            // %% and unknown specifiers output the character
+            s.literal.push(format[i - 1]);
+            continue;
+        }
+
+        if (arg >= args.length) return false;
+        const value = args[arg++];
+        const type = value.type;
+        const integer = (type instanceof CArithmetic && type.type !== "float") || type instanceof CPointer;
+        if (!s.flushLiteral()) return false;
+
+        if ("diuxXob".includes(spec)) {
+            if (!integer) return false;
+            const base = spec === "x" || spec === "X" ? 16 : spec === "o" ? 8 : spec === "b" ? 2 : 10;
+            if (base === 10) flags &= ~FLAGS_HASH;
+            if (spec === "X") flags |= FLAGS_UPPERCASE;
+            if (spec !== "d" && spec !== "i") flags &= ~(FLAGS_PLUS | FLAGS_SPACE);
+            if (flags & FLAGS_PRECISION) flags &= ~FLAGS_ZEROPAD;
+
+            let converted: CArithmetic;
+            if (spec === "d" || spec === "i") {
+                // char is unsigned
+                converted = flags & FLAGS_LONG ? CArithmetic.S64 : flags & FLAGS_CHAR ? CArithmetic.U8 :
+                    flags & FLAGS_SHORT ? CArithmetic.S16 : CArithmetic.S32;
+            } else {
+                converted = flags & FLAGS_LONG ? CArithmetic.U64 : flags & FLAGS_CHAR ? CArithmetic.U8 :
+                    flags & FLAGS_SHORT ? CArithmetic.U16 : CArithmetic.U32;
+            }
+
+            const helper = converted.type === "signed" ? "__printf_signed" : "__printf_unsigned";
+            if (!s.call(helper, new CCast(s.node, converted, value), base, precision, width, flags)) return false;
+
+        } else if ("fFeEgG".includes(spec)) {
+            if (!(type instanceof CArithmetic && type.type === "float")) return false;
+            if (spec === "g" || spec === "G") flags |= FLAGS_ADAPT_EXP;
+            if (spec === "F" || spec === "E" || spec === "G") flags |= FLAGS_UPPERCASE;
+            const exponential = spec !== "f" && spec !== "F" ? 1 : 0;
+            if (!s.call("__printf_double", value, exponential, precision, width, flags)) return false;
+
+        } else if (spec === "c") {
+            if (!(type instanceof CArithmetic && type.type !== "float")) return false;
+            if (!s.call("__printf_char", value, width, flags)) return false;
+
+        } else if (spec === "s") {
+            if (!(type instanceof CPointer)) return false;
+            if (!s.call("__printf_string", value, precision, width, flags)) return false;
+
+        } else if (spec === "p") {
+            if (!integer) return false;
+            flags |= FLAGS_ZEROPAD | FLAGS_UPPERCASE;
+            if (!s.call("__printf_unsigned", new CCast(s.node, CArithmetic.U32, value), 16, precision, 8, flags)) return false;
+        }
+    }
+
+    return s.flushLiteral();
+}
+
+/** Whether evaluating the expression has no side effects, optionally allowing memory reads */
+function isPure(e: CExpression, memory: boolean, func: CFuncDefinition): boolean {
+    if (e instanceof CConstant || e instanceof CStringLiteral || e instanceof CSizeof) {
+        return true;
+    } else if (e instanceof CIdentifier) {
+        return memory || !readsMemory(e, func);
+    } else if (e instanceof CFunctionCall || e instanceof CAssignment || e instanceof CIncrDecr) {
+        return false;
+    } else if (e instanceof CDereference || e instanceof CMemberAccess) {
+        return memory && isPure(e.body, memory, func);
+    } else if (e instanceof CAddressOf) {
+        // the body isn't read
+        return e.body instanceof CIdentifier || isPure(e.body, true, func);
+    } else if (e instanceof CUnaryPlusMinus || e instanceof CBitwiseNot || e instanceof CLogicalNot || e instanceof CCast) {
+        return isPure(e.body, memory, func);
+    } else if (e instanceof CConditional) {
+        return isPure(e.test, memory, func) && isPure(e.trueValue, memory, func) && isPure(e.falseValue, memory, func);
+    } else if (e instanceof CMulDiv || e instanceof CMod || e instanceof CAddSub || e instanceof CShift || e instanceof CRelational ||
+        e instanceof CEquality || e instanceof CBitwiseAndOr || e instanceof CLogicalAndOr || e instanceof CComma) {
+        return isPure(e.lhs, memory, func) && isPure(e.rhs, memory, func);
+    }
+    return false;
+}
+
+/**
+ * Whether reading the identifier could read memory. Only local variables and arguments which never have their address
+ * taken are stored in Wasm locals. The whole function is checked, as the address may be taken after this call (e.g.
+ * later in a loop), so the variable's addressUsed flag isn't set yet.
+ */
+function readsMemory(id: CIdentifier, func: CFuncDefinition): boolean {
+    const value = id.value;
+    // function pointers and arrays evaluate to constant addresses, and constants (e.g. enum constants) can't be written
+    if (value.type instanceof CFuncType || value.type instanceof CArray) return false;
+    if ((value.type as CQualifiedType<CType>).qualifier === "const" && value.type instanceof CArithmetic) return false;
+    if (!(value instanceof CArgument || (value instanceof CVarDefinition && value.storage === "local"))) return true;
+    if (!(value.type instanceof CArithmetic || value.type instanceof CPointer)) return true;
+    return value.addressUsed || addressedNames(func).has(value.name);
+}
+
+const _addressedNames = new WeakMap<CFuncDefinition, Set<string>>();
+function addressedNames(func: CFuncDefinition): Set<string> {
+    let names = _addressedNames.get(func);
+    if (!names) {
+        names = new Set();
+        const stack: pt.ParseNode[] = [func.node.body];
+        while (stack.length) {
+            const node = stack.pop() as pt.ParseNode;
+            if (node instanceof pt.UnaryExpression && node.type === "addressOf" && node.body instanceof pt.Identifier) {
+                names.add(node.body.name);
+            }
+            stack.push(...node.children());
+        }
+        _addressedNames.set(func, names);
+    }
+    return names;
+}
@@ -10,8 +10,8 @@ import {ptExpression, evalIntegerConstant} from "./expr_transform";
 import {getDeclaratorName, getDeclaratorType, getType} from "./type_transform";
 
 /** Main function, transform a parse tree translation unit into a root scope */
-export function ptTransform(translationUnit: pt.TranslationUnit): Scope {
-    const fileScope = new Scope(undefined, INTERNAL_SCOPE);
+export function ptTransform(translationUnit: pt.TranslationUnit, file?: string): Scope {
+    const fileScope = new Scope(undefined, INTERNAL_SCOPE, undefined, file);
     for (const decl of translationUnit) {
         if (decl instanceof pt.FunctionDefinition) {
             ptFunction(decl, fileScope);
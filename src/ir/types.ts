@@ -3,7 +3,7 @@ import type {TypeSpecifier, TypeQualifier, ParseNode} from "../parsing/parsetree
 
 // types for expressions and declarations in the IR
 export type CType = CNotFuncType | CFuncType;
-export type CNotFuncType = CArithmetic | CPointer | CArray | CStruct | CUnion | CVoid;
+export type CNotFuncType = CArithmetic | CVector | CPointer | CArray | CStruct | CUnion | CVoid;
 export type CQualifiedType<T extends CType> = T & {qualifier?: TypeQualifier, _base?: T};
 
 export class CFuncType {
@@ -283,6 +283,28 @@ export class CVoid {
     }
 }
 
+// 128-bit SIMD value, which can only be manipulated using wasm/simd128.h
+export class CVector {
+    readonly typeName = "v128_t";
+    readonly bytes = 16;
+    readonly alignment = 16;
+    readonly incomplete = false;
+    readonly node = undefined;
+
+    private constructor() {
+    }
+
+    equals(t: object): boolean {
+        return t instanceof CVector;
+    }
+
+    get pointerGeneration(): this {
+        return this;
+    }
+
+    static readonly V128 = new CVector();
+}
+
 export class CArithmetic {
     readonly incomplete = false;
     readonly node = undefined;
@@ -25,7 +25,7 @@ export class Linker {
             for (const [p2, c2] of files.entries()) preprocessor.userFiles.set(p2, c2);
             const processed = preprocessor.process(code);
             try {
-                this.process_scope(toIR(processed));
+                this.process_scope(toIR(processed, path));
             } catch (e) {
                 e.message = (e.message ?? "") + "\nIn file: " + path;
                 throw e;
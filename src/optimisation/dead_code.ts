@@ -1,6 +1,6 @@
 import {WExpression, ValueType, Instructions} from "../wasm";
 import {WLocal} from "../wasm/functions";
-import {InstrInstance, PartialInstr} from "../wasm/instr_helpers";
+import {InstrInstance, PartialInstr, resultTypes} from "../wasm/instr_helpers";
 
 export function deadCodeElimination(expr: WExpression, usedLocals = new Set<WLocal>()): void {
     const [instructions, stackItems] = dataflow(expr);
@@ -10,6 +10,10 @@ export function deadCodeElimination(expr: WExpression, usedLocals = new Set<WLoc
         if (instruction.instr.writes.some(resource => !(resource instanceof WLocal))) {
             markNeeded(instruction);
         }
+        if (instruction.produces.length > 1) {
+            // keep everything consuming the results of multi-value instructions, as only the top value could be dropped
+            for (const item of instruction.produces) if (item.consumedBy) markNeeded(item.consumedBy);
+        }
     }
     markRecursively(stackItems);
 
@@ -56,7 +60,7 @@ export function deadCodeElimination(expr: WExpression, usedLocals = new Set<WLoc
             if (instruction.needed || instruction.instr.name === "unreachable") { // also preserve "unreachable" instructions
                 replacement.push(instruction.instr);
 
-                if (instruction.produces && !instruction.produces.needed) {
+                if (instruction.produces.length === 1 && !instruction.produces[0].needed) {
                     replacement.push(Instructions.drop());
                 }
             }
@@ -66,7 +70,7 @@ export function deadCodeElimination(expr: WExpression, usedLocals = new Set<WLoc
 }
 
 function dataflow(expr: WExpression): [DFInstruction[], DFStackItem[]] {
-    const instructions = expr.instructions.map(instr => ({instr, produces: undefined, consumes: []} as DFInstruction));
+    const instructions = expr.instructions.map(instr => ({instr, produces: [], consumes: []} as DFInstruction));
     const stackItems: DFStackItem[] = [];
 
     const currentStack: DFStackItem[] = [];
@@ -77,14 +81,15 @@ function dataflow(expr: WExpression): [DFInstruction[], DFStackItem[]] {
             dfInstr.consumes.push(item);
         }
 
-        if (dfInstr.instr.result !== null) {
-            dfInstr.produces = {
-                type: dfInstr.instr.result,
+        for (const type of resultTypes(dfInstr.instr)) {
+            const item: DFStackItem = {
+                type,
                 producedBy: dfInstr,
                 index: stackItems.length
             };
-            currentStack.push(dfInstr.produces);
-            stackItems.push(dfInstr.produces);
+            dfInstr.produces.push(item);
+            currentStack.push(item);
+            stackItems.push(item);
         }
     }
 
@@ -112,7 +117,7 @@ function markRecursively(items: DFStackItem[]) {
 
 interface DFInstruction {
     instr: InstrInstance;
-    produces: DFStackItem | undefined;
+    produces: DFStackItem[];
     consumes: DFStackItem[];
     needed?: true;
 }
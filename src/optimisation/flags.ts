@@ -1,7 +1,10 @@
 const DEFAULT = {
+    specialise_printf: true,
+
     generation_try_constant_expr: true,
     generation_zero_shadow_stack: false,
     generation_switch_br_table: false,
+    generation_vectorize_loops: false,
 
     peephole_local_tee: true,
     peephole_i32_constants_ops: true,
@@ -15,6 +18,7 @@ const DEFAULT = {
     partial_redundancy_elimination: true,
     copy_propagation: true,
     live_range_splitting: true,
+    stackify_locals: true,
     dead_code_elimination: true,
     reallocate_locals: true,
     unused_locals: true,
@@ -22,6 +26,8 @@ const DEFAULT = {
     peephole_2nd_pass: true,
 
     // interprocedural
+    specialise_function_pointers: true,
+    fold_pure_calls: true,
     inlining: false,
 } as const;
 
@@ -4,8 +4,6 @@ import {peephole} from "../peephole";
 import {Flow, simplifiedControlFlow} from "./control_flow";
 import {framework} from "./framework";
 
-type ClashNode = {local: number, type: ValueType, clash: Set<number>};
-
 export function realloc_locals(expr: WExpression): void {
     if (expr.builder.locals.length <= 1) return;
 
@@ -27,45 +25,92 @@ export function realloc_locals(expr: WExpression): void {
         return x;
     });
 
-    // make clash graph
-    const clashGraph: ClashNode[] = expr.builder.locals
-        .map(({type}, local) => ({local, type: type, clash: new Set()}));
-    for (let bits of liveMap.values()) {
-        if (bits === 0n) continue;
+    // make clash graph. a local only needs to clash with the locals which are live after each of its definitions,
+    // which avoids comparing every pair of live locals at every instruction
+    const types = expr.builder.locals.map(({type}) => type);
+    const clash: Set<number>[] = types.map(() => new Set());
+    const copies: [source: number, dest: number][] = [];
+    const pressure = new Map<ValueType, number>(); // max number of locals of each type live at once
+
+    for (const flow of cfg.all) {
+        const instr = flow.instr;
+        if (instr.type !== "index" || (instr.name !== "local.set" && instr.name !== "local.tee")) continue;
+        const def = Number(instr.immediate.value - numArgs);
+        if (def < 0) continue; // argument
+
+        let liveOut = 0n;
+        for (const next of flow.flowNext) liveOut |= liveMap.get(next) ?? 0n;
 
-        const live: number[] = [];
-        for (let i = 0; bits; i++) {
-            if (bits & 1n) live.push(i);
-            bits >>= 1n;
+        // [local.get a, local.set b] doesn't make a and b clash, as they hold the same value
+        let source = -1;
+        const previous = flow.instrIndex > 0 ? flow.expr.instructions[flow.instrIndex - 1] : undefined;
+        if (previous && previous.type === "index" && previous.name === "local.get") {
+            source = Number(previous.immediate.value - numArgs);
+            if (source >= 0 && source !== def && types[source] === types[def]) {
+                copies.push([source, def]);
+            } else {
+                source = -1;
+            }
         }
-        if (live.length <= 1) continue;
 
-        for (const i of live) {
-            for (const j of live) i !== j && clashGraph[i].clash.add(j);
+        let live = 1;
+        for (const l of setBits(liveOut)) {
+            if (l === def || types[l] !== types[def]) continue;
+            live++;
+            if (l === source) continue;
+            clash[def].add(l);
+            clash[l].add(def);
         }
+        pressure.set(types[def], Math.max(pressure.get(types[def]) ?? 0, live));
     }
 
+    // coalesce copies when this can't increase the number of locals needed
+    const group = types.map((_, i) => i);
+    const find = (l: number): number => group[l] === l ? l : (group[l] = find(group[l]));
+    for (const [source, dest] of copies) {
+        const a = find(source), b = find(dest);
+        if (a === b || clash[a].has(b)) continue;
+
+        const k = pressure.get(types[a]) ?? 0;
+        if (!briggs(clash, a, b, k) && !george(clash, a, b, k)) continue;
+
+        group[b] = a;
+        for (const n of clash[b]) {
+            clash[n].delete(b);
+            clash[n].add(a);
+            clash[a].add(n);
+        }
+        clash[b].clear();
+    }
+    const nodes = types.map((_, i) => i).filter(l => find(l) === l);
+
     // push vertex with the least edges onto a stack
     const stack: number[] = [];
-    const clashCopy = clashGraph.map(({local, clash}) => ({local, clash: new Set(clash)}));
-    while (clashCopy.length) {
-        clashCopy.sort((a, b) => a.clash.size - b.clash.size);
-        const {local} = clashCopy.shift() as ClashNode;
+    const degree = new Map(nodes.map(l => [l, clash[l].size]));
+    while (degree.size) {
+        let local = -1, min = Infinity;
+        for (const [l, d] of degree) {
+            if (d < min) [local, min] = [l, d];
+        }
+        degree.delete(local);
         stack.push(local);
 
-        for (const node of clashCopy) node.clash.delete(local);
+        for (const n of clash[local]) {
+            const d = degree.get(n);
+            if (d !== undefined) degree.set(n, d - 1);
+        }
     }
 
     // pop and allocate
     expr.builder.wipeLocals();
     const locals: WLocal[] = [];
-    const mapping: WLocal[] = Array(clashGraph.length);
+    const mapping: WLocal[] = Array(types.length);
     while (stack.length) {
         const oldLocal = stack.pop() as number;
-        const {type} = clashGraph[oldLocal];
+        const type = types[oldLocal];
 
         const clashesWith = new Set<WLocal>();
-        for (const c of clashGraph[oldLocal].clash) {
+        for (const c of clash[oldLocal]) {
             if (mapping[c]) clashesWith.add(mapping[c]);
         }
 
@@ -80,10 +125,43 @@ export function realloc_locals(expr: WExpression): void {
 
         mapping[oldLocal] = newLocal;
     }
+    for (let l = 0; l < types.length; l++) mapping[l] = mapping[find(l)];
     mapping.unshift(...expr.builder.args); // add arguments back into mapping
 
     // transform according to the mapping
     remapLocals(expr, mapping);
+
+    // remove copies between coalesced locals
+    peephole(expr, ([instr1, instr2]) => {
+        if (instr1.name !== "local.get" || (instr2.name !== "local.set" && instr2.name !== "local.tee")) return;
+        if (instr1.reads[0] !== instr2.writes[0]) return;
+        return instr2.name === "local.set" ? [] : [instr1];
+    }, 2);
+}
+
+// Briggs: the combined node has fewer than k neighbours with k or more edges
+function briggs(clash: Set<number>[], a: number, b: number, k: number): boolean {
+    let significant = 0;
+    for (const n of new Set([...clash[a], ...clash[b]])) {
+        const degree = clash[n].size - (clash[n].has(a) && clash[n].has(b) ? 1 : 0);
+        if (degree >= k) significant++;
+    }
+    return significant < k;
+}
+
+// George: every neighbour of b already clashes with a or has fewer than k edges
+function george(clash: Set<number>[], a: number, b: number, k: number): boolean {
+    for (const n of clash[b]) {
+        if (!clash[n].has(a) && clash[n].size >= k) return false;
+    }
+    return true;
+}
+
+function* setBits(bits: bigint): IterableIterator<number> {
+    for (let i = 0; bits; i++) {
+        if (bits & 1n) yield i;
+        bits >>= 1n;
+    }
 }
 
 export function remapLocals(expr: WExpression, mapping: WLocal[]): void {
@@ -83,6 +83,7 @@ function findValueInstr(f: InstrFlow): InstrInstance | undefined {
     let len = f.instr.parameters.length;
     for (let i = f.instrIndex - 1; i >= 0; i--) {
         const instr = f.expr.instructions[i];
+        if (instr.results) return undefined; // multi-value call
         if (instr.result) len--;
         if (len === 0) return instr;
         len += instr.parameters.length;
@@ -8,6 +8,7 @@ import {rangeSplitting} from "./flow/range_splitting";
 import {copyPropagation} from "./flow/reaching_defs";
 import {Optimiser} from "./optimiser";
 import {peepholeMulti, peepholeOptimisers} from "./peephole";
+import {stackify} from "./stackify";
 
 const optimisers: Optimiser[] = [];
 
@@ -69,6 +70,12 @@ optimisers.push({
     run: rangeSplitting
 });
 
+optimisers.push({
+    name: "Stackify locals",
+    enabled: (flags) => flags.stackify_locals,
+    run: stackify
+});
+
 optimisers.push({
     name: "Reallocate locals",
     enabled: (flags) => flags.reallocate_locals,
@@ -54,9 +54,22 @@ export function inlineFunctions(module: ModuleBuilder): void {
 
 export function removeUnusedFns(module: ModuleBuilder): void {
     const map = FnInfo.infoMap(module);
+
+    // functions only called by themselves or by other unused functions are also unused
+    const unused = new Set<WFunction>();
+    for (let changed = true; changed;) {
+        changed = false;
+        for (const info of map.values()) {
+            if (unused.has(info.fn) || info.inTable || info.exported) continue;
+            if (info.usages.every(({fn}) => fn === info.fn || unused.has(fn))) {
+                unused.add(info.fn);
+                changed = true;
+            }
+        }
+    }
+
     const functions = [...module.functions, ...module.functionImports].map(x => {
-        const info = map.get(x as WFunction);
-        if (info?.usages.length === 0 && !info.inTable && !info.exported) {
+        if (unused.has(x as WFunction)) {
             module._removeFunction(x as WFunction);
             return undefined;
         }
@@ -111,16 +124,19 @@ class FnInfo {
     }
 
     inliningCandidates(): Usage[] {
-        if (this.size > 50 || this.usages.length === 0) return []; // never inline
+        // functions which are hot in the profile get double the budget, cold functions are never inlined
+        const budget = this.fn.hints.profile === "hot" ? 2 : 1;
+        if (this.size > 50 * budget || this.usages.length === 0 || this.fn.hints.profile === "cold") return []; // never inline
+        if (this.fn.type[1].length > 1) return []; // block types for multiple results aren't supported
 
         let score = this.size;
         score += Math.min(this.fn.body.builder.args.length - 1, 0) * 5; // one argument is okay
         score += this.fn.locals.length * 5;
         if (this.fn.hints.inline) score -= 20;
 
-        if (score <= 8 || (score <= 16 && this.usages.length <= 3 && !this.inTable && !this.exported)) {
-            // inline all (non-recursive) cases
-            return this.usages.filter(({fn}) => fn !== this.fn);
+        if (score <= 8 * budget || (score <= 16 * budget && this.usages.length <= 3 && !this.inTable && !this.exported)) {
+            // inline all (non-recursive) cases, except into cold functions
+            return this.usages.filter(({fn}) => fn !== this.fn && fn.hints.profile !== "cold");
         }
         return [];
     }
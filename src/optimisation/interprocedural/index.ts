@@ -1,8 +1,12 @@
 import {ModuleBuilder} from "../../wasm";
 import {getFlags} from "../flags";
 import {inlineFunctions} from "./functions";
+import {foldPureCalls} from "./pure_calls";
+import {specialiseFunctionPointers} from "./specialise";
 
 export function interproceduralOptimise(module: ModuleBuilder): void {
     const flags = getFlags();
+    if (flags.specialise_function_pointers) specialiseFunctionPointers(module);
+    if (flags.fold_pure_calls) foldPureCalls(module);
     if (flags.inlining) inlineFunctions(module);
 }
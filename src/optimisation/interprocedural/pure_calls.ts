@@ -0,0 +1,477 @@
+import {ModuleBuilder, WFunction, WExpression, Instructions, i32Type, i64Type, f32Type, v128Type, ValueType} from "../../wasm";
+import type {funcidx} from "../../wasm/base_types";
+import {InstrInstance} from "../../wasm/instr_helpers";
+import {optimise} from "../index";
+import {removeUnusedFns} from "./functions";
+import {expressions} from "./specialise";
+
+const MAX_STEPS = 100000; // instructions executed for each call site
+const MAX_DEPTH = 64; // nested calls within each evaluation
+const MAX_ROUNDS = 4; // folding a call can make the arguments of other calls constant
+
+/**
+ * Evaluate calls to pure functions with constant arguments at compile time, e.g. isdigit('7') or abs(-3), replacing
+ * them with their results. Pure functions only use locals, arithmetic and calls to other pure functions, so they
+ * can't read memory or globals. The interpreter gives up on traps, NaN results and when it runs out of steps, leaving
+ * the call in place. The modified functions are optimised again, so constant-if and peephole passes use the results.
+ */
+export function foldPureCalls(module: ModuleBuilder): void {
+    const pure = pureFunctions(module);
+    if (pure.size === 0) return;
+
+    const interpreter = new Interpreter(module, pure);
+    const modified = new Set<WFunction>();
+    for (let round = 0, changed = true; changed && round < MAX_ROUNDS; round++) {
+        changed = false;
+        for (const fn of module.functions) {
+            if (!foldCalls(fn, interpreter)) continue;
+            optimise(fn);
+            modified.add(fn);
+            changed = true;
+        }
+    }
+
+    if (modified.size) removeUnusedFns(module);
+}
+
+function foldCalls(fn: WFunction, interpreter: Interpreter): boolean {
+    let folded = false;
+    for (const expr of expressions(fn.body)) {
+        for (let i = 0; i < expr.instructions.length; i++) {
+            const instr = expr.instructions[i];
+            if (instr.type !== "index" || instr.name !== "call") continue;
+            const callee = fn.parent._functionLookup(instr.immediate.value as funcidx);
+            if (!(callee instanceof WFunction) || !interpreter.pure.has(callee)) continue;
+
+            // constants take no operands, so the arguments are the instructions directly before the call
+            const argCount = callee.type[0].length;
+            const args = expr.instructions.slice(i - argCount, i);
+            if (i < argCount || !args.every(isScalarConstant)) continue;
+
+            const results = interpreter.evaluate(callee, args.map(x => constantValue(x)));
+            if (!results) continue;
+
+            const replacement = results.map((value, j) => constantInstr(callee.type[1][j], value));
+            expr.replace(i - argCount, i + 1, ...replacement);
+            i += replacement.length - argCount - 1;
+            folded = true;
+        }
+    }
+    return folded;
+}
+
+/** Functions which only use locals, arithmetic, control flow and calls to other pure functions */
+function pureFunctions(module: ModuleBuilder): Set<WFunction> {
+    const pure = new Set<WFunction>(), callees = new Map<WFunction, WFunction[]>();
+    for (const fn of module.functions) {
+        if (fn.hints.profile === "cold" || [...fn.type[0], ...fn.type[1], ...fn.locals].includes(v128Type)) continue;
+        const called: WFunction[] = [];
+        let allowed = true;
+        for (const instr of fn.body.instructionsRecursive()) {
+            if (instr.type === "index" && instr.name === "call") {
+                const callee = module._functionLookup(instr.immediate.value as funcidx);
+                if (callee instanceof WFunction) called.push(callee);
+                else allowed = false;
+            } else if (!interpretable(instr)) {
+                allowed = false;
+            }
+            if (!allowed) break;
+        }
+        if (!allowed) continue;
+        pure.add(fn);
+        callees.set(fn, called);
+    }
+
+    // remove functions calling impure functions until nothing changes, so recursive functions can be pure
+    for (let changed = true; changed;) {
+        changed = false;
+        for (const fn of pure) {
+            if ((callees.get(fn) as WFunction[]).every(x => pure.has(x))) continue;
+            pure.delete(fn);
+            changed = true;
+        }
+    }
+    return pure;
+}
+
+const CONTROL = new Set(["block", "loop", "if", "br", "br_if", "br_table", "return", "unreachable", "nop", "drop",
+    "local.get", "local.set", "local.tee", "call"]);
+
+function interpretable(instr: InstrInstance): boolean {
+    if (instr.type === "constant") return instr.name !== "v128.const";
+    if (instr.type === "zeroArg") return instr.name in OPS || CONTROL.has(instr.name);
+    return CONTROL.has(instr.name) && instr.name !== "call";
+}
+
+function isScalarConstant(instr: InstrInstance): boolean {
+    return instr.type === "constant" && instr.name !== "v128.const";
+}
+
+type Value = number | bigint;
+
+// i32 values are signed numbers, i64 values are signed bigints, f32 and f64 values are numbers
+function constantValue(instr: InstrInstance): Value {
+    const value = (instr.immediate as {value: number | bigint}).value;
+    if (instr.name === "i32.const") return Number(BigInt.asIntN(32, BigInt(value)));
+    if (instr.name === "i64.const") return BigInt.asIntN(64, BigInt(value));
+    return Number(value);
+}
+
+function constantInstr(type: ValueType, value: Value) {
+    if (type === i32Type) return Instructions.i32.const(value);
+    if (type === i64Type) return Instructions.i64.const(value as bigint);
+    if (type === f32Type) return Instructions.f32.const(value as number);
+    return Instructions.f64.const(value as number);
+}
+
+function zero(type: ValueType): Value {
+    return type === i64Type ? 0n : 0;
+}
+
+class Abort extends Error {
+}
+
+// how control leaves an expression: normally, branching out through `depth` more labels, or returning
+type Exit = undefined | {br: number} | "return";
+
+class Interpreter {
+    private steps = 0;
+    // results of previous evaluations, including failures, by function and arguments. rounds repeat the same calls
+    // and the passes keep the semantics of pure functions, so these stay valid
+    private readonly results = new Map<WFunction, Map<string, Value[] | undefined>>();
+
+    constructor(private readonly module: ModuleBuilder, readonly pure: ReadonlySet<WFunction>) {
+    }
+
+    /** Results of calling fn, or undefined if it traps, produces NaN or exceeds the budget */
+    evaluate(fn: WFunction, args: Value[]): Value[] | undefined {
+        let results = this.results.get(fn);
+        if (!results) this.results.set(fn, results = new Map());
+
+        // the argument types are fixed for each function, but String(-0) is "0"
+        const key = args.map(x => Object.is(x, -0) ? "-0" : String(x)).join(",");
+        if (!results.has(key)) results.set(key, this.evaluateUncached(fn, args));
+        return results.get(key);
+    }
+
+    private evaluateUncached(fn: WFunction, args: Value[]): Value[] | undefined {
+        this.steps = 0;
+        try {
+            const results = this.call(fn, args, 0);
+            // NaN payloads aren't preserved by JavaScript numbers
+            return results.some(x => typeof x === "number" && Number.isNaN(x)) ? undefined : results;
+        } catch (e) {
+            if (e instanceof Abort) return undefined;
+            throw e;
+        }
+    }
+
+    private call(fn: WFunction, args: Value[], depth: number): Value[] {
+        if (depth >= MAX_DEPTH) throw new Abort();
+
+        const locals = [...args, ...fn.locals.map(zero)];
+
+        const stack: Value[] = [];
+        this.run(fn.body, locals, stack, depth);
+        return stack.slice(stack.length - fn.type[1].length);
+    }
+
+    private run(expr: WExpression, locals: Value[], stack: Value[], depth: number): Exit {
+        for (const instr of expr.instructions) {
+            if (++this.steps > MAX_STEPS) throw new Abort();
+
+            if (instr.type === "constant") {
+                stack.push(constantValue(instr));
+            } else if (instr.type === "structured") {
+                const height = stack.length;
+                let exit: Exit;
+                if (instr.name === "loop") {
+                    while ((exit = this.run(instr.immediate.expression, locals, stack, depth)) !== undefined &&
+                           exit !== "return" && exit.br === 0) {
+                        stack.length = height;
+                    }
+                } else if (instr.name === "if") {
+                    const body = stack.pop() ? instr.immediate.expression : instr.immediate.expression2;
+                    exit = body ? this.run(body, locals, stack, depth) : undefined;
+                } else {
+                    exit = this.run(instr.immediate.expression, locals, stack, depth);
+                }
+
+                if (exit === "return") return exit;
+                if (exit !== undefined && exit.br > 0) return {br: exit.br - 1};
+                // branching to the end of the block keeps its result, dropping anything below it
+                const result = instr.immediate.type === null ? [] : [stack[stack.length - 1]];
+                stack.splice(instr.name === "if" ? height - 1 : height);
+                stack.push(...result);
+            } else if (instr.name === "local.get") {
+                stack.push(locals[Number(instr.immediate.value)]);
+            } else if (instr.name === "local.set") {
+                locals[Number(instr.immediate.value)] = stack.pop() as Value;
+            } else if (instr.name === "local.tee") {
+                locals[Number(instr.immediate.value)] = stack[stack.length - 1];
+            } else if (instr.name === "call") {
+                const callee = this.module._functionLookup(instr.immediate.value as funcidx) as WFunction;
+                const args = stack.splice(stack.length - callee.type[0].length);
+                stack.push(...this.call(callee, args, depth + 1));
+            } else if (instr.name === "br") {
+                return {br: Number(instr.immediate.value)};
+            } else if (instr.name === "br_if") {
+                if (stack.pop()) return {br: Number(instr.immediate.value)};
+            } else if (instr.type === "table") {
+                const i = stack.pop() as number >>> 0, {valueTable, defaultValue} = instr.immediate;
+                return {br: Number(i < valueTable.length ? valueTable[i] : defaultValue)};
+            } else if (instr.name === "return") {
+                return "return";
+            } else if (instr.name === "drop") {
+                stack.pop();
+            } else if (instr.name === "nop") {
+                // nothing
+            } else if (instr.name in OPS) {
+                const op = OPS[instr.name];
+                const operands = stack.splice(stack.length - op.length);
+                stack.push(op(...operands));
+            } else {
+                // unreachable, or anything pureFunctions should have excluded
+                throw new Abort();
+            }
+        }
+        return undefined;
+    }
+}
+
+// wasm numeric instructions, throwing Abort where they would trap
+/* eslint-disable @typescript-eslint/no-explicit-any */
+const OPS: {[name: string]: (...args: any[]) => Value} = {};
+
+const bool = (x: boolean) => x ? 1 : 0;
+const u32 = (x: number) => x >>> 0;
+const u64 = (x: bigint) => BigInt.asUintN(64, x);
+const i64 = (x: bigint) => BigInt.asIntN(64, x);
+const I32_MIN = -0x80000000, I64_MIN = -(2n ** 63n), I64_MAX = 2n ** 63n - 1n;
+
+function check(condition: boolean) {
+    if (!condition) throw new Abort();
+}
+
+function bits32(value: number, float: boolean): number {
+    const view = new DataView(new ArrayBuffer(4));
+    if (float) {
+        view.setInt32(0, value);
+        return view.getFloat32(0);
+    }
+    view.setFloat32(0, value);
+    return view.getInt32(0);
+}
+
+function bits64(value: Value, float: boolean): Value {
+    const view = new DataView(new ArrayBuffer(8));
+    if (float) {
+        view.setBigInt64(0, value as bigint);
+        return view.getFloat64(0);
+    }
+    view.setFloat64(0, value as number);
+    return view.getBigInt64(0);
+}
+
+function popcnt(x: bigint): bigint {
+    let count = 0n;
+    for (; x; x >>= 1n) count += x & 1n;
+    return count;
+}
+
+function clz64(x: bigint): bigint {
+    const high = Number(x >> 32n), low = Number(x & 0xFFFFFFFFn);
+    return BigInt(high ? Math.clz32(high) : 32 + Math.clz32(low));
+}
+
+function nearest(x: number): number {
+    if (!Number.isFinite(x) || x === 0) return x;
+    const r = Math.round(x); // rounds ties up, wasm rounds them to even
+    const result = r - x === 0.5 && r % 2 !== 0 ? r - 1 : r;
+    return result === 0 && x < 0 ? -0 : result;
+}
+
+// truncation to an integer type traps unless the result is in [min, max)
+function truncate(x: number, min: number, max: number): number {
+    const t = Math.trunc(x);
+    check(t >= min && t < max);
+    return t;
+}
+
+function saturate(x: number, min: number, max: number): number {
+    if (Number.isNaN(x)) return 0;
+    return Math.min(Math.max(Math.trunc(x), min), max);
+}
+
+// the i64 limits aren't doubles, so they're compared against the powers of two either side
+function saturate64(x: number, signed: boolean): bigint {
+    if (Number.isNaN(x)) return 0n;
+    const t = Math.trunc(x);
+    if (signed) return t < -(2 ** 63) ? I64_MIN : t >= 2 ** 63 ? I64_MAX : BigInt(t);
+    return t <= 0 ? 0n : t >= 2 ** 64 ? -1n : i64(BigInt(t));
+}
+
+Object.assign(OPS, {
+    "i32.eqz": (a: number) => bool(a === 0),
+    "i32.eq": (a: number, b: number) => bool(a === b),
+    "i32.ne": (a: number, b: number) => bool(a !== b),
+    "i32.lt_s": (a: number, b: number) => bool(a < b),
+    "i32.lt_u": (a: number, b: number) => bool(u32(a) < u32(b)),
+    "i32.gt_s": (a: number, b: number) => bool(a > b),
+    "i32.gt_u": (a: number, b: number) => bool(u32(a) > u32(b)),
+    "i32.le_s": (a: number, b: number) => bool(a <= b),
+    "i32.le_u": (a: number, b: number) => bool(u32(a) <= u32(b)),
+    "i32.ge_s": (a: number, b: number) => bool(a >= b),
+    "i32.ge_u": (a: number, b: number) => bool(u32(a) >= u32(b)),
+    "i32.clz": (a: number) => Math.clz32(a),
+    "i32.ctz": (a: number) => a === 0 ? 32 : 31 - Math.clz32(a & -a),
+    "i32.popcnt": (a: number) => Number(popcnt(BigInt(u32(a)))),
+    "i32.add": (a: number, b: number) => (a + b) | 0,
+    "i32.sub": (a: number, b: number) => (a - b) | 0,
+    "i32.mul": (a: number, b: number) => Math.imul(a, b),
+    "i32.div_s": (a: number, b: number) => {
+        check(b !== 0 && !(a === I32_MIN && b === -1));
+        return Math.trunc(a / b) | 0;
+    },
+    "i32.div_u": (a: number, b: number) => {
+        check(b !== 0);
+        return Math.trunc(u32(a) / u32(b)) | 0;
+    },
+    "i32.rem_s": (a: number, b: number) => {
+        check(b !== 0);
+        return (a % b) | 0;
+    },
+    "i32.rem_u": (a: number, b: number) => {
+        check(b !== 0);
+        return (u32(a) % u32(b)) | 0;
+    },
+    "i32.and": (a: number, b: number) => a & b,
+    "i32.or": (a: number, b: number) => a | b,
+    "i32.xor": (a: number, b: number) => a ^ b,
+    "i32.shl": (a: number, b: number) => a << b,
+    "i32.shr_s": (a: number, b: number) => a >> b,
+    "i32.shr_u": (a: number, b: number) => (a >>> b) | 0,
+    "i32.rotl": (a: number, b: number) => (a << b) | (a >>> (32 - (b & 31))),
+    "i32.rotr": (a: number, b: number) => (a >>> b) | (a << (32 - (b & 31))),
+    "i32.extend8_s": (a: number) => (a << 24) >> 24,
+    "i32.extend16_s": (a: number) => (a << 16) >> 16,
+    "i32.wrap_i64": (a: bigint) => Number(BigInt.asIntN(32, a)),
+    "i32.trunc_f32_s": (a: number) => truncate(a, I32_MIN, 2 ** 31),
+    "i32.trunc_f32_u": (a: number) => truncate(a, -0, 2 ** 32) | 0,
+    "i32.trunc_f64_s": (a: number) => truncate(a, I32_MIN, 2 ** 31),
+    "i32.trunc_f64_u": (a: number) => truncate(a, -0, 2 ** 32) | 0,
+    "i32.trunc_sat_f32_s": (a: number) => saturate(a, I32_MIN, 2 ** 31 - 1),
+    "i32.trunc_sat_f32_u": (a: number) => saturate(a, 0, 2 ** 32 - 1) | 0,
+    "i32.trunc_sat_f64_s": (a: number) => saturate(a, I32_MIN, 2 ** 31 - 1),
+    "i32.trunc_sat_f64_u": (a: number) => saturate(a, 0, 2 ** 32 - 1) | 0,
+    "i32.reinterpret_f32": (a: number) => {
+        check(!Number.isNaN(a)); // the payload has been lost
+        return bits32(a, false);
+    },
+
+    "i64.eqz": (a: bigint) => bool(a === 0n),
+    "i64.eq": (a: bigint, b: bigint) => bool(a === b),
+    "i64.ne": (a: bigint, b: bigint) => bool(a !== b),
+    "i64.lt_s": (a: bigint, b: bigint) => bool(a < b),
+    "i64.lt_u": (a: bigint, b: bigint) => bool(u64(a) < u64(b)),
+    "i64.gt_s": (a: bigint, b: bigint) => bool(a > b),
+    "i64.gt_u": (a: bigint, b: bigint) => bool(u64(a) > u64(b)),
+    "i64.le_s": (a: bigint, b: bigint) => bool(a <= b),
+    "i64.le_u": (a: bigint, b: bigint) => bool(u64(a) <= u64(b)),
+    "i64.ge_s": (a: bigint, b: bigint) => bool(a >= b),
+    "i64.ge_u": (a: bigint, b: bigint) => bool(u64(a) >= u64(b)),
+    "i64.clz": (a: bigint) => clz64(u64(a)),
+    "i64.ctz": (a: bigint) => a === 0n ? 64n : 63n - clz64(u64(a & -a)),
+    "i64.popcnt": (a: bigint) => popcnt(u64(a)),
+    "i64.add": (a: bigint, b: bigint) => i64(a + b),
+    "i64.sub": (a: bigint, b: bigint) => i64(a - b),
+    "i64.mul": (a: bigint, b: bigint) => i64(a * b),
+    "i64.div_s": (a: bigint, b: bigint) => {
+        check(b !== 0n && !(a === I64_MIN && b === -1n));
+        return a / b;
+    },
+    "i64.div_u": (a: bigint, b: bigint) => {
+        check(b !== 0n);
+        return i64(u64(a) / u64(b));
+    },
+    "i64.rem_s": (a: bigint, b: bigint) => {
+        check(b !== 0n);
+        return a % b;
+    },
+    "i64.rem_u": (a: bigint, b: bigint) => {
+        check(b !== 0n);
+        return i64(u64(a) % u64(b));
+    },
+    "i64.and": (a: bigint, b: bigint) => a & b,
+    "i64.or": (a: bigint, b: bigint) => a | b,
+    "i64.xor": (a: bigint, b: bigint) => a ^ b,
+    "i64.shl": (a: bigint, b: bigint) => i64(a << (b & 63n)),
+    "i64.shr_s": (a: bigint, b: bigint) => a >> (b & 63n),
+    "i64.shr_u": (a: bigint, b: bigint) => i64(u64(a) >> (b & 63n)),
+    "i64.rotl": (a: bigint, b: bigint) => i64((u64(a) << (b & 63n)) | (u64(a) >> ((64n - (b & 63n)) & 63n))),
+    "i64.rotr": (a: bigint, b: bigint) => i64((u64(a) >> (b & 63n)) | (u64(a) << ((64n - (b & 63n)) & 63n))),
+    "i64.extend8_s": (a: bigint) => BigInt.asIntN(8, a),
+    "i64.extend16_s": (a: bigint) => BigInt.asIntN(16, a),
+    "i64.extend32_s": (a: bigint) => BigInt.asIntN(32, a),
+    "i64.extend_i32_s": (a: number) => BigInt(a),
+    "i64.extend_i32_u": (a: number) => BigInt(u32(a)),
+    "i64.trunc_f32_s": (a: number) => BigInt(truncate(a, -(2 ** 63), 2 ** 63)),
+    "i64.trunc_f32_u": (a: number) => i64(BigInt(truncate(a, -0, 2 ** 64))),
+    "i64.trunc_f64_s": (a: number) => BigInt(truncate(a, -(2 ** 63), 2 ** 63)),
+    "i64.trunc_f64_u": (a: number) => i64(BigInt(truncate(a, -0, 2 ** 64))),
+    "i64.trunc_sat_f32_s": (a: number) => saturate64(a, true),
+    "i64.trunc_sat_f32_u": (a: number) => saturate64(a, false),
+    "i64.trunc_sat_f64_s": (a: number) => saturate64(a, true),
+    "i64.trunc_sat_f64_u": (a: number) => saturate64(a, false),
+    "i64.reinterpret_f64": (a: number) => {
+        check(!Number.isNaN(a));
+        return bits64(a, false);
+    },
+});
+
+// f32 arithmetic is exact in doubles before rounding, so only the results need rounding to f32
+for (const [type, round] of [["f32", Math.fround], ["f64", (x: number) => x]] as const) {
+    Object.assign(OPS, {
+        [`${type}.eq`]: (a: number, b: number) => bool(a === b),
+        [`${type}.ne`]: (a: number, b: number) => bool(a !== b),
+        [`${type}.lt`]: (a: number, b: number) => bool(a < b),
+        [`${type}.gt`]: (a: number, b: number) => bool(a > b),
+        [`${type}.le`]: (a: number, b: number) => bool(a <= b),
+        [`${type}.ge`]: (a: number, b: number) => bool(a >= b),
+        [`${type}.abs`]: (a: number) => Math.abs(a),
+        [`${type}.neg`]: (a: number) => -a,
+        [`${type}.ceil`]: (a: number) => Math.ceil(a),
+        [`${type}.floor`]: (a: number) => Math.floor(a),
+        [`${type}.trunc`]: (a: number) => Math.trunc(a),
+        [`${type}.nearest`]: (a: number) => nearest(a),
+        [`${type}.sqrt`]: (a: number) => round(Math.sqrt(a)),
+        [`${type}.add`]: (a: number, b: number) => round(a + b),
+        [`${type}.sub`]: (a: number, b: number) => round(a - b),
+        [`${type}.mul`]: (a: number, b: number) => round(a * b),
+        [`${type}.div`]: (a: number, b: number) => round(a / b),
+        [`${type}.min`]: (a: number, b: number) => Math.min(a, b),
+        [`${type}.max`]: (a: number, b: number) => Math.max(a, b),
+        [`${type}.copysign`]: (a: number, b: number) => {
+            check(!Number.isNaN(b)); // the sign of NaN has been lost
+            return b < 0 || Object.is(b, -0) ? -Math.abs(a) : Math.abs(a);
+        },
+        [`${type}.convert_i32_s`]: (a: number) => round(a),
+        [`${type}.convert_i32_u`]: (a: number) => round(u32(a)),
+        // converting to a double first could round twice, so only exact conversions are folded for f32
+        [`${type}.convert_i64_s`]: (a: bigint) => {
+            check(type === "f64" || (a >= -(2n ** 53n) && a <= 2n ** 53n));
+            return round(Number(a));
+        },
+        [`${type}.convert_i64_u`]: (a: bigint) => {
+            check(type === "f64" || u64(a) <= 2n ** 53n);
+            return round(Number(u64(a)));
+        },
+    });
+}
+
+Object.assign(OPS, {
+    "f32.demote_f64": (a: number) => Math.fround(a),
+    "f64.promote_f32": (a: number) => a,
+    "f32.reinterpret_i32": (a: number) => bits32(a, true),
+    "f64.reinterpret_i64": (a: bigint) => bits64(a, true),
+});
@@ -0,0 +1,148 @@
+import {ModuleBuilder, WFunction, WExpression, Instructions, WImportedFunction, i32Type} from "../../wasm";
+import type {funcidx, tableidx} from "../../wasm/base_types";
+import {InstrInstance, resultTypes} from "../../wasm/instr_helpers";
+import {remapLocals} from "../flow/local_allocation";
+import {peephole} from "../peephole";
+import {removeUnusedFns} from "./functions";
+
+const MAX_SIZE = 2000; // instructions in a function which can be cloned
+const MAX_CLONES = 8; // clones of each function
+
+/**
+ * Clone functions which are called with a constant function pointer that they only pass to call_indirect, e.g. qsort
+ * with a static comparator. Each clone replaces reads of the parameter with the constant and the indirect calls with
+ * direct calls, so the target can then be inlined. Calls from clones are specialised too, so the pointer is followed
+ * through helper functions and recursion.
+ */
+export function specialiseFunctionPointers(module: ModuleBuilder): void {
+    const clones = new Map<WFunction, Map<string, WFunction>>();
+    const params = new Map<WFunction, number[]>();
+    const pointerParams = (fn: WFunction) => {
+        let result = params.get(fn);
+        if (!result) params.set(fn, result = indirectParams(fn));
+        return result;
+    };
+
+    const queue = [...module.functions];
+    for (let i = 0; i < queue.length; i++) {
+        const fn = queue[i];
+        for (const [expr, index, funcIndex] of callSites(fn.body)) {
+            let callee = module._functionLookup(funcIndex);
+            if (!(callee instanceof WFunction) || callee.hints.profile === "cold") continue;
+
+            for (const param of pointerParams(callee)) {
+                const producer = operandProducer(expr, index, callee.type[0].length - 1 - param);
+                if (producer?.type !== "constant" || producer.name !== "i32.const") continue;
+                const tableIndex = BigInt(producer.immediate.value);
+                const target = module._tableLookup(tableIndex as tableidx);
+                if (!target) continue;
+
+                let fnClones = clones.get(callee);
+                if (!fnClones) clones.set(callee, fnClones = new Map());
+                const key = `${param}:${tableIndex}`;
+                let clone = fnClones.get(key);
+                if (!clone) {
+                    if (fnClones.size >= MAX_CLONES) continue;
+                    clone = cloneWithPointer(callee, param, tableIndex, target);
+                    fnClones.set(key, clone);
+                    queue.push(clone);
+                }
+
+                expr.replace(index, index + 1, Instructions.call(clone));
+                callee = clone;
+            }
+        }
+    }
+
+    if (clones.size) removeUnusedFns(module);
+}
+
+/** Parameters which are never written and are used as the function pointer for a call_indirect */
+function indirectParams(fn: WFunction): number[] {
+    if ([...fn.body.instructionsRecursive()].length > MAX_SIZE) return [];
+
+    const args = fn.body.builder.args;
+    const written = new Set<number>(), called = new Set<number>();
+    for (const expr of expressions(fn.body)) {
+        for (const [i, instr] of expr.instructions.entries()) {
+            if (instr.type !== "index") continue;
+            if (instr.name === "local.set" || instr.name === "local.tee") {
+                written.add(Number(instr.immediate.value));
+            } else if (instr.name === "call_indirect") {
+                const producer = operandProducer(expr, i, 0);
+                if (producer?.type === "index" && producer.name === "local.get" && Number(producer.immediate.value) < args.length) {
+                    called.add(Number(producer.immediate.value));
+                }
+            }
+        }
+    }
+    return [...called].filter(x => !written.has(x) && args[x].type === i32Type).sort((a, b) => a - b);
+}
+
+function cloneWithPointer(fn: WFunction, param: number, tableIndex: bigint, target: WFunction | WImportedFunction): WFunction {
+    const module = fn.parent;
+    const clone = module.function(fn.type[0], fn.type[1], b => {
+        fn.body.copyInto(b.expr);
+        remapLocals(b.expr, [...b.args, ...fn.locals.map(type => b.addLocal(type))]);
+
+        // the parameter is never written, so every read is the constant
+        const local = b.args[param];
+        peephole(b.expr, ([instr]) => {
+            if (instr.name === "local.get" && instr.reads[0] === local) return [Instructions.i32.const(tableIndex)];
+        }, 1);
+
+        const targetType = module._typeIndex(target.type);
+        for (const expr of expressions(b.expr)) {
+            for (let i = 0; i < expr.instructions.length; i++) {
+                const instr = expr.instructions[i];
+                if (instr.type !== "index" || instr.name !== "call_indirect" || instr.immediate.value !== targetType) continue;
+
+                // only the top operand is the table index, any instructions between it and the call are kept
+                const start = producerIndex(expr, i, 0);
+                const producer = expr.instructions[start];
+                if (producer?.type !== "constant" || producer.name !== "i32.const" || BigInt(producer.immediate.value) !== tableIndex) continue;
+                expr.replace(start, i + 1, ...expr.instructions.slice(start + 1, i), Instructions.call(target));
+                i--;
+            }
+        }
+        return [];
+    });
+
+    clone.hints.inline = fn.hints.inline;
+    clone.hints.profile = fn.hints.profile;
+    return clone;
+}
+
+export function* expressions(expr: WExpression): IterableIterator<WExpression> {
+    yield expr;
+    for (const instr of expr.instructions) {
+        if (instr.type === "structured") {
+            yield* expressions(instr.immediate.expression);
+            if (instr.immediate.expression2) yield* expressions(instr.immediate.expression2);
+        }
+    }
+}
+
+function* callSites(body: WExpression): IterableIterator<[WExpression, number, funcidx]> {
+    for (const expr of expressions(body)) {
+        for (const [i, instr] of expr.instructions.entries()) {
+            if (instr.type === "index" && instr.name === "call") yield [expr, i, instr.immediate.value as funcidx];
+        }
+    }
+}
+
+/** Index of the instruction which pushes the operand of instructions[index] with `above` other operands above it */
+function producerIndex(expr: WExpression, index: number, above: number): number {
+    for (let i = index - 1; i >= 0; i--) {
+        const instr = expr.instructions[i];
+        const results = resultTypes(instr).length;
+        if (above < results) return results === 1 ? i : -1;
+        above += instr.parameters.length - results;
+    }
+    return -1; // not within this expression
+}
+
+function operandProducer(expr: WExpression, index: number, above: number): InstrInstance | undefined {
+    const i = producerIndex(expr, index, above);
+    return i < 0 ? undefined : expr.instructions[i];
+}
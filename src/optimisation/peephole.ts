@@ -1,4 +1,4 @@
-import {Instructions, f32Type, f64Type, i32Type, WExpression, i64Type} from "../wasm";
+import {Instructions, f32Type, f64Type, i32Type, WExpression, i64Type, v128Type} from "../wasm";
 import {labelidx} from "../wasm/base_types";
 import {WLocal} from "../wasm/functions";
 import {InstrInstance, PartialInstr} from "../wasm/instr_helpers";
@@ -168,6 +168,7 @@ peepholeOptimisers.push({
     run: ([instr1, instr2, instr3]) => {
         // eslint-disable-next-line eqeqeq
         if (instr1.type !== "constant" || instr2.type !== "constant") return;
+        if (instr1.result === v128Type) return;
 
         let value;
         if (instr3.name.endsWith(".add")) {
@@ -0,0 +1,133 @@
+import {WExpression} from "../wasm";
+import {WLocal} from "../wasm/functions";
+import {InstrInstance, ReadResource, WriteResource, resultTypes} from "../wasm/instr_helpers";
+
+type LocalUses = {sets: number, gets: number, tees: number};
+type Effects = {reads: Set<ReadResource>, writes: Set<WriteResource>};
+
+// Keep single definition, single use locals on the operand stack. Given
+//   [value], local.set x, [between], local.get x
+// where [value] is a contiguous sequence of instructions which produces exactly one value, [value] is moved to replace
+// the local.get if it does not conflict with [between]. A local which is only written by a local.tee is also removed.
+export function stackify(expr: WExpression): void {
+    const uses = new Map<WLocal, LocalUses>();
+    for (const instr of expr.instructionsRecursive()) {
+        if (instr.type !== "index" || !instr.name.startsWith("local.")) continue;
+
+        const local = (instr.name === "local.get" ? instr.reads[0] : instr.writes[0]) as WLocal;
+        let use = uses.get(local);
+        if (!use) uses.set(local, use = {sets: 0, gets: 0, tees: 0});
+
+        if (instr.name === "local.get") use.gets++;
+        else if (instr.name === "local.set") use.sets++;
+        else if (instr.name === "local.tee") use.tees++;
+    }
+
+    stackifyExpression(expr, uses);
+}
+
+function stackifyExpression(expr: WExpression, uses: Map<WLocal, LocalUses>) {
+    for (const instr of expr.instructions) {
+        if (instr.type === "structured") {
+            stackifyExpression(instr.immediate.expression, uses);
+            if (instr.immediate.expression2) stackifyExpression(instr.immediate.expression2, uses);
+        }
+    }
+
+    // work backwards, as moving a value only changes instructions after the start of the value
+    for (let i = expr.instructions.length - 1; i >= 0; i--) {
+        const instr = expr.instructions[i];
+        if (instr.type !== "index" || (instr.name !== "local.set" && instr.name !== "local.tee")) continue;
+
+        const local = instr.writes[0] as WLocal;
+        if (local.isArgument) continue;
+        const use = uses.get(local) as LocalUses;
+
+        if (instr.name === "local.tee") {
+            // tee with no other uses, the value is already on the stack
+            if (use.sets === 0 && use.gets === 0 && use.tees === 1) {
+                expr.replace(i, i + 1);
+                uses.delete(local);
+            }
+            continue;
+        }
+        if (use.sets !== 1 || use.gets !== 1 || use.tees !== 0) continue;
+
+        const start = valueStart(expr, i);
+        if (start === undefined) continue;
+        const end = getIndex(expr, i, local);
+        if (end === undefined) continue;
+
+        const value = expr.instructions.slice(start, i);
+        const between = expr.instructions.slice(i + 1, end);
+        if (!canMove(value, between)) continue;
+
+        expr.replace(start, end + 1, ...between, ...value);
+        uses.delete(local);
+        i = start;
+    }
+}
+
+// find the start of the contiguous sequence of instructions ending before index which produces one value, without
+// consuming anything already on the stack
+function valueStart(expr: WExpression, index: number): number | undefined {
+    let needed = 1, start = index;
+    while (needed > 0) {
+        if (--start < 0) return undefined;
+
+        const instr = expr.instructions[start];
+        const results = resultTypes(instr).length;
+        if (results > needed) return undefined; // produces more than the one value
+        needed += instr.parameters.length - results;
+    }
+    return start;
+}
+
+// index of the only local.get, if it is at the same level as the local.set
+function getIndex(expr: WExpression, index: number, local: WLocal): number | undefined {
+    for (let i = index + 1; i < expr.instructions.length; i++) {
+        const instr = expr.instructions[i];
+        if (instr.name === "local.get" && instr.reads[0] === local) return i;
+        if (instr.type === "structured" && instr.reads.includes(local)) return undefined;
+    }
+    return undefined;
+}
+
+function canMove(value: InstrInstance[], between: InstrInstance[]): boolean {
+    for (const instr of value) {
+        // moving control flow (other than calls which return normally) would change which code is executed
+        if (instr.name === "unreachable") return false;
+        if (instr.name === "call" || instr.name === "call_indirect") continue;
+        if (instr.writes.includes("jump") || instr.writes.includes("arbitraryCode")) return false;
+    }
+
+    const v = effects(value), b = effects(between);
+    if (hasSideEffects(v) && (b.writes.size > 0 || readsNonLocal(b))) return false;
+    if (hasSideEffects(b) && (v.writes.size > 0 || readsNonLocal(v))) return false;
+
+    for (const write of v.writes) {
+        if (b.reads.has(write as ReadResource) || b.writes.has(write)) return false;
+    }
+    for (const write of b.writes) {
+        if (v.reads.has(write as ReadResource)) return false;
+    }
+    return true;
+}
+
+function effects(instructions: InstrInstance[]): Effects {
+    return {
+        reads: new Set(instructions.flatMap(x => x.reads)),
+        writes: new Set(instructions.flatMap(x => x.writes))
+    };
+}
+
+function hasSideEffects({writes}: Effects): boolean {
+    return writes.has("jump") || writes.has("arbitraryCode");
+}
+
+function readsNonLocal({reads}: Effects): boolean {
+    for (const read of reads) {
+        if (!(read instanceof WLocal)) return true;
+    }
+    return false;
+}
@@ -4,6 +4,9 @@ import {lexer, Location} from "./lexer";
 import * as parsetree from "./parsetree";
 import {validate} from "./validation";
 
+// typedefs provided by the compiler, see INTERNAL_TYPES in ir/internal_scope.ts
+const BUILTIN_TYPES = ["__v128"];
+
 // adapt lexer to work with Jison
 class WrappedLexer {
     yytext?: string;
@@ -30,6 +33,7 @@ class WrappedLexer {
         this.yylloc = undefined;
         this.yylineno = undefined;
         this.types.clear();
+        for (const name of BUILTIN_TYPES) this.types.set(name, true);
 
         lexer.reset(input);
     }
@@ -0,0 +1,21 @@
+/** Encoded module bytes, compiled by the engine at most once however many times the module is instantiated */
+export class CompiledModule {
+    private _module?: Promise<WebAssembly.Module>;
+
+    constructor(private readonly bytes: Uint8Array) {
+    }
+
+    toBytes(): Uint8Array {
+        return this.bytes;
+    }
+
+    compileModule(): Promise<WebAssembly.Module> {
+        if (this._module === undefined) this._module = WebAssembly.compile(this.bytes);
+        return this._module;
+    }
+
+    async execute(imports: WebAssembly.Imports): Promise<WebAssembly.Exports> {
+        const instance = await WebAssembly.instantiate(await this.compileModule(), imports);
+        return instance.exports;
+    }
+}
@@ -44,6 +44,18 @@ export function encodeInt64Constant(n: bigint): byte[] {
     return signedLeb128(n) as byte[];
 }
 
+// 128 bit vector constant, stored as 16 little endian bytes
+export function encodeV128Constant(n: bigint): byte[] {
+    if (n < 0n) n += 2n ** 128n;
+    if (n >= 2n ** 128n || n < 0n) {
+        throw new Error(`Value ${n} outside of range for 128bit vector`);
+    }
+
+    const bytes: byte[] = [];
+    for (let i = 0; i < 16; i++, n >>= 8n) bytes.push(Number(n & 0xFFn) as byte);
+    return bytes;
+}
+
 export function encodeConstantInstr(n: number | bigint, type: ValueType): byte[] {
     if (type === i32Type) {
         return [0x41 as byte, ...encodeInt32Constant(n)];
@@ -0,0 +1,20 @@
+// Minimal module with a function returning v128.const 0, which only validates if the engine supports fixed-width SIMD
+const SIMD128_MODULE = new Uint8Array([
+    0x00, 0x61, 0x73, 0x6D, 0x01, 0x00, 0x00, 0x00, // magic & version
+    0x01, 0x05, 0x01, 0x60, 0x00, 0x01, 0x7B, // type section: [] -> [v128]
+    0x03, 0x02, 0x01, 0x00, // function section
+    0x0A, 0x16, 0x01, 0x14, 0x00, 0xFD, 0x0C, ...new Array(16).fill(0), 0x0B // code section
+]);
+
+let simd128: boolean | undefined;
+
+export function simd128Supported(): boolean {
+    if (simd128 === undefined) {
+        try {
+            simd128 = WebAssembly.validate(SIMD128_MODULE);
+        } catch (e) {
+            simd128 = false;
+        }
+    }
+    return simd128;
+}
@@ -22,10 +22,19 @@ export class WImportedFunction {
 
 export class WFunction {
     private _builder?: WFunctionBuilder;
-    readonly hints: {inline: boolean} = {inline: false};
+    readonly hints: {inline: boolean, profile?: "hot" | "cold"} = {inline: false};
     readonly instrCounts: {name: string, count: number}[] = [];
 
-    constructor(readonly parent: ModuleBuilder, readonly type: FunctionType, readonly exportName?: string) {
+    constructor(readonly parent: ModuleBuilder, readonly type: FunctionType, private _exportName?: string) {
+    }
+
+    get exportName(): string | undefined {
+        return this._exportName;
+    }
+
+    set exportName(name: string | undefined) {
+        this._exportName = name;
+        this.parent.changed();
     }
 
     getIndex(): funcidx {
@@ -53,6 +62,7 @@ export class WFunction {
                 expr.push(Instructions.unreachable());
             }
         }
+        this.parent.changed();
     }
 
     toBytes(): byte[] {
@@ -110,6 +120,7 @@ export class WFunctionBuilder {
     addLocal(t: ValueType): WLocal {
         const local = new WLocal(this._localidx.bind(this), t, false);
         this._locals.push(local);
+        this.fn.parent.changed();
         return local;
     }
 
@@ -136,11 +147,13 @@ export class WFunctionBuilder {
         // WARNING! this will invalidate any instructions already encoded
         const index = this._locals.indexOf(local);
         if (index >= 0) this._locals.splice(index, 1);
+        this.fn.parent.changed();
     }
 
     wipeLocals(): void {
         // WARNING! this will invalidate any instructions already encoded
         this._locals.splice(0, this._locals.length);
+        this.fn.parent.changed();
     }
 
     get args(): ReadonlyArray<WLocal> {
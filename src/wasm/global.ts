@@ -8,10 +8,19 @@ export class WGlobal {
     constructor(readonly module: ModuleBuilder,
                 readonly type: ValueType,
                 readonly mutable: boolean,
-                public initialValue: number | bigint,
+                private _initialValue: number | bigint,
                 readonly exportName?: string) {
     }
 
+    get initialValue(): number | bigint {
+        return this._initialValue;
+    }
+
+    set initialValue(value: number | bigint) {
+        this._initialValue = value;
+        this.module.changed();
+    }
+
     getIndex(): globalidx {
         return this.module._globalIndex(this);
     }
@@ -1,4 +1,5 @@
-export {i32Type, i64Type, f32Type, f64Type, ValueType} from "./wtypes";
+export {i32Type, i64Type, f32Type, f64Type, v128Type, ValueType} from "./wtypes";
 export {Instructions, WExpression} from "./instructions";
 export {ModuleBuilder} from "./module";
+export {CompiledModule} from "./compiled";
 export {WFunctionBuilder, WFunction, WImportedFunction} from "./functions";
@@ -26,6 +26,8 @@ export interface BaseInstance<T extends BaseInstance<T>> {
     readonly parameters: ReadonlyArray<ValueType>;
     /* Value pushed onto stack if any */
     readonly result: ValueType | null;
+    /* Values pushed onto stack by instructions with multiple results (multi-value calls), result is null if present */
+    readonly results?: ReadonlyArray<ValueType>;
 
     readonly reads: ReadonlyArray<ReadResource>;
     /* Resource written to */
@@ -35,7 +37,13 @@ export interface BaseInstance<T extends BaseInstance<T>> {
     copy(): InstrContext<T>;
 }
 
-export type InstrInstance = ZeroArgInstance | ConstantInstance<bigint | number> | MemInstance | IdxInstance | TableInstance | StructureInstance;
+/* All the values pushed onto the stack by an instruction */
+export function resultTypes(instr: InstrInstance): ReadonlyArray<ValueType> {
+    if (instr.results) return instr.results;
+    return instr.result === null ? [] : [instr.result];
+}
+
+export type InstrInstance = ZeroArgInstance | ConstantInstance<bigint | number> | MemInstance | LaneInstance | IdxInstance | TableInstance | StructureInstance;
 
 // Zero argument instructions
 interface ZeroArgInstance extends BaseInstance<ZeroArgInstance> {
@@ -59,7 +67,7 @@ export function zeroArgs(name: string, opcode: number[], parameters: ReadonlyArr
     return () => () => instr;
 }
 
-type DataFlow = {parameters: ValueType[], result: ValueType | null, reads: ReadResource[], writes: WriteResource[]};
+type DataFlow = {parameters: ValueType[], result: ValueType | null, results?: ValueType[], reads: ReadResource[], writes: WriteResource[]};
 export function zeroArgsSpecial(name: string, opcode: number[], specialFn: InstrContext<DataFlow>): () => InstrContext<ZeroArgInstance> {
     return () => (context) => {
         const {parameters, result, reads, writes} = specialFn(context);
@@ -129,6 +137,34 @@ export function memArg(name: string, opcode: number[],
     };
 }
 
+// SIMD lane index instructions, e.g. extract_lane or shuffle
+interface LaneInstance extends BaseInstance<LaneInstance> {
+    type: "lane";
+    immediate: {readonly lanes: ReadonlyArray<number>};
+}
+
+export function laneArg(name: string, opcode: number[], parameters: ReadonlyArray<ValueType>, result: ValueType,
+                        laneCount: number, maxLane: number): (...lanes: number[]) => InstrContext<LaneInstance> {
+    return (...lanes) => {
+        if (lanes.length !== laneCount || lanes.some(x => !Number.isInteger(x) || x < 0 || x > maxLane)) {
+            throw new Error(`Invalid lane immediate for ${name}: ${lanes.join(", ")}`);
+        }
+
+        const instr: LaneInstance = {
+            name, type: "lane",
+            immediate: {lanes},
+            encoded: [...opcode, ...lanes] as byte[],
+            parameters, result,
+            reads: [], writes: [],
+
+            copy() {
+                return () => this;
+            }
+        };
+        return () => instr;
+    };
+}
+
 // Index argument instructions
 
 // either an index (instance of T), an object with a getter for the index
@@ -157,12 +193,12 @@ export function idxArg<T extends bigint, X extends any[]>(name: string, opcode:
     return (x, ...extra) => context => {
         const value = getIndex(x, context.depth);
         const encoded = [...opcode as byte[], ...encodeU32(value), ...suffix as byte[]];
-        const {parameters, result, reads, writes} = stackOps({value, extra, ...context});
+        const {parameters, result, results, reads, writes} = stackOps({value, extra, ...context});
 
         return {
             name, encoded,
             type: "index", immediate: {value},
-            parameters, result,
+            parameters, result, results,
             reads, writes,
 
             copy() {
@@ -320,6 +356,7 @@ export class WExpression {
         for (const instrFn of items) {
             this._instructions.push(this.createInstr(instrFn, this._stack));
         }
+        this.builder.fn.parent.changed();
     }
 
     get(index: number): InstrInstance {
@@ -331,8 +368,9 @@ export class WExpression {
         const instr = this._instructions.pop();
         if (!instr) return undefined;
 
-        if (instr.result) this._stack.pop();
+        this._stack.splice(this._stack.length - resultTypes(instr).length);
         this._stack.push(...instr.parameters);
+        this.builder.fn.parent.changed();
         return instr;
     }
 
@@ -362,6 +400,7 @@ export class WExpression {
             }
 
             this._instructions = instructions;
+            this.builder.fn.parent.changed();
         } catch (e) {
             throw new Error(`Invalid replacement due to: \n\n${e.stack}\n`);
         }
@@ -388,8 +427,8 @@ export class WExpression {
                 throw new Error(`Stack does not match Wasm instruction (${instr.name}) parameters\nPrevious instructions: ${this._instructions.map(x => x.name).reverse().join(", ")}`);
             }
         }
-        // push result if any
-        if (instr.result) stack.push(instr.result);
+        // push results if any
+        stack.push(...resultTypes(instr));
     }
 
     private createInstr(instr: PartialInstr | InstrInstance, stack: ValueType[]): InstrInstance {
@@ -1,11 +1,24 @@
 import {labelidx, funcidx, typeidx, localidx, globalidx} from "./base_types";
-import {encodeF32, encodeF64, encodeInt64Constant, encodeInt32Constant} from "./encoding";
-import {zeroArgs, blockLoopInstr, ifInstr, idxArg, zeroArgsSpecial, memArg, constantArg, PartialInstr, brTableInstr} from "./instr_helpers";
-import {i32Type, i64Type, f32Type, f64Type, ValueType} from "./wtypes";
+import {encodeF32, encodeF64, encodeInt64Constant, encodeInt32Constant, encodeU32, encodeV128Constant} from "./encoding";
+import {zeroArgs, blockLoopInstr, ifInstr, idxArg, zeroArgsSpecial, memArg, constantArg, PartialInstr, brTableInstr, laneArg} from "./instr_helpers";
+import {i32Type, i64Type, f32Type, f64Type, v128Type, ValueType} from "./wtypes";
 
 export type WInstruction = PartialInstr;
 export {WExpression} from "./instr_helpers";
 
+// SIMD instructions use the 0xFD prefix followed by a u32 opcode
+function simd(opcode: number): number[] {
+    return [0xFD, ...encodeU32(BigInt(opcode))];
+}
+
+const V = v128Type;
+
+// functions returning more than one value use results instead of result
+function callResults(results: ValueType[]): {result: ValueType | null, results?: ValueType[]} {
+    if (results.length > 1) return {result: null, results};
+    return {result: results[0] ?? null};
+}
+
 export const Instructions = {
     // control instructions
     unreachable: zeroArgs("unreachable", [0x00], [], null),
@@ -29,11 +42,11 @@ export const Instructions = {
     })),
     call: idxArg<funcidx, []>("call", [0x10], [], ({builder, value}) => {
         const func = builder.fn.parent._functionLookup(value); // function that we are calling may write to memory
-        return {parameters: func.type[0], result: func.type[1][0] ?? null, reads: [], writes: ["jump", "memory"]};
+        return {parameters: func.type[0], ...callResults(func.type[1]), reads: [], writes: ["jump", "memory"]};
     }),
     call_indirect: idxArg<typeidx, []>("call_indirect", [0x11], [0x00], ({builder, value}) => {
         const type = builder.fn.parent._typeLookup(value);
-        return {parameters: [...type[0], i32Type], result: type[1][0] ?? null, reads: [], writes: ["jump", "memory"]};
+        return {parameters: [...type[0], i32Type], ...callResults(type[1]), reads: [], writes: ["jump", "memory"]};
     }),
 
 
@@ -204,10 +217,10 @@ export const Instructions = {
         extend32_s: zeroArgs("i64.extend32_s", [0xC4], [i64Type], i64Type),
 
         // Non-trapping Float-to-int Conversions
-        trunc_sat_f32_s: zeroArgs("i32.trunc_sat_f32_s", [0xFC, 4], [f32Type], i64Type),
-        trunc_sat_f32_u: zeroArgs("i32.trunc_sat_f32_u", [0xFC, 5], [f32Type], i64Type),
-        trunc_sat_f64_s: zeroArgs("i32.trunc_sat_f64_s", [0xFC, 6], [f64Type], i64Type),
-        trunc_sat_f64_u: zeroArgs("i32.trunc_sat_f64_u", [0xFC, 7], [f64Type], i64Type),
+        trunc_sat_f32_s: zeroArgs("i64.trunc_sat_f32_s", [0xFC, 4], [f32Type], i64Type),
+        trunc_sat_f32_u: zeroArgs("i64.trunc_sat_f32_u", [0xFC, 5], [f32Type], i64Type),
+        trunc_sat_f64_s: zeroArgs("i64.trunc_sat_f64_s", [0xFC, 6], [f64Type], i64Type),
+        trunc_sat_f64_u: zeroArgs("i64.trunc_sat_f64_u", [0xFC, 7], [f64Type], i64Type),
     } as const,
 
     f32: {
@@ -282,6 +295,249 @@ export const Instructions = {
         promote_f32: zeroArgs("f64.promote_f32", [0xBB], [f32Type], f64Type),
 
         reinterpret_i64: zeroArgs("f64.reinterpret_i64", [0xBF], [i64Type], f64Type),
+    } as const,
+
+
+    // Fixed-width SIMD
+    v128: {
+        load: memArg("v128.load", simd(0x00), "load", V),
+        load8x8_s: memArg("v128.load8x8_s", simd(0x01), "load", V),
+        load8x8_u: memArg("v128.load8x8_u", simd(0x02), "load", V),
+        load16x4_s: memArg("v128.load16x4_s", simd(0x03), "load", V),
+        load16x4_u: memArg("v128.load16x4_u", simd(0x04), "load", V),
+        load32x2_s: memArg("v128.load32x2_s", simd(0x05), "load", V),
+        load32x2_u: memArg("v128.load32x2_u", simd(0x06), "load", V),
+        load8_splat: memArg("v128.load8_splat", simd(0x07), "load", V),
+        load16_splat: memArg("v128.load16_splat", simd(0x08), "load", V),
+        load32_splat: memArg("v128.load32_splat", simd(0x09), "load", V),
+        load64_splat: memArg("v128.load64_splat", simd(0x0A), "load", V),
+        store: memArg("v128.store", simd(0x0B), "store", V),
+
+        const: constantArg<bigint>("v128.const", simd(0x0C), encodeV128Constant, BigInt, V),
+
+        not: zeroArgs("v128.not", simd(0x4D), [V], V),
+        and: zeroArgs("v128.and", simd(0x4E), [V, V], V),
+        andnot: zeroArgs("v128.andnot", simd(0x4F), [V, V], V),
+        or: zeroArgs("v128.or", simd(0x50), [V, V], V),
+        xor: zeroArgs("v128.xor", simd(0x51), [V, V], V),
+        bitselect: zeroArgs("v128.bitselect", simd(0x52), [V, V, V], V),
+        any_true: zeroArgs("v128.any_true", simd(0x53), [V], i32Type),
+    } as const,
+
+    i8x16: {
+        shuffle: laneArg("i8x16.shuffle", simd(0x0D), [V, V], V, 16, 31),
+        swizzle: zeroArgs("i8x16.swizzle", simd(0x0E), [V, V], V),
+        splat: zeroArgs("i8x16.splat", simd(0x0F), [i32Type], V),
+        extract_lane_s: laneArg("i8x16.extract_lane_s", simd(0x15), [V], i32Type, 1, 15),
+        extract_lane_u: laneArg("i8x16.extract_lane_u", simd(0x16), [V], i32Type, 1, 15),
+        replace_lane: laneArg("i8x16.replace_lane", simd(0x17), [V, i32Type], V, 1, 15),
+
+        eq: zeroArgs("i8x16.eq", simd(0x23), [V, V], V),
+        ne: zeroArgs("i8x16.ne", simd(0x24), [V, V], V),
+        lt_s: zeroArgs("i8x16.lt_s", simd(0x25), [V, V], V),
+        lt_u: zeroArgs("i8x16.lt_u", simd(0x26), [V, V], V),
+        gt_s: zeroArgs("i8x16.gt_s", simd(0x27), [V, V], V),
+        gt_u: zeroArgs("i8x16.gt_u", simd(0x28), [V, V], V),
+        le_s: zeroArgs("i8x16.le_s", simd(0x29), [V, V], V),
+        le_u: zeroArgs("i8x16.le_u", simd(0x2A), [V, V], V),
+        ge_s: zeroArgs("i8x16.ge_s", simd(0x2B), [V, V], V),
+        ge_u: zeroArgs("i8x16.ge_u", simd(0x2C), [V, V], V),
+
+        abs: zeroArgs("i8x16.abs", simd(0x60), [V], V),
+        neg: zeroArgs("i8x16.neg", simd(0x61), [V], V),
+        popcnt: zeroArgs("i8x16.popcnt", simd(0x62), [V], V),
+        all_true: zeroArgs("i8x16.all_true", simd(0x63), [V], i32Type),
+        bitmask: zeroArgs("i8x16.bitmask", simd(0x64), [V], i32Type),
+        narrow_i16x8_s: zeroArgs("i8x16.narrow_i16x8_s", simd(0x65), [V, V], V),
+        narrow_i16x8_u: zeroArgs("i8x16.narrow_i16x8_u", simd(0x66), [V, V], V),
+        shl: zeroArgs("i8x16.shl", simd(0x6B), [V, i32Type], V),
+        shr_s: zeroArgs("i8x16.shr_s", simd(0x6C), [V, i32Type], V),
+        shr_u: zeroArgs("i8x16.shr_u", simd(0x6D), [V, i32Type], V),
+        add: zeroArgs("i8x16.add", simd(0x6E), [V, V], V),
+        add_sat_s: zeroArgs("i8x16.add_sat_s", simd(0x6F), [V, V], V),
+        add_sat_u: zeroArgs("i8x16.add_sat_u", simd(0x70), [V, V], V),
+        sub: zeroArgs("i8x16.sub", simd(0x71), [V, V], V),
+        sub_sat_s: zeroArgs("i8x16.sub_sat_s", simd(0x72), [V, V], V),
+        sub_sat_u: zeroArgs("i8x16.sub_sat_u", simd(0x73), [V, V], V),
+        min_s: zeroArgs("i8x16.min_s", simd(0x76), [V, V], V),
+        min_u: zeroArgs("i8x16.min_u", simd(0x77), [V, V], V),
+        max_s: zeroArgs("i8x16.max_s", simd(0x78), [V, V], V),
+        max_u: zeroArgs("i8x16.max_u", simd(0x79), [V, V], V),
+        avgr_u: zeroArgs("i8x16.avgr_u", simd(0x7B), [V, V], V),
+    } as const,
+
+    i16x8: {
+        splat: zeroArgs("i16x8.splat", simd(0x10), [i32Type], V),
+        extract_lane_s: laneArg("i16x8.extract_lane_s", simd(0x18), [V], i32Type, 1, 7),
+        extract_lane_u: laneArg("i16x8.extract_lane_u", simd(0x19), [V], i32Type, 1, 7),
+        replace_lane: laneArg("i16x8.replace_lane", simd(0x1A), [V, i32Type], V, 1, 7),
+
+        eq: zeroArgs("i16x8.eq", simd(0x2D), [V, V], V),
+        ne: zeroArgs("i16x8.ne", simd(0x2E), [V, V], V),
+        lt_s: zeroArgs("i16x8.lt_s", simd(0x2F), [V, V], V),
+        lt_u: zeroArgs("i16x8.lt_u", simd(0x30), [V, V], V),
+        gt_s: zeroArgs("i16x8.gt_s", simd(0x31), [V, V], V),
+        gt_u: zeroArgs("i16x8.gt_u", simd(0x32), [V, V], V),
+        le_s: zeroArgs("i16x8.le_s", simd(0x33), [V, V], V),
+        le_u: zeroArgs("i16x8.le_u", simd(0x34), [V, V], V),
+        ge_s: zeroArgs("i16x8.ge_s", simd(0x35), [V, V], V),
+        ge_u: zeroArgs("i16x8.ge_u", simd(0x36), [V, V], V),
+
+        abs: zeroArgs("i16x8.abs", simd(0x80), [V], V),
+        neg: zeroArgs("i16x8.neg", simd(0x81), [V], V),
+        all_true: zeroArgs("i16x8.all_true", simd(0x83), [V], i32Type),
+        bitmask: zeroArgs("i16x8.bitmask", simd(0x84), [V], i32Type),
+        narrow_i32x4_s: zeroArgs("i16x8.narrow_i32x4_s", simd(0x85), [V, V], V),
+        narrow_i32x4_u: zeroArgs("i16x8.narrow_i32x4_u", simd(0x86), [V, V], V),
+        extend_low_i8x16_s: zeroArgs("i16x8.extend_low_i8x16_s", simd(0x87), [V], V),
+        extend_high_i8x16_s: zeroArgs("i16x8.extend_high_i8x16_s", simd(0x88), [V], V),
+        extend_low_i8x16_u: zeroArgs("i16x8.extend_low_i8x16_u", simd(0x89), [V], V),
+        extend_high_i8x16_u: zeroArgs("i16x8.extend_high_i8x16_u", simd(0x8A), [V], V),
+        shl: zeroArgs("i16x8.shl", simd(0x8B), [V, i32Type], V),
+        shr_s: zeroArgs("i16x8.shr_s", simd(0x8C), [V, i32Type], V),
+        shr_u: zeroArgs("i16x8.shr_u", simd(0x8D), [V, i32Type], V),
+        add: zeroArgs("i16x8.add", simd(0x8E), [V, V], V),
+        add_sat_s: zeroArgs("i16x8.add_sat_s", simd(0x8F), [V, V], V),
+        add_sat_u: zeroArgs("i16x8.add_sat_u", simd(0x90), [V, V], V),
+        sub: zeroArgs("i16x8.sub", simd(0x91), [V, V], V),
+        sub_sat_s: zeroArgs("i16x8.sub_sat_s", simd(0x92), [V, V], V),
+        sub_sat_u: zeroArgs("i16x8.sub_sat_u", simd(0x93), [V, V], V),
+        mul: zeroArgs("i16x8.mul", simd(0x95), [V, V], V),
+        min_s: zeroArgs("i16x8.min_s", simd(0x96), [V, V], V),
+        min_u: zeroArgs("i16x8.min_u", simd(0x97), [V, V], V),
+        max_s: zeroArgs("i16x8.max_s", simd(0x98), [V, V], V),
+        max_u: zeroArgs("i16x8.max_u", simd(0x99), [V, V], V),
+        avgr_u: zeroArgs("i16x8.avgr_u", simd(0x9B), [V, V], V),
+    } as const,
+
+    i32x4: {
+        splat: zeroArgs("i32x4.splat", simd(0x11), [i32Type], V),
+        extract_lane: laneArg("i32x4.extract_lane", simd(0x1B), [V], i32Type, 1, 3),
+        replace_lane: laneArg("i32x4.replace_lane", simd(0x1C), [V, i32Type], V, 1, 3),
+
+        eq: zeroArgs("i32x4.eq", simd(0x37), [V, V], V),
+        ne: zeroArgs("i32x4.ne", simd(0x38), [V, V], V),
+        lt_s: zeroArgs("i32x4.lt_s", simd(0x39), [V, V], V),
+        lt_u: zeroArgs("i32x4.lt_u", simd(0x3A), [V, V], V),
+        gt_s: zeroArgs("i32x4.gt_s", simd(0x3B), [V, V], V),
+        gt_u: zeroArgs("i32x4.gt_u", simd(0x3C), [V, V], V),
+        le_s: zeroArgs("i32x4.le_s", simd(0x3D), [V, V], V),
+        le_u: zeroArgs("i32x4.le_u", simd(0x3E), [V, V], V),
+        ge_s: zeroArgs("i32x4.ge_s", simd(0x3F), [V, V], V),
+        ge_u: zeroArgs("i32x4.ge_u", simd(0x40), [V, V], V),
+
+        abs: zeroArgs("i32x4.abs", simd(0xA0), [V], V),
+        neg: zeroArgs("i32x4.neg", simd(0xA1), [V], V),
+        all_true: zeroArgs("i32x4.all_true", simd(0xA3), [V], i32Type),
+        bitmask: zeroArgs("i32x4.bitmask", simd(0xA4), [V], i32Type),
+        extend_low_i16x8_s: zeroArgs("i32x4.extend_low_i16x8_s", simd(0xA7), [V], V),
+        extend_high_i16x8_s: zeroArgs("i32x4.extend_high_i16x8_s", simd(0xA8), [V], V),
+        extend_low_i16x8_u: zeroArgs("i32x4.extend_low_i16x8_u", simd(0xA9), [V], V),
+        extend_high_i16x8_u: zeroArgs("i32x4.extend_high_i16x8_u", simd(0xAA), [V], V),
+        shl: zeroArgs("i32x4.shl", simd(0xAB), [V, i32Type], V),
+        shr_s: zeroArgs("i32x4.shr_s", simd(0xAC), [V, i32Type], V),
+        shr_u: zeroArgs("i32x4.shr_u", simd(0xAD), [V, i32Type], V),
+        add: zeroArgs("i32x4.add", simd(0xAE), [V, V], V),
+        sub: zeroArgs("i32x4.sub", simd(0xB1), [V, V], V),
+        mul: zeroArgs("i32x4.mul", simd(0xB5), [V, V], V),
+        min_s: zeroArgs("i32x4.min_s", simd(0xB6), [V, V], V),
+        min_u: zeroArgs("i32x4.min_u", simd(0xB7), [V, V], V),
+        max_s: zeroArgs("i32x4.max_s", simd(0xB8), [V, V], V),
+        max_u: zeroArgs("i32x4.max_u", simd(0xB9), [V, V], V),
+        dot_i16x8_s: zeroArgs("i32x4.dot_i16x8_s", simd(0xBA), [V, V], V),
+
+        trunc_sat_f32x4_s: zeroArgs("i32x4.trunc_sat_f32x4_s", simd(0xF8), [V], V),
+        trunc_sat_f32x4_u: zeroArgs("i32x4.trunc_sat_f32x4_u", simd(0xF9), [V], V),
+    } as const,
+
+    i64x2: {
+        splat: zeroArgs("i64x2.splat", simd(0x12), [i64Type], V),
+        extract_lane: laneArg("i64x2.extract_lane", simd(0x1D), [V], i64Type, 1, 1),
+        replace_lane: laneArg("i64x2.replace_lane", simd(0x1E), [V, i64Type], V, 1, 1),
+
+        eq: zeroArgs("i64x2.eq", simd(0xD6), [V, V], V),
+        ne: zeroArgs("i64x2.ne", simd(0xD7), [V, V], V),
+        lt_s: zeroArgs("i64x2.lt_s", simd(0xD8), [V, V], V),
+        gt_s: zeroArgs("i64x2.gt_s", simd(0xD9), [V, V], V),
+        le_s: zeroArgs("i64x2.le_s", simd(0xDA), [V, V], V),
+        ge_s: zeroArgs("i64x2.ge_s", simd(0xDB), [V, V], V),
+
+        abs: zeroArgs("i64x2.abs", simd(0xC0), [V], V),
+        neg: zeroArgs("i64x2.neg", simd(0xC1), [V], V),
+        all_true: zeroArgs("i64x2.all_true", simd(0xC3), [V], i32Type),
+        bitmask: zeroArgs("i64x2.bitmask", simd(0xC4), [V], i32Type),
+        shl: zeroArgs("i64x2.shl", simd(0xCB), [V, i32Type], V),
+        shr_s: zeroArgs("i64x2.shr_s", simd(0xCC), [V, i32Type], V),
+        shr_u: zeroArgs("i64x2.shr_u", simd(0xCD), [V, i32Type], V),
+        add: zeroArgs("i64x2.add", simd(0xCE), [V, V], V),
+        sub: zeroArgs("i64x2.sub", simd(0xD1), [V, V], V),
+        mul: zeroArgs("i64x2.mul", simd(0xD5), [V, V], V),
+    } as const,
+
+    f32x4: {
+        splat: zeroArgs("f32x4.splat", simd(0x13), [f32Type], V),
+        extract_lane: laneArg("f32x4.extract_lane", simd(0x1F), [V], f32Type, 1, 3),
+        replace_lane: laneArg("f32x4.replace_lane", simd(0x20), [V, f32Type], V, 1, 3),
+
+        eq: zeroArgs("f32x4.eq", simd(0x41), [V, V], V),
+        ne: zeroArgs("f32x4.ne", simd(0x42), [V, V], V),
+        lt: zeroArgs("f32x4.lt", simd(0x43), [V, V], V),
+        gt: zeroArgs("f32x4.gt", simd(0x44), [V, V], V),
+        le: zeroArgs("f32x4.le", simd(0x45), [V, V], V),
+        ge: zeroArgs("f32x4.ge", simd(0x46), [V, V], V),
+
+        abs: zeroArgs("f32x4.abs", simd(0xE0), [V], V),
+        neg: zeroArgs("f32x4.neg", simd(0xE1), [V], V),
+        sqrt: zeroArgs("f32x4.sqrt", simd(0xE3), [V], V),
+        add: zeroArgs("f32x4.add", simd(0xE4), [V, V], V),
+        sub: zeroArgs("f32x4.sub", simd(0xE5), [V, V], V),
+        mul: zeroArgs("f32x4.mul", simd(0xE6), [V, V], V),
+        div: zeroArgs("f32x4.div", simd(0xE7), [V, V], V),
+        min: zeroArgs("f32x4.min", simd(0xE8), [V, V], V),
+        max: zeroArgs("f32x4.max", simd(0xE9), [V, V], V),
+        pmin: zeroArgs("f32x4.pmin", simd(0xEA), [V, V], V),
+        pmax: zeroArgs("f32x4.pmax", simd(0xEB), [V, V], V),
+
+        ceil: zeroArgs("f32x4.ceil", simd(0x67), [V], V),
+        floor: zeroArgs("f32x4.floor", simd(0x68), [V], V),
+        trunc: zeroArgs("f32x4.trunc", simd(0x69), [V], V),
+        nearest: zeroArgs("f32x4.nearest", simd(0x6A), [V], V),
+        convert_i32x4_s: zeroArgs("f32x4.convert_i32x4_s", simd(0xFA), [V], V),
+        convert_i32x4_u: zeroArgs("f32x4.convert_i32x4_u", simd(0xFB), [V], V),
+        demote_f64x2_zero: zeroArgs("f32x4.demote_f64x2_zero", simd(0x5E), [V], V),
+    } as const,
+
+    f64x2: {
+        splat: zeroArgs("f64x2.splat", simd(0x14), [f64Type], V),
+        extract_lane: laneArg("f64x2.extract_lane", simd(0x21), [V], f64Type, 1, 1),
+        replace_lane: laneArg("f64x2.replace_lane", simd(0x22), [V, f64Type], V, 1, 1),
+
+        eq: zeroArgs("f64x2.eq", simd(0x47), [V, V], V),
+        ne: zeroArgs("f64x2.ne", simd(0x48), [V, V], V),
+        lt: zeroArgs("f64x2.lt", simd(0x49), [V, V], V),
+        gt: zeroArgs("f64x2.gt", simd(0x4A), [V, V], V),
+        le: zeroArgs("f64x2.le", simd(0x4B), [V, V], V),
+        ge: zeroArgs("f64x2.ge", simd(0x4C), [V, V], V),
+
+        abs: zeroArgs("f64x2.abs", simd(0xEC), [V], V),
+        neg: zeroArgs("f64x2.neg", simd(0xED), [V], V),
+        sqrt: zeroArgs("f64x2.sqrt", simd(0xEF), [V], V),
+        add: zeroArgs("f64x2.add", simd(0xF0), [V, V], V),
+        sub: zeroArgs("f64x2.sub", simd(0xF1), [V, V], V),
+        mul: zeroArgs("f64x2.mul", simd(0xF2), [V, V], V),
+        div: zeroArgs("f64x2.div", simd(0xF3), [V, V], V),
+        min: zeroArgs("f64x2.min", simd(0xF4), [V, V], V),
+        max: zeroArgs("f64x2.max", simd(0xF5), [V, V], V),
+        pmin: zeroArgs("f64x2.pmin", simd(0xF6), [V, V], V),
+        pmax: zeroArgs("f64x2.pmax", simd(0xF7), [V, V], V),
+
+        ceil: zeroArgs("f64x2.ceil", simd(0x74), [V], V),
+        floor: zeroArgs("f64x2.floor", simd(0x75), [V], V),
+        trunc: zeroArgs("f64x2.trunc", simd(0x7A), [V], V),
+        nearest: zeroArgs("f64x2.nearest", simd(0x94), [V], V),
+        convert_low_i32x4_s: zeroArgs("f64x2.convert_low_i32x4_s", simd(0xFE), [V], V),
+        convert_low_i32x4_u: zeroArgs("f64x2.convert_low_i32x4_u", simd(0xFF), [V], V),
+        promote_low_f32x4: zeroArgs("f64x2.promote_low_f32x4", simd(0x5F), [V], V),
     } as const
 
 } as const;
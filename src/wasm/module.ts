@@ -1,6 +1,7 @@
 import {byte, typeidx, funcidx, globalidx, tableidx} from "./base_types";
 import {encodeU32, encodeUtf8, encodeConstantInstr} from "./encoding";
 import {WFunctionBuilder, WFunction, WImportedFunction} from "./functions";
+import {CompiledModule} from "./compiled";
 import {WGlobal} from "./global";
 import {WInstruction} from "./instructions";
 import {encodeVec, ResultType, encodeFunctionType, FunctionType, MemoryType, encodeLimits, ValueType, i32Type} from "./wtypes";
@@ -13,13 +14,15 @@ export class ModuleBuilder {
     private _globals: WGlobal[] = [];
     private _memory?: MemoryType;
     private _dataSegments: [offset: number, contents: byte[]][] = [];
-    startFunction?: WFunction;
+    private _startFunction?: WFunction;
+    private _compiled?: CompiledModule;
     emitCallback?: () => void;
 
     function(params: ResultType, returnValue: ResultType, bodyFn?: (b: WFunctionBuilder) => WInstruction[], exportName?: string): WFunction {
         const type: FunctionType = [params, returnValue];
         const fn = new WFunction(this, type, exportName);
         this._functions.push(fn);
+        this.changed();
         if (bodyFn) fn.define(bodyFn); // have to add to list before defining to enable recursive calls
         return fn;
     }
@@ -29,12 +32,14 @@ export class ModuleBuilder {
 
         const fn = new WImportedFunction(this, [param, returnValue], module, name);
         this._importedFunctions.push(fn);
+        this.changed();
         return fn;
     }
 
     global(type: ValueType, mutable: boolean, initialValue: number | bigint, exportName?: string): WGlobal {
         const g = new WGlobal(this, type, mutable, initialValue, exportName);
         this._globals.push(g);
+        this.changed();
         return g;
     }
 
@@ -48,6 +53,7 @@ export class ModuleBuilder {
         } else {
             this._memory = [BigInt(initial64kPages), BigInt(maximum64kPages)];
         }
+        this.changed();
     }
 
     dataSegment(offset: number, contents: byte[] | number[]): void {
@@ -61,7 +67,25 @@ export class ModuleBuilder {
         // remove 0s from the end
         while (contents.length && contents[contents.length - 1] === 0) contents.pop();
 
-        if (contents.length) this._dataSegments.push([offset, contents as byte[]]);
+        if (contents.length) {
+            this._dataSegments.push([offset, contents as byte[]]);
+            this.changed();
+        }
+    }
+
+    get startFunction(): WFunction | undefined {
+        return this._startFunction;
+    }
+
+    set startFunction(fn: WFunction | undefined) {
+        this._startFunction = fn;
+        this.changed();
+    }
+
+    /** Discards the encoded and compiled module. Called by the builder methods and when function bodies, locals or
+     * global initial values are modified */
+    changed(): void {
+        this._compiled = undefined;
     }
 
     private byteList(): byte[] {
@@ -71,8 +95,8 @@ export class ModuleBuilder {
         if (this.emitCallback) this.emitCallback();
 
         const startSection: byte[] = [];
-        if (this.startFunction) {
-            startSection.push(...encodeU32(this.startFunction.getIndex()));
+        if (this._startFunction) {
+            startSection.push(...encodeU32(this._startFunction.getIndex()));
             // do section encoding manually as this is the only non-vector section
             startSection.unshift(8 as byte, ...encodeU32(BigInt(startSection.length)));
         }
@@ -95,13 +119,27 @@ export class ModuleBuilder {
         ] as byte[];
     }
 
+    /** Encoded once until the module is changed, so the result is shared and mustn't be modified */
     toBytes(): Uint8Array {
-        return new Uint8Array(this.byteList());
+        return this.compiled().toBytes();
     }
 
-    async execute(imports: WebAssembly.Imports): Promise<WebAssembly.Exports> {
-        const module = await WebAssembly.instantiate(this.toBytes(), imports);
-        return module.instance.exports;
+    /** The module compiled by the engine, which is cached like toBytes so many instances can be created cheaply */
+    compileModule(): Promise<WebAssembly.Module> {
+        return this.compiled().compileModule();
+    }
+
+    execute(imports: WebAssembly.Imports): Promise<WebAssembly.Exports> {
+        return this.compiled().execute(imports);
+    }
+
+    private compiled(): CompiledModule {
+        if (this._compiled === undefined) {
+            const bytes = new Uint8Array(this.byteList());
+            // encoding may add memory or table entries through emitCallback, so only cache afterwards
+            this._compiled = new CompiledModule(bytes);
+        }
+        return this._compiled;
     }
 
     private _encodeImports(): byte[][] {
@@ -189,6 +227,7 @@ export class ModuleBuilder {
         let idx = this._functionTable.indexOf(fn);
         if (idx < 0) {
             idx = this._functionTable.push(fn) - 1;
+            this.changed();
         }
         return BigInt(idx) as tableidx;
     }
@@ -218,6 +257,10 @@ export class ModuleBuilder {
         return this._importedFunctions;
     }
 
+    get globals(): ReadonlyArray<WGlobal> {
+        return this._globals;
+    }
+
     _functionLookup(f: funcidx): WFunction | WImportedFunction {
         if (f < this._importedFunctions.length) return this._importedFunctions[Number(f)];
         return this._functions[Number(f) - this._importedFunctions.length];
@@ -231,13 +274,25 @@ export class ModuleBuilder {
         return this._globals[Number(g)];
     }
 
+    _tableLookup(t: tableidx): WFunction | WImportedFunction | undefined {
+        return this._functionTable[Number(t)];
+    }
+
     _inFunctionTable(f: WFunction | WImportedFunction): boolean {
         return this._functionTable.indexOf(f) >= 0;
     }
 
+    _clearDataSegments(): void {
+        this._dataSegments = [];
+        this.changed();
+    }
+
     _removeFunction(f: WFunction): void {
         const idx = this._functions.indexOf(f);
-        if (idx >= 0) this._functions.splice(idx, 1);
+        if (idx >= 0) {
+            this._functions.splice(idx, 1);
+            this.changed();
+        }
     }
 }
 
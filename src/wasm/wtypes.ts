@@ -6,6 +6,7 @@ export const i32Type = 0x7F as ValueType;
 export const i64Type = 0x7E as ValueType;
 export const f32Type = 0x7D as ValueType;
 export const f64Type = 0x7C as ValueType;
+export const v128Type = 0x7B as ValueType;
 
 
 export type ResultType = ValueType[];
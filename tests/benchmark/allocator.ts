@@ -0,0 +1,64 @@
+import fs from "fs";
+import path from "path";
+import {performance} from "perf_hooks";
+import {BenchmarkBase, OptLevel} from "./base";
+import {compile} from "../../src";
+
+const SOURCE = fs.readFileSync(path.join(__dirname, "allocator", "allocator.c"), {encoding: "utf8"});
+
+export const allocator = (new class extends BenchmarkBase {
+
+    getScore(output: string): number {
+        const match = output.match(/Allocator benchmark completed in ([0-9]+\.[0-9]+) ms/);
+        if (match) {
+            return Number(match[1]);
+        } else {
+            console.log(output);
+            throw new Error("Benchmark failed");
+        }
+    }
+
+    async c2wasmRun(): Promise<string> {
+        const module = compile(SOURCE);
+        let output = "";
+
+        const {main} = await module.execute({
+            c2wasm: {
+                __put_char: (n: number) => output += String.fromCharCode(n),
+                __time: () => performance.now()
+            }
+        }) as { main: () => void };
+        main();
+
+        return output;
+    }
+
+    async c2wasmSize(): Promise<number> {
+        return compile(SOURCE).toBytes().length;
+    }
+
+    async emccCompile(optLevel: OptLevel): Promise<void> {
+        await BenchmarkBase.cmdStdout(`emcc allocator/allocator.c -s ALLOW_MEMORY_GROWTH=1 ${optLevel} -o /tmp/c2wasm-allocator-emcc${optLevel}`);
+    }
+
+    async emccRun(optLevel: OptLevel, nodeFlags: string): Promise<string> {
+        return BenchmarkBase.cmdStdout(`node ${nodeFlags} /tmp/c2wasm-allocator-emcc${optLevel}`);
+    }
+
+    async emccSize(optLevel: OptLevel): Promise<number> {
+        return Number(await BenchmarkBase.cmdStdout(`stat -c %s /tmp/c2wasm-allocator-emcc${optLevel}.wasm`));
+    }
+
+    async nativeCompile(optLevel: OptLevel): Promise<void> {
+        await BenchmarkBase.cmdStdout(`gcc allocator/allocator.c ${optLevel} -o /tmp/c2wasm-allocator-native${optLevel}`);
+    }
+
+    async nativeRun(optLevel: OptLevel): Promise<string> {
+        return BenchmarkBase.cmdStdout(`/tmp/c2wasm-allocator-native${optLevel}`);
+    }
+}("allocator", __filename));
+
+if (require.main === module) {
+    BenchmarkBase.setFlags(process.argv[2]);
+    (async () => console.log(await allocator.c2wasmRun()))();
+}
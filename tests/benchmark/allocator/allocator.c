@@ -0,0 +1,182 @@
+// allocator micro-benchmarks, each phase prints a checksum so the results can be compared between implementations
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define SLOTS 20000
+
+static void* slots[SLOTS];
+static unsigned int slot_sizes[SLOTS];
+static unsigned int seed;
+
+static unsigned int next_random(void) {
+  seed = seed * 1103515245 + 12345;
+  return seed >> 8;
+}
+
+static double now_ms(void) {
+  return (double) clock() * 1000 / CLOCKS_PER_SEC;
+}
+
+static void fail(const char* phase) {
+  printf("Allocation failed in %s\n", phase);
+  exit(1);
+}
+
+// allocate many small objects, then free them in allocation order
+static unsigned int small_fifo(void) {
+  unsigned int checksum = 0;
+  for (int round = 0; round < 10; round++) {
+    for (int i = 0; i < SLOTS; i++) {
+      unsigned int size = 8 + (i % 16) * 8;
+      char* p = malloc(size);
+      if (!p) fail("small_fifo");
+      p[0] = (char) i;
+      slots[i] = p;
+    }
+    for (int i = 0; i < SLOTS; i++) {
+      checksum += ((char*) slots[i])[0];
+      free(slots[i]);
+    }
+  }
+  return checksum;
+}
+
+// allocations and frees interleaved like a stack
+static unsigned int lifo(void) {
+  unsigned int checksum = 0;
+  int depth = 0;
+  for (int i = 0; i < 1000000; i++) {
+    if (depth < SLOTS && (depth == 0 || next_random() % 3 != 0)) {
+      char* p = malloc(16 + next_random() % 112);
+      if (!p) fail("lifo");
+      p[0] = (char) i;
+      slots[depth++] = p;
+    } else {
+      char* p = slots[--depth];
+      checksum += p[0];
+      free(p);
+    }
+  }
+  while (depth > 0) free(slots[--depth]);
+  return checksum;
+}
+
+// replace random small objects, fragmenting the heap
+static unsigned int small_random(void) {
+  unsigned int checksum = 0;
+  for (int i = 0; i < SLOTS; i++) {
+    slot_sizes[i] = 8 + next_random() % 248;
+    slots[i] = malloc(slot_sizes[i]);
+    if (!slots[i]) fail("small_random");
+  }
+  for (int i = 0; i < 500000; i++) {
+    unsigned int slot = next_random() % SLOTS;
+    checksum += slot_sizes[slot];
+    free(slots[slot]);
+
+    slot_sizes[slot] = 8 + next_random() % 248;
+    slots[slot] = malloc(slot_sizes[slot]);
+    if (!slots[slot]) fail("small_random");
+  }
+  for (int i = 0; i < SLOTS; i++) free(slots[i]);
+  return checksum;
+}
+
+// replace random objects with sizes from 16 bytes to 64 KiB, mostly small
+static unsigned int mixed_sizes(void) {
+  unsigned int checksum = 0;
+  const int count = 2000;
+  for (int i = 0; i < count; i++) slots[i] = NULL;
+  for (int i = 0; i < 200000; i++) {
+    unsigned int slot = next_random() % count;
+    free(slots[slot]);
+
+    unsigned int size = 16u << (next_random() % 13);
+    size = size / 2 + next_random() % size;
+    char* p = malloc(size);
+    if (!p) fail("mixed_sizes");
+    p[size - 1] = (char) size;
+    checksum += p[size - 1];
+    slots[slot] = p;
+  }
+  for (int i = 0; i < count; i++) free(slots[i]);
+  return checksum;
+}
+
+// grow buffers one element at a time using realloc
+static unsigned int realloc_growth(void) {
+  unsigned int checksum = 0;
+  for (int round = 0; round < 20; round++) {
+    int* buffers[8] = {NULL};
+    for (int n = 1; n <= 4096; n++) {
+      for (int b = 0; b < 8; b++) {
+        int* p = buffers[b] ? realloc(buffers[b], n * sizeof(int)) : malloc(sizeof(int));
+        if (!p) fail("realloc_growth");
+        p[n - 1] = n + b;
+        buffers[b] = p;
+      }
+    }
+    for (int b = 0; b < 8; b++) {
+      checksum += buffers[b][4095];
+      free(buffers[b]);
+    }
+  }
+  return checksum;
+}
+
+// push back onto vectors which double their capacity using realloc, interleaved with other allocations
+static unsigned int vector_push_back(void) {
+  unsigned int checksum = 0;
+  for (int round = 0; round < 10; round++) {
+    int* data[16];
+    unsigned int length[16], capacity[16];
+    for (int v = 0; v < 16; v++) {
+      data[v] = NULL;
+      length[v] = capacity[v] = 0;
+    }
+
+    for (int i = 0; i < 65536; i++) {
+      for (int v = 0; v < 16; v++) {
+        if (length[v] == capacity[v]) {
+          capacity[v] = capacity[v] ? capacity[v] * 2 : 4;
+          int* p = data[v] ? realloc(data[v], capacity[v] * sizeof(int)) : malloc(capacity[v] * sizeof(int));
+          if (!p) fail("vector_push_back");
+          data[v] = p;
+        }
+        data[v][length[v]++] = i ^ v;
+      }
+    }
+
+    for (int v = 0; v < 16; v++) {
+      for (unsigned int i = 0; i < length[v]; i += 1024) checksum += data[v][i];
+      free(data[v]);
+    }
+  }
+  return checksum;
+}
+
+static double total;
+
+static void run(const char* name, unsigned int (*fn)(void)) {
+  seed = 42;
+  double start = now_ms();
+  unsigned int checksum = fn();
+  double elapsed = now_ms() - start;
+
+  total += elapsed;
+  printf("%s: %.3f ms (checksum %u)\n", name, elapsed, checksum);
+}
+
+int main(void) {
+  run("small_fifo", small_fifo);
+  run("lifo", lifo);
+  run("small_random", small_random);
+  run("mixed_sizes", mixed_sizes);
+  run("realloc_growth", realloc_growth);
+  run("vector_push_back", vector_push_back);
+
+  printf("Allocator benchmark completed in %.3f ms\n", total);
+  return 0;
+}
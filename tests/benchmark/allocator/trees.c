@@ -0,0 +1,154 @@
+// builds and walks binary trees using malloc/free, then using an arena
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#ifdef __c2wasm__
+#include <c2wasm/arena.h>
+#else
+// minimal equivalent for other compilers
+typedef struct {
+  char* block;
+  char* ptr;
+} arena_mark_t;
+typedef struct {
+  char* blocks[1024];
+  int count;
+  arena_mark_t current;
+} arena_t;
+
+static arena_t* arena_create(void) {
+  arena_t* arena = calloc(1, sizeof(arena_t));
+  return arena;
+}
+
+static void* arena_alloc(arena_t* arena, size_t size) {
+  size = (size + 15) & ~15u;
+  if (!arena->current.block || arena->current.ptr + size > arena->current.block + 65536) {
+    char* block = malloc(65536);
+    if (!block) return NULL;
+    arena->blocks[arena->count++] = block;
+    arena->current.block = block;
+    arena->current.ptr = block;
+  }
+  void* ptr = arena->current.ptr;
+  arena->current.ptr += size;
+  return ptr;
+}
+
+static arena_mark_t arena_mark(arena_t* arena) {
+  return arena->current;
+}
+
+static void arena_reset(arena_t* arena, arena_mark_t mark) {
+  while (arena->count > 0 && arena->blocks[arena->count - 1] != mark.block) free(arena->blocks[--arena->count]);
+  arena->current = mark;
+}
+
+static void arena_destroy(arena_t* arena) {
+  while (arena->count > 0) free(arena->blocks[--arena->count]);
+  free(arena);
+}
+#endif
+
+#define MIN_DEPTH 4
+#define MAX_DEPTH 16
+
+struct node {
+  struct node* left;
+  struct node* right;
+};
+
+static double now_ms(void) {
+  return (double) clock() * 1000 / CLOCKS_PER_SEC;
+}
+
+static void fail(void) {
+  printf("Allocation failed\n");
+  exit(1);
+}
+
+static struct node* malloc_tree(int depth) {
+  struct node* node = malloc(sizeof(struct node));
+  if (!node) fail();
+  node->left = depth > 0 ? malloc_tree(depth - 1) : NULL;
+  node->right = depth > 0 ? malloc_tree(depth - 1) : NULL;
+  return node;
+}
+
+static void free_tree(struct node* node) {
+  if (node->left) free_tree(node->left);
+  if (node->right) free_tree(node->right);
+  free(node);
+}
+
+static struct node* arena_tree(arena_t* arena, int depth) {
+  struct node* node = arena_alloc(arena, sizeof(struct node));
+  if (!node) fail();
+  node->left = depth > 0 ? arena_tree(arena, depth - 1) : NULL;
+  node->right = depth > 0 ? arena_tree(arena, depth - 1) : NULL;
+  return node;
+}
+
+static int check(struct node* node) {
+  return 1 + (node->left ? check(node->left) + check(node->right) : 0);
+}
+
+// long lived tree kept for the whole run, with many short lived trees created and released
+static int malloc_trees(void) {
+  int total = 0;
+  struct node* long_lived = malloc_tree(MAX_DEPTH);
+
+  for (int depth = MIN_DEPTH; depth <= MAX_DEPTH; depth += 2) {
+    int iterations = 1 << (MAX_DEPTH - depth + MIN_DEPTH);
+    for (int i = 0; i < iterations; i++) {
+      struct node* tree = malloc_tree(depth);
+      total += check(tree);
+      free_tree(tree);
+    }
+  }
+
+  total += check(long_lived);
+  free_tree(long_lived);
+  return total;
+}
+
+static int arena_trees(void) {
+  int total = 0;
+  arena_t* arena = arena_create();
+  if (!arena) fail();
+  struct node* long_lived = arena_tree(arena, MAX_DEPTH);
+
+  for (int depth = MIN_DEPTH; depth <= MAX_DEPTH; depth += 2) {
+    int iterations = 1 << (MAX_DEPTH - depth + MIN_DEPTH);
+    for (int i = 0; i < iterations; i++) {
+      arena_mark_t mark = arena_mark(arena);
+      struct node* tree = arena_tree(arena, depth);
+      total += check(tree);
+      arena_reset(arena, mark);
+    }
+  }
+
+  total += check(long_lived);
+  arena_destroy(arena);
+  return total;
+}
+
+int main(void) {
+  double start = now_ms();
+  int malloc_result = malloc_trees();
+  double malloc_time = now_ms() - start;
+
+  start = now_ms();
+  int arena_result = arena_trees();
+  double arena_time = now_ms() - start;
+
+  if (malloc_result != arena_result) {
+    printf("Results differ: %d != %d\n", malloc_result, arena_result);
+    return 1;
+  }
+  printf("malloc: %.3f ms (checksum %d)\n", malloc_time, malloc_result);
+  printf("arena: %.3f ms (checksum %d)\n", arena_time, arena_result);
+  printf("Trees benchmark completed in %.3f ms\n", malloc_time + arena_time);
+  return 0;
+}
@@ -1,4 +1,6 @@
 import {exec} from "child_process";
+import fs from "fs";
+import type {Profile} from "../../src/generation/profile";
 import {setFlags, getFlags, OptimisationFlags} from "../../src/optimisation/flags";
 
 const FLAG_NAMES = Object.keys(getFlags()) as (keyof OptimisationFlags)[];
@@ -6,6 +8,8 @@ const FLAG_NAMES = Object.keys(getFlags()) as (keyof OptimisationFlags)[];
 export type OptLevel = `-O${'0' | '1' | '2' | '3' | 's'}`;
 
 export abstract class BenchmarkBase {
+    // profile passed to the benchmark process for profile guided runs
+    static profile?: Profile;
 
     constructor(readonly name: string, readonly benchmarkFile: string, readonly turboFanAll: boolean = false) {
     }
@@ -16,8 +20,12 @@ export abstract class BenchmarkBase {
 
     abstract c2wasmSize(): Promise<number>;
 
-    c2wasmNodeFlagsRun(nodeFlags: string): Promise<string> {
-        const cmd = `node ${nodeFlags} -r ts-node/register ${this.benchmarkFile} ${BenchmarkBase.flagString()}`;
+    // instrumented run, for benchmarks used to check profile guided optimisation
+    c2wasmProfile?(): Promise<Profile>;
+
+    c2wasmNodeFlagsRun(nodeFlags: string, profileFile?: string): Promise<string> {
+        let cmd = `node ${nodeFlags} -r ts-node/register ${this.benchmarkFile} ${BenchmarkBase.flagString()}`;
+        if (profileFile) cmd += ` ${profileFile}`;
 
         return new Promise((resolve, reject) => exec(cmd,
             {env: {TS_NODE_TRANSPILE_ONLY: "true"}},
@@ -62,6 +70,10 @@ export abstract class BenchmarkBase {
         }
     }
 
+    static setProfile(profileFile: string | undefined): void {
+        BenchmarkBase.profile = profileFile ? JSON.parse(fs.readFileSync(profileFile, "utf8")) : undefined;
+    }
+
     static cmdStdout(command: string): Promise<string> {
         let cmd = `/bin/bash -c '${command}'`;
         if (process.platform.startsWith("win")) { // try run through WSL
@@ -87,15 +99,24 @@ setFlags("none");
 setFlags({generation_try_constant_expr: true});
 FLAG_CONFIGURATIONS.set("ConstExpr", getFlags());
 
+setFlags({specialise_printf: true});
+FLAG_CONFIGURATIONS.set("Printf", getFlags());
+
 Object.keys(getFlags()).filter(x => x.startsWith("peephole_")).forEach(x => setFlags({[x]: true}));
 FLAG_CONFIGURATIONS.set("Peephole", getFlags());
 
-setFlags({copy_propagation: true, live_range_splitting: true, dead_code_elimination: true, reallocate_locals: true, unused_locals: true});
+setFlags({copy_propagation: true, live_range_splitting: true, stackify_locals: true, dead_code_elimination: true, reallocate_locals: true, unused_locals: true});
 FLAG_CONFIGURATIONS.set("CP RL", getFlags());
 
 setFlags({partial_redundancy_elimination: true});
 FLAG_CONFIGURATIONS.set("PRE", getFlags());
 
+setFlags({specialise_function_pointers: true});
+FLAG_CONFIGURATIONS.set("FnPtr", getFlags());
+
+setFlags({fold_pure_calls: true});
+FLAG_CONFIGURATIONS.set("PureCalls", getFlags());
+
 { // check current flags are the same as default
     const currentFlags = getFlags();
     setFlags("default");
@@ -109,3 +130,16 @@ FLAG_CONFIGURATIONS.set("PRE", getFlags());
 
 setFlags({inlining: true});
 FLAG_CONFIGURATIONS.set("Inlined", getFlags());
+
+setFlags({generation_vectorize_loops: true});
+FLAG_CONFIGURATIONS.set("Vectorized", getFlags());
+
+// profile guided configurations, compiled with a profile from an instrumented run. hot functions only get a larger
+// inlining budget when inlining is enabled, otherwise the profile just reorders switch cases and skips cold functions
+export const PGO_CONFIGURATIONS = new Map<string, Parameters<typeof setFlags>[0]>();
+
+setFlags("default");
+PGO_CONFIGURATIONS.set("PGO", getFlags());
+
+setFlags({inlining: true});
+PGO_CONFIGURATIONS.set("PGO Inlined", getFlags());
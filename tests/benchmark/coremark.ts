@@ -1,8 +1,8 @@
 import fs from "fs";
 import path from "path";
-import {performance} from "perf_hooks";
 import {BenchmarkBase, OptLevel} from "./base";
-import {compile} from "../../src";
+import {compile, runtime} from "../../src";
+import type {Profile} from "../../src/generation/profile";
 
 const files = (() => {
     const map = new Map<string, string>();
@@ -18,6 +18,18 @@ const files = (() => {
 })();
 const compilerCmd = `-DCOMPILER_FLAGS=\\"\\" -DPERFORMANCE_RUN=1 -DITERATIONS=0 coremark/*.c coremark/simple/*.c -iquote coremark/ -iquote coremark/simple/`;
 
+async function run(module: ReturnType<typeof compile>): Promise<{output: string, exports: WebAssembly.Exports}> {
+    let output = "";
+    const exports = await module.execute({
+        c2wasm: {
+            __put_char: (n: number) => output += String.fromCharCode(n),
+            ...runtime.timeImports()
+        }
+    });
+    (exports.main as () => void)();
+    return {output, exports};
+}
+
 export const coremark = (new class extends BenchmarkBase {
 
     getScore(output: string): number {
@@ -31,18 +43,11 @@ export const coremark = (new class extends BenchmarkBase {
     }
 
     async c2wasmRun(): Promise<string> {
-        const module = compile(files);
-        let output = "";
-
-        const {main} = await module.execute({
-            c2wasm: {
-                __put_char: (n: number) => output += String.fromCharCode(n),
-                __time: () => performance.now()
-            }
-        }) as { main: () => void };
-        main();
+        return (await run(compile(files, undefined, {profile: BenchmarkBase.profile}))).output;
+    }
 
-        return output;
+    async c2wasmProfile(): Promise<Profile> {
+        return runtime.dumpProfile((await run(compile(files, undefined, {instrument: true}))).exports);
     }
 
     async c2wasmSize(): Promise<number> {
@@ -72,5 +77,6 @@ export const coremark = (new class extends BenchmarkBase {
 
 if (require.main === module) {
     BenchmarkBase.setFlags(process.argv[2]);
+    BenchmarkBase.setProfile(process.argv[3]);
     (async () => console.log(await coremark.c2wasmRun()))();
 }
@@ -20,6 +20,7 @@ Original Author: Shay Gal-on
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <time.h>
 #include "coremark.h"
 
 #define ITERATIONS 0
@@ -51,8 +52,6 @@ volatile ee_s32 seed5_volatile = 0;
 
 static CORE_TICKS start_time_val, stop_time_val;
 
-import double __time();
-
 /* Function : start_time
         This function will be called right before starting the timed portion of
    the benchmark.
@@ -64,7 +63,7 @@ import double __time();
 void
 start_time(void)
 {
-    start_time_val = __time();
+    start_time_val = __c2wasm_now_ns();
 }
 /* Function : stop_time
         This function will be called right after ending the timed portion of the
@@ -77,7 +76,7 @@ start_time(void)
 void
 stop_time(void)
 {
-    stop_time_val = __time();
+    stop_time_val = __c2wasm_now_ns();
 }
 /* Function : get_time
         Return an abstract "ticks" number that signifies time on the system.
@@ -103,7 +102,7 @@ get_time(void)
 double
 time_in_secs(CORE_TICKS ticks)
 {
-    return ticks / 1000.0;
+    return ticks / 1000000000.0;
 }
 
 ee_u32 default_num_contexts = 1;
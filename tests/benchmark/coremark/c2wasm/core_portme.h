@@ -50,9 +50,10 @@ Original Author: Shay Gal-on
 #define HAS_PRINTF 1
 
 /* Configuration : CORE_TICKS
-        Define type of return from the timing functions.
+        Define type of return from the timing functions, nanoseconds from
+   __c2wasm_now_ns.
  */
-typedef double CORE_TICKS;
+typedef long CORE_TICKS;
 
 /* Definitions : COMPILER_VERSION, COMPILER_FLAGS, MEM_LOCATION
         Initialize these strings per platform
@@ -0,0 +1,65 @@
+import fs from "fs";
+import path from "path";
+import {performance} from "perf_hooks";
+import {BenchmarkBase, OptLevel} from "./base";
+import {compile, runtime} from "../../src";
+
+const SOURCE = fs.readFileSync(path.join(__dirname, "csv", "csv.c"), {encoding: "utf8"});
+
+export const csv = (new class extends BenchmarkBase {
+
+    getScore(output: string): number {
+        const match = output.match(/CSV benchmark completed in ([0-9]+\.[0-9]+) ms/);
+        if (match) {
+            return Number(match[1]);
+        } else {
+            console.log(output);
+            throw new Error("Benchmark failed");
+        }
+    }
+
+    async c2wasmRun(): Promise<string> {
+        let output = "";
+        const files = new runtime.Files((c) => output += c);
+
+        const exports = await compile(SOURCE, {FILES: "1"}).execute({
+            c2wasm: {
+                ...files.getImports(),
+                __time: () => performance.now()
+            }
+        });
+        files.attach(exports);
+        runtime.mainWrapper(exports, ["csv"]);
+
+        return output;
+    }
+
+    async c2wasmSize(): Promise<number> {
+        return compile(SOURCE, {FILES: "1"}).toBytes().length;
+    }
+
+    async emccCompile(optLevel: OptLevel): Promise<void> {
+        await BenchmarkBase.cmdStdout(`emcc csv/csv.c -s ALLOW_MEMORY_GROWTH=1 ${optLevel} -o /tmp/c2wasm-csv-emcc${optLevel}`);
+    }
+
+    async emccRun(optLevel: OptLevel, nodeFlags: string): Promise<string> {
+        return BenchmarkBase.cmdStdout(`node ${nodeFlags} /tmp/c2wasm-csv-emcc${optLevel}`);
+    }
+
+    async emccSize(optLevel: OptLevel): Promise<number> {
+        return Number(await BenchmarkBase.cmdStdout(`stat -c %s /tmp/c2wasm-csv-emcc${optLevel}.wasm`));
+    }
+
+    async nativeCompile(optLevel: OptLevel): Promise<void> {
+        await BenchmarkBase.cmdStdout(`gcc csv/csv.c ${optLevel} -o /tmp/c2wasm-csv-native${optLevel}`);
+    }
+
+    async nativeRun(optLevel: OptLevel): Promise<string> {
+        return BenchmarkBase.cmdStdout(`/tmp/c2wasm-csv-native${optLevel}`);
+    }
+}("csv", __filename));
+
+if (require.main === module) {
+    BenchmarkBase.setFlags(process.argv[2]);
+    (async () => console.log(await csv.c2wasmRun()))();
+}
@@ -0,0 +1,102 @@
+// writes a CSV table of doubles with printf conversions and parses it back with strtod and sscanf, as in data export
+// and import jobs. each phase prints a checksum of the output text or parsed bits, which are exact so they match a
+// native build
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define ROWS 100000
+#define COLUMNS 4
+
+static unsigned int seed = 1;
+
+static unsigned int next(void) {
+  seed = seed * 1103515245 + 12345;
+  return seed >> 8;
+}
+
+static double now_ms(void) {
+  return (double) clock() * 1000 / CLOCKS_PER_SEC;
+}
+
+static unsigned int text_checksum(const char* s) {
+  unsigned int checksum = 0;
+  while (*s) checksum = checksum * 31 + (unsigned char) *(s++);
+  return checksum;
+}
+
+static unsigned int bits_checksum(const double* values, int n) {
+  unsigned int checksum = 0;
+  for (int i = 0; i < n; i++) {
+    unsigned long bits;
+    memcpy(&bits, &values[i], sizeof(bits));
+    checksum = checksum * 31 + (unsigned int) (bits ^ (bits >> 32));
+  }
+  return checksum;
+}
+
+static void report(const char* name, double start, unsigned int checksum) {
+  printf("%-16s %8.3f ms checksum %u\n", name, now_ms() - start, checksum);
+}
+
+int main() {
+  double* values = malloc(ROWS * COLUMNS * sizeof(double));
+  double* parsed = malloc(ROWS * COLUMNS * sizeof(double));
+  char* text = malloc(ROWS * 128);
+  double begin = now_ms(), start;
+
+  // prices with cents, measurements, ratios and large counts
+  for (int i = 0; i < ROWS; i++) {
+    double* row = values + i * COLUMNS;
+    row[0] = (next() % 1000000) / 100.0;
+    row[1] = (next() / 16777216.0 - 0.5) * 1000;
+    row[2] = next() / 16777216.0 * next() / 16777216.0;
+    row[3] = (double) next() * next();
+  }
+
+  start = now_ms();
+  char* p = text;
+  for (int i = 0; i < ROWS; i++) {
+    const double* row = values + i * COLUMNS;
+    p += sprintf(p, "%.2f,%.6f,%.17g,%e\n", row[0], row[1], row[2], row[3]);
+  }
+  report("printf", start, text_checksum(text));
+
+  start = now_ms();
+  p = text;
+  for (int i = 0; i < ROWS * COLUMNS; i++) {
+    parsed[i] = strtod(p, &p);
+    p++; // ',' or '\n'
+  }
+  report("strtod", start, bits_checksum(parsed, ROWS * COLUMNS));
+
+  memset(parsed, 0, ROWS * COLUMNS * sizeof(double));
+  start = now_ms();
+  p = text;
+  for (int i = 0; i < ROWS; i++) {
+    double* row = parsed + i * COLUMNS;
+    char* end = strchr(p, '\n');
+    *end = 0;
+    sscanf(p, "%lf,%lf,%lf,%lf", &row[0], &row[1], &row[2], &row[3]);
+    *end = '\n';
+    p = end + 1;
+  }
+  report("sscanf", start, bits_checksum(parsed, ROWS * COLUMNS));
+
+  // the shortest decimals round trip
+  start = now_ms();
+  unsigned int mismatches = 0;
+  char buffer[32];
+  for (int i = 0; i < ROWS * COLUMNS; i++) {
+    sprintf(buffer, "%.17g", values[i]);
+    if (atof(buffer) != values[i]) mismatches++;
+  }
+  report("round trip", start, mismatches);
+
+  printf("CSV benchmark completed in %.3f ms\n", now_ms() - begin);
+  free(values);
+  free(parsed);
+  free(text);
+  return 0;
+}
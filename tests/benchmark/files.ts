@@ -0,0 +1,74 @@
+import fs from "fs";
+import path from "path";
+import {performance} from "perf_hooks";
+import {Files} from "../../src/c_library/runtime/files";
+import {cjpeg} from "./jpeg";
+
+// memory footprint and throughput of runtime.Files, using the JPEG benchmark's input tiled to about 50 MiB
+// run with node --expose-gc for more accurate memory usage
+
+const IMAGE = fs.readFileSync(path.join(__dirname, "jpeg", "benchmark.bmp"));
+const SIZE = Math.ceil(50 * 1024 * 1024 / IMAGE.length) * IMAGE.length;
+const CHUNK = 65536;
+
+function mebibytes(bytes: number): string {
+    return (bytes / 1024 / 1024).toFixed(1).padStart(7);
+}
+
+async function measure<T>(name: string, fn: () => T | Promise<T>, bytes = SIZE): Promise<T> {
+    (global as {gc?: () => void}).gc?.();
+    const before = process.memoryUsage();
+    const start = performance.now();
+    const result = await fn();
+    const elapsed = performance.now() - start;
+    const after = process.memoryUsage();
+
+    console.log(`${name.padEnd(24)} ${elapsed.toFixed(1).padStart(8)} ms ${mebibytes(bytes / elapsed * 1000)} MiB/s   ` +
+        `heap ${mebibytes(after.heapUsed - before.heapUsed)} MiB   array buffers ${mebibytes(after.arrayBuffers - before.arrayBuffers)} MiB`);
+    return result;
+}
+
+// open a file using the imports, like fopen
+function open(imports: ReturnType<Files["getImports"]>, filename: string): number {
+    for (const c of new TextEncoder().encode(filename)) imports.__put_char(3, c);
+    imports.__put_char(3, 0);
+    return imports.__get_fhandle();
+}
+
+async function main() {
+    const input = new Uint8Array(SIZE);
+    for (let i = 0; i < SIZE; i += IMAGE.length) input.set(IMAGE, i);
+
+    const files = await measure("load", () => new Files(() => undefined, undefined, new Map([["input.bmp", input]])));
+    const imports = files.getImports();
+    const memory = new WebAssembly.Memory({initial: 2});
+    files.attach({__mem: memory});
+
+    const inputHandle = open(imports, "input.bmp");
+    await measure("__get_char", () => {
+        let checksum = 0;
+        for (let c: number; (c = imports.__get_char(inputHandle)) >= 0;) checksum = (checksum * 31 + c) | 0;
+        return checksum;
+    });
+
+    const outputHandle = open(imports, "output.bmp");
+    await measure("__put_char", () => {
+        for (let i = 0; i < SIZE; i++) imports.__put_char(outputHandle, input[i]);
+    });
+
+    open(imports, "input.bmp");
+    const copyHandle = open(imports, "copy.bmp");
+    await measure("__read + __write", () => {
+        for (let n: number; (n = imports.__read(inputHandle, 0, CHUNK)) > 0;) imports.__write(copyHandle, 0, n);
+    });
+
+    const contents = await measure("getContents", () => files.getContents("copy.bmp"));
+    if (contents?.length !== SIZE) throw new Error("Copy failed");
+
+    // the real benchmark input through cjpeg
+    await measure("cjpeg (compile and run)", () => cjpeg.c2wasmRun(), IMAGE.length);
+}
+
+if (require.main === module) {
+    main();
+}
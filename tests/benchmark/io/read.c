@@ -0,0 +1,88 @@
+// reads the same multi-megabyte file of integers through fread, fgets and fscanf, each phase prints a checksum so the
+// results can be compared between implementations
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define CHUNK 65536
+
+static char chunk[CHUNK];
+static char line[256];
+static FILE* file;
+
+static double now_ms(void) {
+  return (double) clock() * 1000 / CLOCKS_PER_SEC;
+}
+
+// bulk reads
+static unsigned int read_chunks(void) {
+  unsigned int checksum = 0;
+  size_t n;
+  while ((n = fread(chunk, 1, CHUNK, file)) > 0) {
+    for (size_t i = 0; i < n; i++) checksum = checksum * 31 + (unsigned char) chunk[i];
+  }
+  return checksum;
+}
+
+// small reads which are mostly served from the stream's buffer
+static unsigned int read_records(void) {
+  unsigned int checksum = 0;
+  char record[12];
+  while (fread(record, 1, sizeof(record), file) == sizeof(record)) {
+    checksum = checksum * 31 + (unsigned char) record[0] + (unsigned char) record[11];
+  }
+  return checksum;
+}
+
+static unsigned int read_lines(void) {
+  unsigned int checksum = 0;
+  while (fgets(line, sizeof(line), file)) {
+    checksum = checksum * 31 + (unsigned int) strlen(line) + (unsigned char) line[0];
+  }
+  return checksum;
+}
+
+static unsigned int read_getc(void) {
+  unsigned int checksum = 0;
+  int c;
+  while ((c = fgetc(file)) != EOF) checksum = checksum * 31 + c;
+  return checksum;
+}
+
+static unsigned int read_scanf(void) {
+  unsigned int checksum = 0;
+  int value;
+  while (fscanf(file, "%d", &value) == 1) checksum = checksum * 31 + (unsigned int) value;
+  return checksum;
+}
+
+static double total;
+
+static void run(const char* name, unsigned int (*fn)(void)) {
+  rewind(file);
+  double start = now_ms();
+  unsigned int checksum = fn();
+  double elapsed = now_ms() - start;
+  total += elapsed;
+  printf("%-14s %10.3f ms checksum %u\n", name, elapsed, checksum);
+}
+
+int main(int argc, char** argv) {
+  const char* filename = argc > 1 ? argv[1] : "input.txt";
+  file = fopen(filename, "r");
+  if (!file) {
+    printf("Failed to open %s\n", filename);
+    return 1;
+  }
+
+  run("fread_chunks", read_chunks);
+  run("fread_records", read_records);
+  run("fgets", read_lines);
+  run("fgetc", read_getc);
+  run("fscanf", read_scanf);
+  fclose(file);
+
+  printf("Read benchmark completed in %.3f ms\n", total);
+  return 0;
+}
@@ -1,5 +1,6 @@
 import * as fs from "fs";
 import {compile, runtime} from "../../src";
+import type {CompileOptions, Profile} from "../../src/generation/profile";
 import {performance} from "perf_hooks";
 import {BenchmarkBase, OptLevel} from "./base";
 
@@ -15,12 +16,12 @@ fs.readdirSync(SRC_DIR).filter(x => x.startsWith("test")).forEach(name =>
 // file used for benchmarking
 DATASET.set("benchmark.bmp", fs.readFileSync(`${__dirname}/jpeg/benchmark.bmp`, {}));
 
-function jpegCompile(name: "cjpeg" | "djpeg"): Promise<WebAssembly.Module> {
+function jpegCompile(name: "cjpeg" | "djpeg", options?: CompileOptions): Promise<WebAssembly.Module> {
     const source = new Map<string, string>();
     fs.readdirSync(SRC_DIR).filter(x => x.endsWith(".h") || x === `${name}.c` || CDJPEG.includes(x)).forEach(name =>
         source.set(name, fs.readFileSync(SRC_DIR + name, {encoding: "utf-8"})));
 
-    const bytes = compile(source, {FILES: "1"}).toBytes();
+    const bytes = compile(source, {FILES: "1"}, options).toBytes();
     fs.writeFileSync(`${__dirname}/${name}.wasm`, bytes);
     return WebAssembly.compile(bytes);
 }
@@ -34,13 +35,15 @@ function u8Equal(u8arr1: Uint8Array, u8arr2: Uint8Array) {
     return true;
 }
 
-async function jpegTest(m: WebAssembly.Module, cmdline: string[], outputFile: string, compareAgainst?: string): Promise<string> {
+async function jpegTest(m: WebAssembly.Module, cmdline: string[], outputFile: string, compareAgainst?: string,
+                        onExit?: (exports: WebAssembly.Exports) => void): Promise<string> {
     let output = "";
     const files = new runtime.Files((c) => output += c, undefined, DATASET);
     const module = await WebAssembly.instantiate(m, {c2wasm: {
         ...files.getImports(),
         __time: () => performance.now()
     }});
+    files.attach(module.exports);
 
     let err = undefined;
     try {
@@ -49,6 +52,8 @@ async function jpegTest(m: WebAssembly.Module, cmdline: string[], outputFile: st
         err = e;
     }
 
+    onExit?.(module.exports);
+
     const contents = files.getContents(outputFile);
     if (!contents) throw err ?? new Error("Failed test");
     // fs.writeFileSync(outputFile, contents);
@@ -85,10 +90,18 @@ export const cjpeg = (new class extends BenchmarkBase {
     }
 
     async c2wasmRun(): Promise<string> {
-        const cjpeg = await jpegCompile("cjpeg");
+        const cjpeg = await jpegCompile("cjpeg", {profile: BenchmarkBase.profile});
         return await jpegTest(cjpeg, ["cjpeg", "benchmark.bmp", "output.jpg"], "output.jpg");
     }
 
+    async c2wasmProfile(): Promise<Profile> {
+        const cjpeg = await jpegCompile("cjpeg", {instrument: true});
+        let profile: Profile | undefined;
+        await jpegTest(cjpeg, ["cjpeg", "benchmark.bmp", "output.jpg"], "output.jpg", undefined,
+            exports => profile = runtime.dumpProfile(exports));
+        return profile as Profile;
+    }
+
     async c2wasmSize(): Promise<number> {
         await jpegCompile("cjpeg");
         return (await fs.promises.stat(`${__dirname}/cjpeg.wasm`)).size;
@@ -117,5 +130,6 @@ export const cjpeg = (new class extends BenchmarkBase {
 
 if (require.main === module) {
     BenchmarkBase.setFlags(process.argv[2]);
+    BenchmarkBase.setProfile(process.argv[3]);
     (async () => console.log(await cjpeg.c2wasmRun()))();
 }
@@ -0,0 +1,79 @@
+import fs from "fs";
+import path from "path";
+import {performance} from "perf_hooks";
+import {BenchmarkBase, OptLevel} from "./base";
+import {compile} from "../../src";
+
+const SOURCE = fs.readFileSync(path.join(__dirname, "math", "math.c"), {encoding: "utf8"});
+
+// the c2wasm library, which is used for the score, and the same functions imported from JavaScript
+const VARIANTS: [name: string, definitions: {[key: string]: string}][] = [
+    ["library", {}],
+    ["imported", {JS_MATH: "1"}]
+];
+
+const JS_MATH = {
+    js_sin: Math.sin, js_cos: Math.cos, js_tan: Math.tan, js_asin: Math.asin, js_atan: Math.atan, js_atan2: Math.atan2,
+    js_exp: Math.exp, js_log: Math.log, js_log10: Math.log10, js_pow: Math.pow, js_fmod: (x: number, y: number) => x % y,
+    js_sinh: Math.sinh, js_tanh: Math.tanh
+};
+
+export const math = (new class extends BenchmarkBase {
+
+    getScore(output: string): number {
+        const match = output.match(/Math benchmark completed in ([0-9]+\.[0-9]+) ms/);
+        if (match) {
+            return Number(match[1]);
+        } else {
+            console.log(output);
+            throw new Error("Benchmark failed");
+        }
+    }
+
+    // runs every variant, prefixing each line with the variant name
+    async c2wasmRun(): Promise<string> {
+        let output = "";
+        for (const [name, definitions] of VARIANTS) {
+            let variantOutput = "";
+            const exports = await compile(SOURCE, definitions).execute({
+                c2wasm: {
+                    ...(definitions.JS_MATH ? JS_MATH : {}),
+                    __put_char: (c: number) => variantOutput += String.fromCharCode(c),
+                    __time: () => performance.now()
+                }
+            });
+            (exports.main as () => number)();
+            output += variantOutput.trim().split("\n").map(line => `${name}: ${line}\n`).join("");
+        }
+        return output;
+    }
+
+    async c2wasmSize(): Promise<number> {
+        return compile(SOURCE).toBytes().length;
+    }
+
+    async emccCompile(optLevel: OptLevel): Promise<void> {
+        await BenchmarkBase.cmdStdout(`emcc math/math.c ${optLevel} -o /tmp/c2wasm-math-emcc${optLevel}`);
+    }
+
+    async emccRun(optLevel: OptLevel, nodeFlags: string): Promise<string> {
+        return BenchmarkBase.cmdStdout(`node ${nodeFlags} /tmp/c2wasm-math-emcc${optLevel}`);
+    }
+
+    async emccSize(optLevel: OptLevel): Promise<number> {
+        return Number(await BenchmarkBase.cmdStdout(`stat -c %s /tmp/c2wasm-math-emcc${optLevel}.wasm`));
+    }
+
+    async nativeCompile(optLevel: OptLevel): Promise<void> {
+        await BenchmarkBase.cmdStdout(`gcc math/math.c ${optLevel} -lm -o /tmp/c2wasm-math-native${optLevel}`);
+    }
+
+    async nativeRun(optLevel: OptLevel): Promise<string> {
+        return BenchmarkBase.cmdStdout(`/tmp/c2wasm-math-native${optLevel}`);
+    }
+}("math", __filename));
+
+if (require.main === module) {
+    BenchmarkBase.setFlags(process.argv[2]);
+    (async () => console.log(await math.c2wasmRun()))();
+}
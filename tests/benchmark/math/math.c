@@ -0,0 +1,120 @@
+// calls math.h functions over tables of inputs, printing the time per call and a checksum of the results so the
+// implementations can be compared. with JS_MATH the functions are imported from JavaScript's Math instead
+#include <math.h>
+#include <stdio.h>
+#include <time.h>
+
+#ifdef JS_MATH
+import double js_sin(double);
+import double js_cos(double);
+import double js_tan(double);
+import double js_asin(double);
+import double js_atan(double);
+import double js_atan2(double, double);
+import double js_exp(double);
+import double js_log(double);
+import double js_log10(double);
+import double js_pow(double, double);
+import double js_fmod(double, double);
+import double js_sinh(double);
+import double js_tanh(double);
+#define sin js_sin
+#define cos js_cos
+#define tan js_tan
+#define asin js_asin
+#define atan js_atan
+#define atan2 js_atan2
+#define exp js_exp
+#define log js_log
+#define log10 js_log10
+#define pow js_pow
+#define fmod js_fmod
+#define sinh js_sinh
+#define tanh js_tanh
+#endif
+
+#define COUNT 1024
+#define ROUNDS 500
+
+static double angles[COUNT], units[COUNT], positives[COUNT], exponents[COUNT], small[COUNT];
+
+static unsigned int seed = 1;
+
+static double uniform(double a, double b) {
+  seed = seed * 1103515245 + 12345;
+  return a + (b - a) * (double) (seed >> 8) / 16777216.0;
+}
+
+static void generate(void) {
+  for (int i = 0; i < COUNT; i++) {
+    angles[i] = uniform(-10, 10);
+    units[i] = uniform(-1, 1);
+    positives[i] = uniform(0.01, 100);
+    exponents[i] = uniform(-20, 20);
+    small[i] = uniform(-5, 5);
+  }
+}
+
+static double now_ms(void) {
+  return (double) clock() * 1000 / CLOCKS_PER_SEC;
+}
+
+#define UNARY(name, input) \
+  static double run_##name(void) { \
+    double sum = 0; \
+    for (int i = 0; i < COUNT; i++) sum += name(input[i]); \
+    return sum; \
+  }
+
+#define BINARY(name, x, y) \
+  static double run_##name(void) { \
+    double sum = 0; \
+    for (int i = 0; i < COUNT; i++) sum += name(x[i], y[(i * 7) % COUNT]); \
+    return sum; \
+  }
+
+UNARY(sin, angles)
+UNARY(cos, angles)
+UNARY(tan, units)
+UNARY(asin, units)
+UNARY(atan, exponents)
+BINARY(atan2, units, angles)
+UNARY(exp, exponents)
+UNARY(log, positives)
+UNARY(log10, positives)
+BINARY(pow, positives, small)
+BINARY(fmod, exponents, positives)
+UNARY(sinh, small)
+UNARY(tanh, small)
+
+static double total;
+
+static void run(const char* name, double (*fn)(void)) {
+  double checksum = 0;
+  double start = now_ms();
+  for (int i = 0; i < ROUNDS; i++) checksum += fn();
+  double elapsed = now_ms() - start;
+  total += elapsed;
+  printf("%-6s %8.2f ns/call checksum %.9e\n", name, elapsed * 1e6 / ((double) COUNT * ROUNDS), checksum);
+}
+
+int main(void) {
+  generate();
+
+  run("sin", run_sin);
+  run("cos", run_cos);
+  run("tan", run_tan);
+  run("asin", run_asin);
+  run("atan", run_atan);
+  run("atan2", run_atan2);
+  run("exp", run_exp);
+  run("log", run_log);
+  run("log10", run_log10);
+  run("pow", run_pow);
+  run("fmod", run_fmod);
+  run("sinh", run_sinh);
+  run("tanh", run_tanh);
+
+  printf("Math benchmark completed in %.3f ms\n", total);
+  return 0;
+}
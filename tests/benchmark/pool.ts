@@ -0,0 +1,64 @@
+import {performance} from "perf_hooks";
+import {compile, runtime} from "../../src";
+
+// requests per second for many short runs of a filter program, instantiating each run or reusing pooled instances
+
+const source = `
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+
+// a table in the data segments, like the state a real filter would initialise
+static const char* keywords[] = {"alpha", "beta", "gamma", "delta", "epsilon", "zeta", "eta", "theta"};
+static int counts[256];
+
+int main(int argc, char *argv[]) {
+  const char* input = argv[argc - 1];
+  size_t n = strlen(input);
+  char* upper = malloc(n + 1);
+  for (size_t i = 0; i <= n; i++) upper[i] = toupper((unsigned char) input[i]);
+  for (size_t i = 0; i < n; i++) counts[(unsigned char) input[i]]++;
+
+  int matches = 0;
+  for (int k = 0; k < 8; k++) if (strstr(input, keywords[k])) matches++;
+  printf("%s %d %d\\n", upper, matches, counts['a']);
+  free(upper);
+  return matches;
+}`;
+
+const REQUESTS = 20000;
+const INPUT = "the alpha and the omega, gamma rays and delta waves";
+
+async function measure(name: string, fn: () => Promise<unknown>) {
+    for (let i = 0; i < 100; i++) await fn(); // warm up
+
+    const start = performance.now();
+    for (let i = 0; i < REQUESTS; i++) await fn();
+    const elapsed = performance.now() - start;
+    console.log(`${name.padEnd(24)} ${(REQUESTS / elapsed * 1000).toFixed(0).padStart(8)} requests/s`);
+}
+
+async function main() {
+    let output = "";
+    const imports = {c2wasm: {__put_char: (c: number) => output += String.fromCharCode(c)}};
+    const module = await compile(source).compileModule();
+
+    await measure("fresh instantiation", async () => {
+        output = "";
+        const instance = await WebAssembly.instantiate(module, imports);
+        runtime.mainWrapper(instance.exports, [INPUT]);
+    });
+
+    const pool = new runtime.InstancePool(module, imports);
+    await measure("instance pool", async () => {
+        output = "";
+        await pool.main([INPUT]);
+    });
+
+    if (output !== `${INPUT.toUpperCase()} 3 10\n`) throw new Error(`Unexpected output ${output}`);
+}
+
+if (require.main === module) {
+    main();
+}
@@ -19,11 +19,12 @@ async function run(): Promise<[string, Uint8Array]> {
     let output = "";
     const files = new Files((c) => output += c, undefined);
 
-    const {main} = (await WebAssembly.instantiate(await compileModule(), {c2wasm: {
+    const {exports} = await WebAssembly.instantiate(await compileModule(), {c2wasm: {
         __time: () => performance.now(),
         ...files.getImports()
-    }})).exports as { main: () => void};
-    main();
+    }});
+    files.attach(exports);
+    (exports as {main: () => void}).main();
 
     if (!output.includes("Rendered scene in ")) throw new Error("Failed test");
 
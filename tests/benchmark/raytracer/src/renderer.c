@@ -15,14 +15,6 @@ static RaycastHit findClosestHit(Scene *scene, Ray ray) {
   return closest;
 }
 
-#ifdef __c2wasm__
-static double pow(double a, double b) {
-    double r = 1; // assumes b is integer
-    for (int i = 0; i < b; i++) r *= a;
-    return r;
-}
-#endif
-
 static RGB illuminate(Scene *scene, Ray ray, RaycastHit hit) {
   RGB result = rgb_scale(hit.object->colour, scene->ambientLight);
 
@@ -0,0 +1,84 @@
+import fs from "fs";
+import path from "path";
+import {performance} from "perf_hooks";
+import {BenchmarkBase, OptLevel} from "./base";
+import {compile, runtime} from "../../src";
+
+const SOURCE = fs.readFileSync(path.join(__dirname, "io", "read.c"), {encoding: "utf8"});
+const INPUT_FILE = "/tmp/c2wasm-read-input.txt";
+
+// about 5 MiB of integers, one or more per line
+function generateInput(): Uint8Array {
+    let seed = 1;
+    const lines: string[] = [];
+    for (let i = 0; i < 600000; i++) {
+        seed = (Math.imul(seed, 1103515245) + 12345) >>> 0;
+        const value = (seed >>> 8) % 10000000 - 5000000;
+        lines.push(i % 4 === 0 ? `${value} ${value >> 3}` : `${value}`);
+    }
+    return new TextEncoder().encode(lines.join("\n") + "\n");
+}
+
+async function writeInputFile(): Promise<void> {
+    await fs.promises.writeFile(INPUT_FILE, generateInput());
+}
+
+export const read = (new class extends BenchmarkBase {
+
+    getScore(output: string): number {
+        const match = output.match(/Read benchmark completed in ([0-9]+\.[0-9]+) ms/);
+        if (match) {
+            return Number(match[1]);
+        } else {
+            console.log(output);
+            throw new Error("Benchmark failed");
+        }
+    }
+
+    async c2wasmRun(): Promise<string> {
+        let output = "";
+        const files = new runtime.Files((c) => output += c, undefined, new Map([["input.txt", generateInput()]]));
+
+        const exports = await compile(SOURCE, {FILES: "1"}).execute({
+            c2wasm: {
+                ...files.getImports(),
+                __time: () => performance.now()
+            }
+        });
+        files.attach(exports);
+        runtime.mainWrapper(exports, ["read", "input.txt"]);
+
+        return output;
+    }
+
+    async c2wasmSize(): Promise<number> {
+        return compile(SOURCE, {FILES: "1"}).toBytes().length;
+    }
+
+    async emccCompile(optLevel: OptLevel): Promise<void> {
+        await writeInputFile();
+        await BenchmarkBase.cmdStdout(`emcc io/read.c -s NODERAWFS=1 ${optLevel} -o /tmp/c2wasm-read-emcc${optLevel}`);
+    }
+
+    async emccRun(optLevel: OptLevel, nodeFlags: string): Promise<string> {
+        return BenchmarkBase.cmdStdout(`node ${nodeFlags} /tmp/c2wasm-read-emcc${optLevel} ${INPUT_FILE}`);
+    }
+
+    async emccSize(optLevel: OptLevel): Promise<number> {
+        return Number(await BenchmarkBase.cmdStdout(`stat -c %s /tmp/c2wasm-read-emcc${optLevel}.wasm`));
+    }
+
+    async nativeCompile(optLevel: OptLevel): Promise<void> {
+        await writeInputFile();
+        await BenchmarkBase.cmdStdout(`gcc io/read.c ${optLevel} -o /tmp/c2wasm-read-native${optLevel}`);
+    }
+
+    async nativeRun(optLevel: OptLevel): Promise<string> {
+        return BenchmarkBase.cmdStdout(`/tmp/c2wasm-read-native${optLevel} ${INPUT_FILE}`);
+    }
+}("read", __filename));
+
+if (require.main === module) {
+    BenchmarkBase.setFlags(process.argv[2]);
+    (async () => console.log(await read.c2wasmRun()))();
+}
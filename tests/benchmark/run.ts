@@ -1,9 +1,17 @@
+import fs from "fs";
 import {setFlags} from "../../src";
-import {BenchmarkBase, FLAG_CONFIGURATIONS, OptLevel} from "./base";
+import {allocator} from "./allocator";
+import {BenchmarkBase, FLAG_CONFIGURATIONS, OptLevel, PGO_CONFIGURATIONS} from "./base";
 import {coremark} from "./coremark";
+import {csv} from "./csv";
 import {cjpeg} from "./jpeg";
+import {math} from "./math";
 import {raytracer} from "./raytracer";
+import {read} from "./read";
+import {sort} from "./sort";
+import {strings} from "./strings";
 import {toy} from "./toy";
+import {trees} from "./trees";
 
 let latexOutput: boolean = false;
 
@@ -88,6 +96,18 @@ async function getRunners(benchmark: BenchmarkBase): Promise<[name: string, run:
         }, []]);
     }
 
+    // profile guided runners, using a profile from one instrumented run
+    if (benchmark.c2wasmProfile) {
+        setFlags("default");
+        const profileFile = `/tmp/c2wasm-${benchmark.name}-profile.json`;
+        await fs.promises.writeFile(profileFile, JSON.stringify(await benchmark.c2wasmProfile()));
+        for (const [name, flags] of PGO_CONFIGURATIONS.entries()) {
+            runners.push([`TurboFan ${name}`, () => {
+                setFlags(flags); return benchmark.c2wasmNodeFlagsRun("--no-liftoff", profileFile);
+            }, []]);
+        }
+    }
+
     const compilePromises: Promise<void>[] = [];
 
     // emcc runners
@@ -128,7 +148,7 @@ async function getRunners(benchmark: BenchmarkBase): Promise<[name: string, run:
 }
 
 if (require.main === module) {
-    const benchmarks = {cjpeg, coremark, raytracer, toy} as {[k: string]: BenchmarkBase};
+    const benchmarks = {allocator, cjpeg, coremark, csv, math, raytracer, read, sort, strings, toy, trees} as {[k: string]: BenchmarkBase};
     const requested = process.argv[2]?.toLowerCase();
 
     let benchmark;
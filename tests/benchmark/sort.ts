@@ -0,0 +1,72 @@
+import fs from "fs";
+import path from "path";
+import {performance} from "perf_hooks";
+import {BenchmarkBase, OptLevel} from "./base";
+import {compile} from "../../src";
+
+const SOURCE = fs.readFileSync(path.join(__dirname, "sort", "sort.c"), {encoding: "utf8"});
+
+// qsort swap implementations in the c2wasm library, the first is the default and is used for the score
+const VARIANTS: [name: string, definitions: {[key: string]: string}][] = [
+    ["word", {}],
+    ["simd", {QSORT_SIMD: "1"}]
+];
+
+export const sort = (new class extends BenchmarkBase {
+
+    getScore(output: string): number {
+        const match = output.match(/Sort benchmark completed in ([0-9]+\.[0-9]+) ms/);
+        if (match) {
+            return Number(match[1]);
+        } else {
+            console.log(output);
+            throw new Error("Benchmark failed");
+        }
+    }
+
+    // runs every variant, prefixing each line with the variant name
+    async c2wasmRun(): Promise<string> {
+        let output = "";
+        for (const [name, definitions] of VARIANTS) {
+            let variantOutput = "";
+            const exports = await compile(SOURCE, definitions).execute({
+                c2wasm: {
+                    __put_char: (c: number) => variantOutput += String.fromCharCode(c),
+                    __time: () => performance.now()
+                }
+            });
+            (exports.main as () => number)();
+            output += variantOutput.trim().split("\n").map(line => `${name}: ${line}\n`).join("");
+        }
+        return output;
+    }
+
+    async c2wasmSize(): Promise<number> {
+        return compile(SOURCE).toBytes().length;
+    }
+
+    async emccCompile(optLevel: OptLevel): Promise<void> {
+        await BenchmarkBase.cmdStdout(`emcc sort/sort.c -s ALLOW_MEMORY_GROWTH=1 ${optLevel} -o /tmp/c2wasm-sort-emcc${optLevel}`);
+    }
+
+    async emccRun(optLevel: OptLevel, nodeFlags: string): Promise<string> {
+        return BenchmarkBase.cmdStdout(`node ${nodeFlags} /tmp/c2wasm-sort-emcc${optLevel}`);
+    }
+
+    async emccSize(optLevel: OptLevel): Promise<number> {
+        return Number(await BenchmarkBase.cmdStdout(`stat -c %s /tmp/c2wasm-sort-emcc${optLevel}.wasm`));
+    }
+
+    async nativeCompile(optLevel: OptLevel): Promise<void> {
+        await BenchmarkBase.cmdStdout(`gcc sort/sort.c ${optLevel} -o /tmp/c2wasm-sort-native${optLevel}`);
+    }
+
+    async nativeRun(optLevel: OptLevel): Promise<string> {
+        return BenchmarkBase.cmdStdout(`/tmp/c2wasm-sort-native${optLevel}`);
+    }
+}("sort", __filename));
+
+if (require.main === module) {
+    BenchmarkBase.setFlags(process.argv[2]);
+    (async () => console.log(await sort.c2wasmRun()))();
+}
@@ -0,0 +1,110 @@
+// sorts 1M ints and 1M structs with qsort, each phase prints a checksum so the results can be compared between
+// implementations
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define COUNT 1000000
+
+struct record {
+  unsigned int key;
+  unsigned int id;
+  double weight;
+};
+
+struct packed {
+  unsigned int key, a, b;
+};
+
+static unsigned int seed = 1;
+
+static unsigned int next(void) {
+  seed = seed * 1103515245 + 12345;
+  return seed >> 8;
+}
+
+static double now_ms(void) {
+  return (double) clock() * 1000 / CLOCKS_PER_SEC;
+}
+
+static int cmp_int(const void* a, const void* b) {
+  int x = *(const int*) a, y = *(const int*) b;
+  return (x > y) - (x < y);
+}
+
+static int cmp_record(const void* a, const void* b) {
+  unsigned int x = ((const struct record*) a)->key, y = ((const struct record*) b)->key;
+  return (x > y) - (x < y);
+}
+
+static int cmp_packed(const void* a, const void* b) {
+  unsigned int x = ((const struct packed*) a)->key, y = ((const struct packed*) b)->key;
+  return (x > y) - (x < y);
+}
+
+static unsigned int int_checksum(const int* values) {
+  unsigned int checksum = 0;
+  for (int i = 1; i < COUNT; i++) {
+    if (values[i - 1] > values[i]) return 0;
+    checksum = checksum * 31 + (unsigned int) values[i];
+  }
+  return checksum;
+}
+
+static void report(const char* name, double start, unsigned int checksum) {
+  printf("%-16s %8.3f ms checksum %u\n", name, now_ms() - start, checksum);
+}
+
+int main() {
+  int* ints = malloc(COUNT * sizeof(int));
+  struct record* records = malloc(COUNT * sizeof(struct record));
+  struct packed* packed = malloc(COUNT * sizeof(struct packed));
+  double begin = now_ms(), start;
+
+  for (int i = 0; i < COUNT; i++) ints[i] = (int) next() - (1 << 23);
+  start = now_ms();
+  qsort(ints, COUNT, sizeof(int), cmp_int);
+  report("ints random", start, int_checksum(ints));
+
+  for (int i = 0; i < COUNT; i++) ints[i] = (int) (next() % 16);
+  start = now_ms();
+  qsort(ints, COUNT, sizeof(int), cmp_int);
+  report("ints duplicates", start, int_checksum(ints));
+
+  // ids are unique, so the checksum doesn't depend on the order of equal keys
+  for (int i = 0; i < COUNT; i++) {
+    records[i].key = next() % (COUNT / 4);
+    records[i].id = i;
+    records[i].weight = i * 0.5;
+  }
+  start = now_ms();
+  qsort(records, COUNT, sizeof(struct record), cmp_record);
+  unsigned int checksum = 0;
+  for (int i = 0; i < COUNT; i++) {
+    if (i > 0 && records[i - 1].key > records[i].key) checksum = 1;
+    if (records[i].weight != records[i].id * 0.5) checksum = 2;
+    checksum += records[i].key * 31 + records[i].id;
+  }
+  report("structs 16 bytes", start, checksum);
+
+  for (int i = 0; i < COUNT; i++) {
+    packed[i].key = next();
+    packed[i].a = i;
+    packed[i].b = ~i;
+  }
+  start = now_ms();
+  qsort(packed, COUNT, sizeof(struct packed), cmp_packed);
+  checksum = 0;
+  for (int i = 0; i < COUNT; i++) {
+    if (i > 0 && packed[i - 1].key > packed[i].key) checksum = 1;
+    if (packed[i].b != ~packed[i].a) checksum = 2;
+    checksum += packed[i].key * 31 + packed[i].a;
+  }
+  report("structs 12 bytes", start, checksum);
+
+  printf("Sort benchmark completed in %.3f ms\n", now_ms() - begin);
+  free(ints);
+  free(records);
+  free(packed);
+  return 0;
+}
@@ -0,0 +1,121 @@
+// runs strlen, strchr, memchr, strnlen, strcmp and memcmp over strings with mixed lengths and alignments, each phase
+// prints a checksum so the results can be compared between implementations
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#define COUNT 4096
+#define MAX_LEN 256
+#define ROUNDS 100
+
+static char pool[COUNT * (MAX_LEN + 16)];
+static char copies[COUNT * (MAX_LEN + 16) + 16];
+static char* strings[COUNT];
+static char* others[COUNT];
+static size_t lengths[COUNT];
+
+static unsigned int seed = 1;
+
+static unsigned int next(void) {
+  seed = seed * 1103515245 + 12345;
+  return seed >> 8;
+}
+
+static double now_ms(void) {
+  return (double) clock() * 1000 / CLOCKS_PER_SEC;
+}
+
+// mostly short strings, with some long ones. half of the copies have the same alignment as the original
+static void generate(void) {
+  char* p = pool;
+  char* q = copies;
+  for (int i = 0; i < COUNT; i++) {
+    size_t len = next() % 8 == 0 ? next() % MAX_LEN : next() % 48;
+    p += next() % 16;
+    q = copies + (p - pool) + (i % 2 ? 0 : next() % 16);
+
+    for (size_t j = 0; j < len; j++) p[j] = (char) ('a' + next() % 26);
+    p[len] = 0;
+    memcpy(q, p, len + 1);
+    if (len && next() % 2) q[next() % len] = '#';
+
+    strings[i] = p;
+    others[i] = q;
+    lengths[i] = len;
+    p += len + 1;
+    q += len + 1;
+  }
+}
+
+static int sign(int x) {
+  return (x > 0) - (x < 0);
+}
+
+static unsigned int run_strlen(void) {
+  unsigned int checksum = 0;
+  for (int i = 0; i < COUNT; i++) checksum = checksum * 31 + (unsigned int) strlen(strings[i]);
+  return checksum;
+}
+
+static unsigned int run_strchr(void) {
+  unsigned int checksum = 0;
+  for (int i = 0; i < COUNT; i++) {
+    const char* found = strchr(strings[i], 'z');
+    checksum = checksum * 31 + (found ? (unsigned int) (found - strings[i]) : 1000);
+  }
+  return checksum;
+}
+
+static unsigned int run_memchr(void) {
+  unsigned int checksum = 0;
+  for (int i = 0; i < COUNT; i++) {
+    const char* found = memchr(strings[i], 'q', lengths[i]);
+    checksum = checksum * 31 + (found ? (unsigned int) (found - strings[i]) : 1000);
+  }
+  return checksum;
+}
+
+static unsigned int run_strnlen(void) {
+  unsigned int checksum = 0;
+  for (int i = 0; i < COUNT; i++) checksum = checksum * 31 + (unsigned int) strnlen(strings[i], 100);
+  return checksum;
+}
+
+static unsigned int run_strcmp(void) {
+  unsigned int checksum = 0;
+  for (int i = 0; i < COUNT; i++) checksum = checksum * 31 + (unsigned int) (sign(strcmp(strings[i], others[i])) + 1);
+  return checksum;
+}
+
+static unsigned int run_memcmp(void) {
+  unsigned int checksum = 0;
+  for (int i = 0; i < COUNT; i++) {
+    checksum = checksum * 31 + (unsigned int) (sign(memcmp(strings[i], others[i], lengths[i])) + 1);
+  }
+  return checksum;
+}
+
+static double total;
+
+static void run(const char* name, unsigned int (*fn)(void)) {
+  unsigned int checksum = 0;
+  double start = now_ms();
+  for (int i = 0; i < ROUNDS; i++) checksum += fn();
+  double elapsed = now_ms() - start;
+  total += elapsed;
+  printf("%-8s %10.3f ms checksum %u\n", name, elapsed, checksum);
+}
+
+int main(void) {
+  generate();
+
+  run("strlen", run_strlen);
+  run("strchr", run_strchr);
+  run("memchr", run_memchr);
+  run("strnlen", run_strnlen);
+  run("strcmp", run_strcmp);
+  run("memcmp", run_memcmp);
+
+  printf("Strings benchmark completed in %.3f ms\n", total);
+  return 0;
+}
@@ -21,9 +21,20 @@ const benchmarkDir = (() => {
     return path.join(projectDir, "tests", "benchmark");
 })();
 
+// coremark and the jpeg tests always run. the library micro-benchmarks are slow (e.g. sorting 1M elements), so only
+// run with C2WASM_BENCHMARKS=1, and the library's correctness is tested at smaller sizes in tests/samples
+const benchmarkTest = process.env.C2WASM_BENCHMARKS ? test : test.skip;
+
 /* eslint-disable @typescript-eslint/no-var-requires */
 require('ts-node').register({});
+const allocator = require(path.join(benchmarkDir, "allocator")).allocator as BenchmarkBase;
 const coremark = require(path.join(benchmarkDir, "coremark")).coremark as BenchmarkBase;
+const csv = require(path.join(benchmarkDir, "csv")).csv as BenchmarkBase;
+const math = require(path.join(benchmarkDir, "math")).math as BenchmarkBase;
+const read = require(path.join(benchmarkDir, "read")).read as BenchmarkBase;
+const sort = require(path.join(benchmarkDir, "sort")).sort as BenchmarkBase;
+const strings = require(path.join(benchmarkDir, "strings")).strings as BenchmarkBase;
+const trees = require(path.join(benchmarkDir, "trees")).trees as BenchmarkBase;
 const jpegTests = require(path.join(benchmarkDir, "jpeg")).jpegTests as () => Promise<void>;
 
 test("coremark", async t => {
@@ -32,6 +43,78 @@ test("coremark", async t => {
     t.truthy(coremark.getScore(output));
 });
 
+benchmarkTest("allocator", async t => {
+    const output = await allocator.c2wasmRun();
+    t.log(output);
+    t.truthy(allocator.getScore(output));
+});
+
+benchmarkTest("csv", async t => {
+    const output = await csv.c2wasmRun();
+    t.log(output);
+    t.truthy(csv.getScore(output));
+
+    // printf and strtod are exact, so the checksums are the same as a native build
+    const checksums = [...output.matchAll(/checksum ([0-9]+)/g)].map(match => match[1]);
+    t.deepEqual(checksums, ["3255305430", "926139416", "926139416", "0"]);
+});
+
+benchmarkTest("math", async t => {
+    const output = await math.c2wasmRun();
+    t.log(output);
+    t.truthy(math.getScore(output));
+
+    // the library and Math give the same checksums, up to rounding
+    const checksums = (variant: string) => output.split("\n")
+        .filter(line => line.startsWith(variant + ":"))
+        .map(line => Number(line.match(/checksum (\S+)/)?.[1]));
+    const library = checksums("library"), imported = checksums("imported");
+    t.is(library.length, 13);
+    t.is(imported.length, 13);
+    library.forEach((c, i) => t.true(Math.abs(c - imported[i]) <= 1e-8 * Math.abs(imported[i]), `${c} ${imported[i]}`));
+});
+
+benchmarkTest("read", async t => {
+    const output = await read.c2wasmRun();
+    t.log(output);
+    t.truthy(read.getScore(output));
+});
+
+benchmarkTest("sort", async t => {
+    const output = await sort.c2wasmRun();
+    t.log(output);
+    t.truthy(sort.getScore(output));
+
+    // both qsort variants give the same checksums as a native build
+    const checksums = (variant: string) => output.split("\n")
+        .filter(line => line.startsWith(variant + ":"))
+        .map(line => line.match(/checksum ([0-9]+)/)?.[1])
+        .filter(c => c !== undefined);
+    t.deepEqual(checksums("word"), ["3992897440", "1132367750", "3747375288", "3941126267"]);
+    t.deepEqual(checksums("simd"), checksums("word"));
+});
+
+benchmarkTest("strings", async t => {
+    const output = await strings.c2wasmRun();
+    t.log(output);
+    t.truthy(strings.getScore(output));
+
+    // all string.h variants give the same checksums
+    const checksums = (variant: string) => output.split("\n")
+        .filter(line => line.startsWith(variant + ":"))
+        .map(line => line.match(/checksum ([0-9]+)/)?.[1])
+        .filter(c => c !== undefined);
+    t.is(checksums("word").length, 6);
+    t.deepEqual(checksums("bytewise"), checksums("word"));
+    t.deepEqual(checksums("simd"), checksums("word"));
+});
+
+benchmarkTest("trees", async t => {
+    const output = await trees.c2wasmRun();
+    t.log(output);
+    t.truthy(trees.getScore(output));
+});
+
 test("jpeg tests", async t => {
     await t.notThrowsAsync(jpegTests);
 });
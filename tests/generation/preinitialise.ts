@@ -0,0 +1,81 @@
+import test from "ava";
+import {compile} from "../../src/compile";
+
+const source = `
+#include <stdlib.h>
+
+static unsigned int* table;
+static int builds;
+
+static void build_table(void) {
+  table = malloc(256 * sizeof(unsigned int));
+  for (unsigned int n = 0; n < 256; n++) {
+    unsigned int c = n;
+    for (int k = 0; k < 8; k++) c = c & 1 ? 0xEDB88320 ^ (c >> 1) : c >> 1;
+    table[n] = c;
+  }
+  builds++;
+}
+
+void init(void) {
+  if (!table) build_table();
+}
+
+unsigned int crc32(const char* s) {
+  init();
+  unsigned int c = 0xFFFFFFFF;
+  while (*s) c = table[(c ^ (unsigned char) *s++) & 0xFF] ^ (c >> 8);
+  return c ^ 0xFFFFFFFF;
+}
+
+unsigned int check(void) {
+  return crc32("123456789");
+}
+
+int table_builds(void) { return builds; }
+`;
+
+type Exports = {check: () => number, table_builds: () => number, init?: () => void};
+
+test("pre-initialised tables", async t => {
+    const normal = compile(source);
+    const initialised = compile(source, undefined, {initialise: "init"});
+
+    // init keeps its body for crc32, which sees the table is already built, but can't be called again directly
+    const exports = await initialised.execute({}) as Exports;
+    t.is(exports.init, undefined);
+    t.is(exports.table_builds(), 1);
+    t.is(exports.check() >>> 0, 0xCBF43926);
+    t.is(exports.table_builds(), 1);
+
+    const normalExports = await normal.execute({}) as Exports;
+    t.is(normalExports.table_builds(), 0);
+    t.is(normalExports.check() >>> 0, 0xCBF43926);
+    t.is(normalExports.table_builds(), 1);
+});
+
+test("pre-initialisation removes functions only init used", async t => {
+    const source = `
+static int value;
+static void setup(void) { value = 42; }
+void init(void) { setup(); }
+int get(void) { return value; }
+`;
+    const normal = compile(source);
+    const initialised = compile(source, undefined, {initialise: "init"});
+    t.true(initialised.functions.length < normal.functions.length);
+
+    const exports = await initialised.execute({}) as {get: () => number, init?: () => void};
+    t.is(exports.init, undefined);
+    t.is(exports.get(), 42);
+});
+
+test("pre-initialisation can't call imports", t => {
+    t.throws(() => compile(`
+#include <stdio.h>
+void init(void) { putchar('x'); }
+`, undefined, {initialise: "init"}), {message: /called import/});
+
+    t.throws(() => compile(`int init(int x) { return x; }`, undefined, {initialise: "init"}));
+    t.throws(() => compile(`void other(void) {}`, undefined, {initialise: "init"}));
+});
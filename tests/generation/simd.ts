@@ -0,0 +1,42 @@
+import test from "ava";
+import {compile} from "../../src/compile";
+import {v128Type} from "../../src/wasm";
+
+test("simd128 intrinsics", async t => {
+    const module = compile(`
+#include <wasm/simd128.h>
+
+int a[8] = {1, 2, 3, 4, 5, 6, 7, 8};
+int b[8] = {10, 20, 30, 40, 50, 60, 70, 80};
+int out[8];
+
+static v128_t madd(v128_t x, v128_t y, int k) {
+  return i32x4_add(i32x4_mul(x, i32x4_splat(k)), y);
+}
+
+int test(int k) {
+  v128_t sum = v128_zero();
+  for (int i = 0; i < 8; i += 4) {
+    v128_t r = madd(v128_load(a + i), v128_load(b + i), k);
+    v128_store(out + i, r);
+    sum = i32x4_add(sum, r);
+  }
+
+  // horizontal sum using a shuffle
+  sum = i32x4_add(sum, i8x16_shuffle(sum, sum, 8, 9, 10, 11, 12, 13, 14, 15, 0, 1, 2, 3, 4, 5, 6, 7));
+  return i32x4_extract_lane(sum, 0) + i32x4_extract_lane(sum, 1);
+}
+
+int lanes() {
+  v128_t v = i32x4_replace_lane(i32x4_splat(5), 2, -1);
+  v128_t mask = i32x4_gt_s(v, i32x4_splat(0));
+  return i32x4_bitmask(mask) * 100 + out[7];
+}`);
+
+    // v128 values are kept in locals, not on the shadow stack
+    t.true(module.functions.some(f => f.locals.includes(v128Type)));
+
+    const {test: testFn, lanes} = await module.execute({}) as {test: (k: number) => number, lanes: () => number};
+    t.is(testFn(3), 36 * 3 + 360);
+    t.is(lanes(), 0b1011 * 100 + 8 * 3 + 80);
+});
@@ -78,3 +78,106 @@ test("regression #1", async t => {
 
     t.is(c.main(), 11); // returns 22 if broken
 });
+
+test("small structs returned as multiple values", async t => {
+    const module = compileSnippet(`
+        typedef struct {int quot; int rem;} div_result;
+        struct vec3 {float x, y, z;};
+
+        div_result divide(int a, int b) {
+          div_result r = {a / b, a % b};
+          return r;
+        }
+
+        static struct vec3 scale(struct vec3 v, float k) {
+          struct vec3 out = {v.x * k, v.y * k, v.z * k};
+          return out;
+        }
+
+        int main() {
+          struct vec3 v = {1, 2, 3};
+          v = scale(v, 2.5f);
+          divide(1, 1);
+          div_result d = divide(47, 5);
+          return d.quot * 1000 + d.rem * 100 + (int) (v.x + v.y + v.z);
+        }
+    `);
+
+    // both functions return each member as a separate value
+    t.true(module.functions.some(f => f.type[1].length === 2));
+    t.true(module.functions.some(f => f.type[1].length === 3));
+
+    const c = await module.execute({}) as {
+        main: () => number,
+        divide: (a: number, b: number) => number[]
+    };
+    t.is(c.main(), 9000 + 200 + 15);
+    t.deepEqual(c.divide(23, 4), [5, 3]);
+});
+
+test("small structs passed as multiple values", async t => {
+    const module = compileSnippet(`
+        struct point {int x; char tag; double weight;};
+
+        static double weighted(struct point p) {
+          p.x += 1;
+          return (p.x + p.tag) * p.weight;
+        }
+
+        static int sum(int* values, int n) {
+          int total = 0;
+          for (int i = 0; i < n; i++) total += values[i];
+          return total;
+        }
+
+        static int addressTaken(struct point p, int scale) {
+          return sum(&p.x, 1) * scale + p.tag;
+        }
+
+        int main() {
+          struct point p = {4, 3, 1.5};
+          return (int) weighted(p) * 1000 + addressTaken(p, 10) + p.x;
+        }
+    `);
+
+    // each member is a separate argument
+    t.true(module.functions.some(f => f.type[0].length === 3));
+
+    const c = await module.execute({}) as {main: () => number};
+    t.is(c.main(), 12000 + 43 + 4);
+});
+
+test("small structs returned as multiple values stay in locals", async t => {
+    const module = compileSnippet(`
+        import int input();
+
+        typedef struct {int lo; int hi;} range;
+
+        static range make(int lo, int hi) {
+          range r = {lo, hi};
+          return r;
+        }
+
+        static range widen(range r, int by) {
+          return make(r.lo - by, r.hi + by);
+        }
+
+        static int width(range r) {
+          return r.hi - r.lo;
+        }
+
+        int main() {
+          range r = make(0, 0);
+          r = widen(make(input(), 20), 1);
+          return width(widen(r, 1)) * 100 + width(widen(widen(make(input(), 30), 1), 1));
+        }
+    `);
+
+    // the values returned by make are returned directly, without a copy through memory
+    const widen = module.functions.find(f => f.type[0].length === 3 && f.type[1].length === 2);
+    t.truthy(widen);
+    t.false([...widen!.body.instructionsRecursive()].some(i => i.name.includes("load") || i.name.includes("store")));
+
+    const c = await module.execute({input: () => 10}) as {main: () => number};
+    t.is(c.main(), 1400 + 24);
+});
@@ -5,7 +5,7 @@ import {ModuleBuilder, WExpression} from "../../src/wasm";
 
 export function optimisationTest(title: string,
                                  flags: Partial<OptimisationFlags>,
-                                 fn: (t: ExecutionContext, defaultModule: ModuleBuilder, flagsModule: ModuleBuilder) => void,
+                                 fn: (t: ExecutionContext, defaultModule: ModuleBuilder, flagsModule: ModuleBuilder) => void | Promise<void>,
                                  src: string): void {
     test.serial(title, t => {
         setFlags("none");
@@ -14,7 +14,7 @@ export function optimisationTest(title: string,
         const flagsModule = compileSnippet(src);
         setFlags("default"); // restore flags
 
-        fn(t, originalModule, flagsModule);
+        return fn(t, originalModule, flagsModule);
     });
 }
 
@@ -56,3 +56,42 @@ optimisationTest("live range splitting", {
       g(c, a);
     }
 `);
+
+optimisationTest("copy coalescing", {
+    reallocate_locals: true
+}, async (t, _, withOpt) => {
+    // b = t is a copy, but t is defined while b's old value is still needed by a = b, so a, b, t & i all clash
+    t.is(withOpt.functions[0].locals.length, 4);
+
+    const {fib} = await withOpt.execute({}) as {fib: (n: number) => number};
+    t.deepEqual([fib(0), fib(1), fib(2), fib(10)], [0, 1, 1, 55]);
+},`
+    int fib(int n) {
+      int a = 0, b = 1;
+      for (int i = 0; i < n; i++) {
+        int t = a + b;
+        a = b;
+        b = t;
+      }
+      return a;
+    }
+`);
+
+optimisationTest("copy coalescing shares local", {
+    reallocate_locals: true
+}, async (t, _, withOpt) => {
+    // s is dead when t is defined and s = t is a copy, so s & t share a local and only clash with i
+    t.deepEqual(withOpt.functions[0].locals, [i32Type, i32Type]);
+
+    const {sum} = await withOpt.execute({}) as {sum: (n: number) => number};
+    t.deepEqual([sum(0), sum(1), sum(5)], [0, 0, 10]);
+},`
+    int sum(int n) {
+      int s = 0;
+      for (int i = 0; i < n; i++) {
+        int t = s + i;
+        s = t;
+      }
+      return s;
+    }
+`);
@@ -0,0 +1,82 @@
+import test from "ava";
+import {compile, stdLibrary} from "../../src/compile";
+import {Files} from "../../src/c_library/runtime/files";
+import {Linker} from "../../src/linker";
+import {setFlags} from "../../src/optimisation/flags";
+
+const source = `
+#include <stdio.h>
+
+struct point { int x, y; };
+
+void main() {
+  char buf[64], small[8];
+  struct point p = {3, -4};
+  int x = p.x;
+  const char* name = "world";
+  long big = -9000000000;
+  double d = 3.14159;
+
+  printf("hello %s!\\n", name);
+  printf("[%5d|%-5d|%05d|%+d|% d]\\n", p.x, p.y, 42, 7, 7);
+  printf("[%x|%#X|%o|%#o|%b|%hhd|%hu|%lu|%ld]\\n", 255, 255, 8, 8, 5, 300, -1, 12345678901, big);
+  printf("[%f|%.2f|%8.3f|%-8.1f|%e|%.3E|%g|%G]\\n", d, d, d, d, d * 1e10, d, 0.0001, 1e20);
+  printf("[%c|%3c|%-3c|%.2s|%6s|%-6s|%p|%%|%q]\\n", 'A', 'B', 'C', name, name, name, (void*) 0x1234);
+  printf("no conversions\\n");
+
+  int n = sprintf(buf, "%d,%s", x * 10, name);
+  printf("%s %d\\n", buf, n);
+  n = snprintf(small, sizeof(small), "%d-%d-%d", 111, 222, 333);
+  printf("%s %d %d\\n", small, n, snprintf(NULL, 0, "%s", name));
+
+  // word is read from memory, so must be read before any output is written over it
+  long word = 51;
+  long* wp = &word;
+  n = sprintf((char*) wp, "ab%ld", word);
+  printf("%s %d\\n", (char*) wp, n);
+
+  // not specialised
+  printf("%*d|%s\\n", 4, 5, (sprintf(buf, "%x", 48879), buf));
+}`;
+
+function run(flag: boolean, definitions?: {[key: string]: string}): Promise<string> {
+    setFlags({specialise_printf: flag});
+    const module = compile(source, definitions);
+    setFlags("default");
+
+    let output = "";
+    const files = new Files(c => output += c);
+    return module.execute({c2wasm: definitions ? files.getImports() : {__put_char: (c: number) => output += String.fromCharCode(c)}})
+        .then(exports => (exports.main as () => void)())
+        .then(() => output);
+}
+
+test.serial("printf specialisation output", async t => {
+    const expected = await run(false);
+    t.true(expected.startsWith("hello world!\n[    3|-4   |00042|+7| 7]\n"));
+    t.true(expected.includes("ab51 4\n"));
+    t.is(await run(true), expected);
+});
+
+test.serial("fprintf specialisation output", async t => {
+    const expected = await run(false, {FILES: "1"});
+    t.is(await run(true, {FILES: "1"}), expected);
+});
+
+test.serial("printf specialisation linking", t => {
+    const linked = (flag: boolean) => {
+        setFlags({specialise_printf: flag});
+        const map = new Map([["main.c", `#include <stdio.h>\nvoid test(int x) { printf("x=%d\\n", x); }`]]);
+        const linker = new Linker(map);
+        linker.link(stdLibrary());
+        setFlags("default");
+        return linker.emitFunctions.map(f => f.name);
+    };
+
+    t.true(linked(false).includes("_vsnprintf"));
+    const functions = linked(true);
+    t.false(functions.includes("_vsnprintf"));
+    t.false(functions.includes("printf"));
+    t.true(functions.includes("__printf_signed"));
+    t.false(functions.includes("__printf_double"));
+});
@@ -0,0 +1,175 @@
+import test from "ava";
+import {foldPureCalls} from "../../src/optimisation/interprocedural/pure_calls";
+import {ModuleBuilder, Instructions, ValueType, i32Type, i64Type, f32Type, f64Type} from "../../src/wasm";
+import {WInstruction} from "../../src/wasm/instructions";
+import {countInstructions, optimisationTest} from "./index";
+
+function countAll(instrName: string, module: ModuleBuilder): number {
+    return module.functions.reduce((sum, fn) => sum + countInstructions(instrName, fn.body, true), 0);
+}
+
+optimisationTest("pure calls with constant arguments are folded", {
+    fold_pure_calls: true,
+    peephole_constant_if: true
+}, (t, withoutOpt, withOpt) => {
+    t.is(withoutOpt.functions.length, 4);
+    t.is(countAll("call", withoutOpt), 5);
+
+    // the helpers are only used with constants, so they're removed once the calls are folded
+    t.is(withOpt.functions.length, 1);
+    t.is(countAll("call", withOpt), 0);
+}, `
+static int is_digit(int c) { return c >= '0' && c <= '9'; }
+
+static unsigned crc8(unsigned x) {
+  for (int i = 0; i < 8; i++) x = x & 1 ? (x >> 1) ^ 0x8C : x >> 1;
+  return x;
+}
+
+static int fib(int n) { return n < 2 ? n : fib(n - 1) + fib(n - 2); }
+
+int test(void) { return is_digit('7') ? crc8(49) : fib(15); }
+`);
+
+optimisationTest("calls are kept when the arguments aren't constant or the callee traps", {
+    fold_pure_calls: true
+}, (t, withoutOpt, withOpt) => {
+    t.is(withOpt.functions.length, withoutOpt.functions.length);
+    t.is(countAll("call", withOpt), 2);
+}, `
+static int divide(int a, int b) { return a / b; }
+
+int test(int x) { return divide(x, 2) + divide(1, 0); }
+`);
+
+optimisationTest("functions using memory aren't folded", {
+    fold_pure_calls: true
+}, (t, withoutOpt, withOpt) => {
+    t.is(countAll("call", withOpt), 1);
+}, `
+static int counter;
+static int next(int step) { return counter += step; }
+
+int test(void) { return next(1); }
+`);
+
+type Exports = {[name: string]: unknown};
+
+// the result of calling fn, or the message it traps with
+function result(fn: () => unknown): unknown {
+    try {
+        return fn();
+    } catch (e) {
+        if (e instanceof WebAssembly.RuntimeError) return e.message;
+        throw e;
+    }
+}
+
+optimisationTest("folded calls give the same results as the calls", {
+    fold_pure_calls: true
+}, async (t, withoutOpt, withOpt) => {
+    t.true(countAll("call", withOpt) < countAll("call", withoutOpt));
+
+    const expected = await withoutOpt.execute({}) as Exports, actual = await withOpt.execute({}) as Exports;
+    for (const [name, fn] of Object.entries(expected)) {
+        if (typeof fn !== "function") continue;
+        t.is(result(actual[name] as () => unknown), result(fn as () => unknown), name);
+    }
+}, `
+static int divide(int a, int b) { return a / b; }
+static int remainder(int a, int b) { return a % b; }
+static long mul64(long a, long b) { return a * b; }
+static long div64(long a, long b) { return a / b; }
+static long rem64(long a, long b) { return a % b; }
+static unsigned long shr64(unsigned long a, int n) { return a >> n; }
+static float add32(float a, float b) { return a + b; }
+static double scale(double x, int n) { while (n-- > 0) x *= 1.1; return x; }
+static int to_int(double x) { return (int) x; }
+static unsigned to_unsigned(double x) { return (unsigned) x; }
+static long to_long(double x) { return (long) x; }
+static unsigned long to_ulong(double x) { return (unsigned long) x; }
+static float to_float(long x) { return (float) x; }
+
+int int_div(void) { return divide(-7, 2); }
+int int_div_min(void) { return divide(-2147483647 - 1, -1); }
+int int_div_zero(void) { return divide(1, 0); }
+int int_rem(void) { return remainder(-7, 2); }
+int int_rem_min(void) { return remainder(-2147483647 - 1, -1); }
+long long_mul_overflow(void) { return mul64(0x7FFFFFFFFFFFFFFF, 3); }
+long long_div(void) { return div64(-7, 2); }
+long long_div_min(void) { return div64(-0x7FFFFFFFFFFFFFFF - 1, -1); }
+long long_rem(void) { return rem64(-7, 2); }
+long long_rem_min(void) { return rem64(-0x7FFFFFFFFFFFFFFF - 1, -1); }
+unsigned long ulong_shift(void) { return shr64(0x8000000000000000, 63); }
+float float_rounding(void) { return add32(16777216.0f, 1.0f); }
+double double_loop(void) { return scale(1.0, 40); }
+int double_to_int(void) { return to_int(-1e10); }
+unsigned double_to_unsigned(void) { return to_unsigned(-1.5); }
+unsigned double_to_unsigned_large(void) { return to_unsigned(5e9); }
+long double_to_long(void) { return to_long(-9.75); }
+long double_to_long_large(void) { return to_long(1e19); }
+unsigned long double_to_ulong(void) { return to_ulong(1e19); }
+unsigned long double_to_ulong_negative(void) { return to_ulong(-1.0); }
+float long_to_float(void) { return to_float(0x20000000000001); }
+`);
+
+const I32_MIN = -0x80000000, I64_MIN = -(2n ** 63n);
+
+type Case = [instr: string, params: ValueType[], result: ValueType, args: (number | bigint)[]];
+
+function unary(instr: string, param: ValueType, result: ValueType, values: (number | bigint)[]): Case[] {
+    return values.map(x => [instr, [param], result, [x]]);
+}
+
+// instructions C can't produce directly and their edge cases, each called with constant arguments
+const cases: Case[] = [
+    ...unary("f64.nearest", f64Type, f64Type, [0.5, 1.5, 2.5, -0.5, -2.5, -0, 2 ** 52 - 0.5]),
+    ...unary("f32.nearest", f32Type, f32Type, [2.5, -3.5, 0.5]),
+    ["i32.rotl", [i32Type, i32Type], i32Type, [I32_MIN + 1, 1]],
+    ["i32.rotl", [i32Type, i32Type], i32Type, [I32_MIN + 1, 33]],
+    ["i32.rotr", [i32Type, i32Type], i32Type, [1, 32]],
+    ["i64.rotl", [i64Type, i64Type], i64Type, [I64_MIN + 1n, 1n]],
+    ["i64.rotr", [i64Type, i64Type], i64Type, [1n, 65n]],
+    ["i32.div_s", [i32Type, i32Type], i32Type, [I32_MIN, -1]],
+    ["i32.rem_s", [i32Type, i32Type], i32Type, [I32_MIN, -1]],
+    ["i64.div_s", [i64Type, i64Type], i64Type, [I64_MIN, -1n]],
+    ["i64.rem_s", [i64Type, i64Type], i64Type, [I64_MIN, -1n]],
+    ["i64.shr_s", [i64Type, i64Type], i64Type, [I64_MIN, 65n]],
+    ...unary("i32.trunc_sat_f64_s", f64Type, i32Type, [NaN, 1e10, -1e10]),
+    ...unary("i32.trunc_sat_f64_u", f64Type, i32Type, [-1.5, 5e9]),
+    ...unary("i64.trunc_sat_f64_s", f64Type, i64Type, [1e19, -1e19, -9.75]),
+    ...unary("i64.trunc_sat_f64_u", f64Type, i64Type, [1e20, -0.5, 2 ** 64 - 2048]),
+    ...unary("i32.trunc_f64_u", f64Type, i32Type, [3e9, -0.9, -1]),
+    ["f32.add", [f32Type, f32Type], f32Type, [16777216, 1]],
+    ["f64.min", [f64Type, f64Type], f64Type, [0, -0]],
+    ["f64.copysign", [f64Type, f64Type], f64Type, [1, -0]],
+    ...unary("f32.convert_i64_s", i64Type, f32Type, [2n ** 53n + 1n]),
+    ...unary("f64.convert_i64_u", i64Type, f64Type, [-1n]),
+    ...unary("i64.ctz", i64Type, i64Type, [0n]),
+];
+
+function constant(type: ValueType, value: number | bigint): WInstruction {
+    if (type === i32Type) return Instructions.i32.const(value);
+    if (type === i64Type) return Instructions.i64.const(value as bigint);
+    if (type === f32Type) return Instructions.f32.const(value as number);
+    return Instructions.f64.const(value as number);
+}
+
+test.serial("folded instructions match the engine", async t => {
+    const instructions = Instructions as unknown as {[group: string]: {[name: string]: () => WInstruction}};
+    for (const [instr, params, resultType, args] of cases) {
+        const [group, name] = instr.split(".");
+        const modules = [false, true].map(fold => {
+            const module = new ModuleBuilder();
+            const fn = module.function(params, [resultType], b =>
+                [...b.args.map(x => Instructions.local.get(x)), instructions[group][name]()]);
+            module.function([], [resultType], () =>
+                [...args.map((x, i) => constant(params[i], x)), Instructions.call(fn)], "test");
+            if (fold) foldPureCalls(module);
+            return module;
+        });
+
+        const [expected, actual] = await Promise.all(modules.map(async m => (await m.execute({}) as Exports).test));
+        t.is(result(actual as () => unknown), result(expected as () => unknown), `${instr}(${args.join(", ")})`);
+    }
+});
@@ -0,0 +1,61 @@
+import {ModuleBuilder} from "../../src/wasm";
+import {countInstructions, optimisationTest} from "./index";
+
+function countAll(instrName: string, module: ModuleBuilder): number {
+    return module.functions.reduce((sum, fn) => sum + countInstructions(instrName, fn.body, true), 0);
+}
+
+optimisationTest("constant function pointer clones", {
+    specialise_function_pointers: true
+}, (t, withoutOpt, withOpt) => {
+    t.is(withoutOpt.functions.length, 5);
+    t.is(countAll("call_indirect", withoutOpt), 1);
+
+    // best is replaced by a clone for each comparator
+    t.is(withOpt.functions.length, 6);
+    t.is(countAll("call_indirect", withOpt), 0);
+}, `
+typedef int cmp_t(int, int);
+static int less(int a, int b) { return a < b; }
+static int greater(int a, int b) { return a > b; }
+
+static int best(const int* p, int n, cmp_t* cmp) {
+  int r = p[0];
+  for (int i = 1; i < n; i++) if (cmp(p[i], r)) r = p[i];
+  return r;
+}
+
+int min(const int* p, int n) { return best(p, n, less); }
+int max(const int* p, int n) { return best(p, n, greater); }
+`);
+
+optimisationTest("recursive calls use the clone", {
+    specialise_function_pointers: true
+}, (t, withoutOpt, withOpt) => {
+    t.is(withoutOpt.functions.length, 3);
+
+    t.is(withOpt.functions.length, 3);
+    t.is(countAll("call_indirect", withOpt), 0);
+}, `
+static int apply(int (*f)(int), int x, int n) {
+  return n == 0 ? x : apply(f, f(x), n - 1);
+}
+
+static int twice(int x) { return x * 2; }
+
+int test(int x) { return apply(twice, x, 3); }
+`);
+
+optimisationTest("pointers which aren't constant are unchanged", {
+    specialise_function_pointers: true
+}, (t, withoutOpt, withOpt) => {
+    t.is(withOpt.functions.length, withoutOpt.functions.length);
+    t.is(countAll("call_indirect", withOpt), 1);
+}, `
+static int twice(int x) { return x * 2; }
+static int half(int x) { return x / 2; }
+
+static int apply(int (*f)(int), int x) { return f(x); }
+
+int test(int x, int y) { return apply(y ? twice : half, x); }
+`);
@@ -0,0 +1,56 @@
+import test from "ava";
+import {compileSnippet} from "../../src/compile";
+import {setFlags} from "../../src/optimisation/flags";
+import {i32Type} from "../../src/wasm";
+import {optimisationTest} from "./index";
+
+optimisationTest("stackify locals", {
+    stackify_locals: true,
+    unused_locals: true
+}, (t, withoutOpt, withOpt) => {
+    t.deepEqual(withoutOpt.functions[0].locals, [i32Type, i32Type]);
+    t.deepEqual(withOpt.functions[0].locals, []);
+    t.deepEqual(withOpt.functions[0].body.instructions.filter(x => x.name.startsWith("local.")).map(x => x.name),
+        ["local.get", "local.get"]);
+}, `
+import int f(int);
+import int g(int, int);
+
+int test(int x) {
+  int a = f(x);
+  int b = f(x + 1);
+  return g(a, b);
+}
+`);
+
+optimisationTest("stackify conflicting memory access", {
+    stackify_locals: true,
+    unused_locals: true
+}, (t, withoutOpt, withOpt) => {
+    // load can't be moved after the store
+    t.deepEqual(withoutOpt.functions[0].locals, [i32Type]);
+    t.deepEqual(withOpt.functions[0].locals, [i32Type]);
+}, `
+int test(int* p) {
+  int a = *p;
+  *p = 5;
+  return a;
+}
+`);
+
+test("stackify correctness", async t => {
+    setFlags("none");
+    setFlags({stackify_locals: true, unused_locals: true});
+    const module = compileSnippet(`
+int test(int* p, int x) {
+  int a = *p;
+  int b = x * 2;
+  *p = b;
+  int c = *p + a;
+  return c - b;
+}`);
+    setFlags("default");
+
+    const {test} = await module.execute({}) as {test: (p: number, x: number) => number};
+    t.is(test(64, 5), 0);
+});
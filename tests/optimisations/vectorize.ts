@@ -0,0 +1,78 @@
+import {countInstructions, optimisationTest} from "./index";
+
+type TestFn = (k: number) => number;
+
+optimisationTest("vectorize element-wise loop", {
+    generation_vectorize_loops: true
+}, async (t, withoutOpt, withOpt) => {
+    t.is(countInstructions("v128.store", withoutOpt.functions[0].body, true), 0);
+    t.is(countInstructions("v128.store", withOpt.functions[0].body, true), 1);
+    t.is(countInstructions("i32x4.mul", withOpt.functions[0].body, true), 1);
+
+    // 37 elements, so the scalar loop handles the last element
+    const expected = (await withoutOpt.execute({}) as {test: TestFn}).test(7);
+    t.is((await withOpt.execute({}) as {test: TestFn}).test(7), expected);
+}, `
+int a[37], b[37], c[37];
+
+int test(int k) {
+  for (int i = 0; i < 37; i++) {
+    b[i] = i * 3;
+    c[i] = 100 - i;
+  }
+
+  for (int i = 0; i < 37; i++) a[i] = b[i] * k + c[i];
+
+  int sum = 0;
+  for (int i = 0; i < 37; i++) sum = sum * 31 + a[i];
+  return sum;
+}
+`);
+
+optimisationTest("vectorize compound float assignment", {
+    generation_vectorize_loops: true
+}, async (t, withoutOpt, withOpt) => {
+    t.is(countInstructions("f32x4.add", withOpt.functions[0].body, true), 1);
+
+    const expected = (await withoutOpt.execute({}) as {test: TestFn}).test(10);
+    t.is((await withOpt.execute({}) as {test: TestFn}).test(10), expected);
+}, `
+float f[19], g[19];
+
+int test(int n) {
+  for (int i = 0; i < 19; i++) {
+    f[i] = i;
+    g[i] = 0.5f * i;
+  }
+
+  for (int i = 0; i < n; i++) f[i] += g[i] * 2.0f;
+
+  float sum = 0;
+  for (int i = 0; i < 19; i++) sum = sum * 3 + f[i];
+  return (int) sum;
+}
+`);
+
+optimisationTest("vectorize overlapping pointers", {
+    generation_vectorize_loops: true
+}, async (t, withoutOpt, withOpt) => {
+    t.is(countInstructions("v128.store", withOpt.functions[0].body, true), 1);
+
+    // q = p + 1, so each element depends on the previous iteration and the vector loop must not be used
+    const expected = (await withoutOpt.execute({}) as {test: TestFn}).test(1);
+    t.is((await withOpt.execute({}) as {test: TestFn}).test(1), expected);
+}, `
+int data[20];
+
+int test(int offset) {
+  for (int i = 0; i < 20; i++) data[i] = i;
+
+  int* p = data;
+  int* q = data + offset;
+  for (int i = 0; i < 16; i++) q[i] = p[i];
+
+  int sum = 0;
+  for (int i = 0; i < 20; i++) sum = sum * 31 + data[i];
+  return sum;
+}
+`);
@@ -0,0 +1,46 @@
+import test from "ava";
+import fs from "fs";
+import os from "os";
+import path from "path";
+import {compileCached, setFlags} from "../../src";
+import {compileSnippet} from "../../src/compile";
+import {Instructions} from "../../src/wasm";
+
+const source = `int square(int x) { return x * x; }`;
+
+test.serial("compiled modules are cached", async t => {
+    const dir = fs.mkdtempSync(path.join(os.tmpdir(), "c2wasm-cache-"));
+    try {
+        const module = compileCached(source, undefined, undefined, dir);
+        t.is(compileCached(source, undefined, undefined, dir), module);
+        t.is(compileCached(new Map([["main.c", source]])), module);
+
+        const files = fs.readdirSync(dir);
+        t.is(files.length, 1);
+        t.deepEqual(new Uint8Array(fs.readFileSync(path.join(dir, files[0]))), module.toBytes());
+
+        // definitions and flags are part of the key
+        t.not(compileCached(source, {X: "1"}, undefined, dir), module);
+        setFlags("none");
+        t.not(compileCached(source, undefined, undefined, dir), module);
+        setFlags("default");
+        t.is(fs.readdirSync(dir).length, 3);
+
+        const {square} = await module.execute({}) as {square: (x: number) => number};
+        t.is(square(12), 144);
+    } finally {
+        fs.rmSync(dir, {recursive: true});
+    }
+});
+
+test("modifying an encoded module invalidates it", async t => {
+    const module = compileSnippet(source);
+    const bytes = module.toBytes();
+
+    const body = module.functions[0].body;
+    body.replace(0, body.instructions.length, Instructions.i32.const(7));
+    t.notDeepEqual(module.toBytes(), bytes);
+
+    const {square} = await module.execute({}) as {square: (x: number) => number};
+    t.is(square(12), 7);
+});
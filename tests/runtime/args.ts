@@ -1,5 +1,5 @@
 import test from "ava";
-import {mainWrapper} from "../../src/c_library/runtime/args";
+import {InstancePool, mainWrapper} from "../../src/c_library/runtime/args";
 import {compile, compileSnippet} from "../../src/compile";
 
 
@@ -62,3 +62,60 @@ int main() {
 }`).execute({});
     t.is(mainWrapper(exports, []), 42);
 });
+
+test("instance pool", async t => {
+    let output = "";
+    const module = await compile(`
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static int runs;
+static char *last = "none";
+
+int main(int argc, char *argv[]) {
+    if (argc > 1 && strcmp(argv[1], "trap") == 0) abort();
+    char *copy = malloc(strlen(argv[argc - 1]) + 1);
+    strcpy(copy, argv[argc - 1]);
+    printf("%d %s %s\\n", ++runs, last, copy);
+    last = copy;
+    return argc;
+}`).compileModule();
+
+    const pool = new InstancePool(module, {c2wasm: {__put_char: (x: number) => output += String.fromCharCode(x)}}, {
+        maxIdle: 1
+    });
+
+    // static variables, the heap and the stack pointer are reset between runs
+    for (const arg of ["first", "second", "third"]) {
+        t.is(await pool.main([arg]), 1);
+        t.is(output, `1 none ${arg}\n`);
+        output = "";
+    }
+    t.is(await pool.main(["a", "b"]), 2);
+    output = "";
+
+    // trapped instances are replaced
+    await t.throwsAsync(pool.main(["x", "trap"]));
+    t.is(await pool.main(["after"]), 1);
+    t.is(output, "1 none after\n");
+    output = "";
+
+    // async runs keep their instance until the promise settles
+    let asyncInstance: WebAssembly.Exports | undefined;
+    const pending = pool.run(async instance => {
+        asyncInstance = instance;
+        await new Promise(resolve => setTimeout(resolve, 10));
+        return mainWrapper(instance, ["async"]);
+    });
+    await pool.run(instance => t.not(instance, asyncInstance));
+    t.is(await pending, 1);
+    t.is(output, "1 none async\n");
+
+    // and are discarded if it rejects
+    await t.throwsAsync(pool.run(async instance => {
+        asyncInstance = instance;
+        throw new Error("rejected");
+    }));
+    await pool.run(instance => t.not(instance, asyncInstance));
+});
@@ -1,5 +1,5 @@
 import test from "ava";
-import {compile} from "../../src";
+import {compile, runtime} from "../../src";
 import {Files, FileLike} from "../../src/c_library/runtime/files";
 
 test("basic IO", async t => {
@@ -217,3 +217,182 @@ int main() {
     files.delete("num.txt");
     t.deepEqual([main(), main(), main()], [0, 1, 2]);
 });
+
+test("buffered writes", async t => {
+    let output = "", writes = 0, putChars = 0;
+    const files = new Files((c) => output += c);
+    const imports = files.getImports();
+
+    const exports = await compile(`
+#include <stdio.h>
+
+int main() {
+  FILE* f = fopen("out.txt", "w");
+  for (int i = 0; i < 10000; i++) fputc('a' + i % 26, f);
+  fclose(f);
+
+  printf("unbuffered %d\\n", 1);
+
+  char buf[64];
+  if (setvbuf(stdout, buf, _IOFBF, 0) != -1) return 1; // a caller's buffer needs a size
+  setvbuf(stdout, buf, _IOLBF, sizeof(buf));
+  printf("line ");
+  printf("buffered\\n");
+
+  setvbuf(stdout, NULL, _IOFBF, 0);
+  printf("fully buffered");
+  return 0;
+}
+    `, {FILES: "1"}).execute({c2wasm: {
+        ...imports,
+        __write: (handle: number, ptr: number, len: number) => {
+            writes++;
+            return imports.__write(handle, ptr, len);
+        },
+        __put_char: (handle: number, c: number) => {
+            if (handle !== 3) putChars++; // filenames are always written using __put_char
+            return imports.__put_char(handle, c);
+        }
+    }});
+    files.attach(exports);
+
+    t.is(runtime.mainWrapper(exports, []), 0);
+    t.is(output, "unbuffered 1\nline buffered\nfully buffered");
+    t.is(files.getContents("out.txt")?.length, 10000);
+    t.is(putChars, 0);
+    t.is(writes, 3 + 1 + 1 + 1); // 4096 byte file buffer, printf, line, flush after main
+});
+
+test("unattached bulk writes", async t => {
+    let output = "";
+    const files = new Files((c) => output += c);
+
+    const {main} = await compile(`
+#include <stdio.h>
+
+int main() {
+  FILE* f = fopen("out.txt", "w");
+  fputs("Hello", f);
+  fflush(f);
+  fclose(f);
+  puts("World");
+  return 0;
+}
+    `, {FILES: "1"}).execute({c2wasm: {
+        ...files.getImports()
+    }}) as {main: () => number};
+
+    t.is(main(), 0);
+    t.is(output, "World\n");
+    t.is(new TextDecoder().decode(files.getContents("out.txt")), "Hello");
+});
+
+test("attaching after unsupported writes", async t => {
+    let output = "", writes = 0;
+    const files = new Files((c) => output += c);
+    const imports = files.getImports();
+
+    const exports = await compile(`
+#include <stdio.h>
+
+void before() {
+  fputs("before\\n", stdout);
+}
+
+int main() {
+  fputs("after\\n", stdout);
+  return 0;
+}
+    `, {FILES: "1"}).execute({c2wasm: {
+        ...imports,
+        __write: (handle: number, ptr: number, len: number) => {
+            writes++;
+            return imports.__write(handle, ptr, len);
+        }
+    }});
+
+    (exports.before as () => void)();
+    t.is(writes, 1); // unsupported, falls back to __put_char
+
+    files.attach(exports);
+    t.is(runtime.mainWrapper(exports, []), 0);
+    t.is(output, "before\nafter\n");
+    t.is(writes, 2);
+});
+
+test("buffered reads", async t => {
+    let output = "", reads = 0, getChars = 0;
+    const contents = new TextEncoder().encode("first line\nsecond line\n" + "0123456789".repeat(1000) + "\n42 43\n");
+    const files = new Files((c) => output += c, () => "from stdin\n", new Map([["in.txt", contents]]));
+    const imports = files.getImports();
+
+    const exports = await compile(`
+#include <stdio.h>
+#include <string.h>
+
+char line[64], data[10001], input[64];
+
+int main() {
+  FILE* f = fopen("in.txt", "r");
+  if (!fgets(line, sizeof(line), f) || strcmp(line, "first line\\n")) return 1;
+  if (fgetc(f) != 's') return 2;
+  if (ftell(f) != 12) return 3;
+  if (!fgets(line, sizeof(line), f) || strcmp(line, "econd line\\n")) return 4;
+
+  if (fread(data, 1, 10001, f) != 10001 || data[9999] != '9' || data[10000] != '\\n') return 5;
+  int a, b;
+  if (fscanf(f, "%d %d", &a, &b) != 2 || a != 42 || b != 43) return 6;
+  if (fgetc(f) != '\\n' || fgetc(f) != EOF || !feof(f)) return 7;
+  fclose(f);
+
+  if (!fgets(input, sizeof(input), stdin)) return 8;
+  printf("%s", input);
+  return 0;
+}
+    `, {FILES: "1"}).execute({c2wasm: {
+        ...imports,
+        __read: (handle: number, ptr: number, len: number) => {
+            reads++;
+            return imports.__read(handle, ptr, len);
+        },
+        __get_char: (handle: number) => {
+            getChars++;
+            return imports.__get_char(handle);
+        }
+    }});
+    files.attach(exports);
+
+    t.is(runtime.mainWrapper(exports, []), 0);
+    t.is(output, "from stdin\n");
+    t.is(getChars, 0);
+    t.true(reads <= 8);
+});
+
+test("files without copying", async t => {
+    const contents = new TextEncoder().encode("abc");
+    const files = new Files((c) => c, undefined, new Map([["data.txt", contents]]));
+
+    const {main} = await compile(`
+#include <stdio.h>
+
+int main(int n) {
+  FILE* f = fopen("data.txt", "r+");
+  for (int i = 0; i < n; i++) fputc('X', f);
+  fclose(f);
+  return 0;
+}
+    `, {FILES: "1"}).execute({c2wasm: {
+        ...files.getImports()
+    }}) as {main: (n: number) => number};
+
+    // the file uses the provided array until it needs to grow
+    main(2);
+    t.is(new TextDecoder().decode(contents), "XXc");
+    t.is(files.getContents("data.txt")?.buffer, contents.buffer);
+
+    main(1000);
+    const grown = files.getContents("data.txt");
+    t.is(grown?.length, 1000);
+    t.not(grown?.buffer, contents.buffer);
+    t.true(grown?.every(c => c === "X".charCodeAt(0)));
+});
@@ -0,0 +1,50 @@
+import test from "ava";
+import {compile, runtime} from "../../src";
+
+const source = `
+#include <stdlib.h>
+
+void* keep[4];
+
+void allocate() {
+  for (int i = 0; i < 4; i++) keep[i] = malloc(100);
+  free(keep[1]);
+  free(keep[2]);
+  keep[3] = realloc(keep[3], 5000);
+  free(malloc(10));
+}
+
+void release() {
+  free(keep[0]);
+  free(keep[3]);
+}`;
+
+test("heap stats", async t => {
+    const exports = await compile(source, {ALLOC_STATS: "1"}).execute({});
+    (exports.allocate as () => void)();
+
+    const stats = runtime.heapStats(exports);
+    t.is(stats.allocations, 5);
+    t.is(stats.reallocations, 1);
+    t.is(stats.frees, 3);
+    t.is(stats.inUse, 128 + 5024); // keep[0] and keep[3], including the 16 byte headers
+    t.true(stats.peakInUse >= stats.inUse);
+    t.is(stats.freeChunks, 1); // keep[1] and keep[2] are merged
+    t.true(stats.largestFree >= 224);
+    t.is(stats.growCalls, 1);
+    t.is(stats.heapSize, 65536);
+    t.is(stats.sizeBuckets[0], 1);
+    t.is(stats.sizeBuckets[3], 4);
+
+    (exports.release as () => void)();
+    const after = runtime.heapStats(exports);
+    t.is(after.inUse, 0);
+    t.is(after.freeChunks, 0);
+    t.is(after.frees, 5);
+});
+
+test("heap stats disabled", async t => {
+    const exports = await compile(source).execute({});
+    t.is(exports.__heap_stats, undefined);
+    t.throws(() => runtime.heapStats(exports));
+});
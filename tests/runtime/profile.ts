@@ -0,0 +1,63 @@
+import test from "ava";
+import {compile, runtime} from "../../src";
+
+const source = `
+int classify(int x) {
+  switch (x % 4) {
+    case 0: return 10;
+    case 1: return 20;
+    case 3: return 30;
+    default: return 40;
+  }
+}
+
+int main() {
+  int total = 0;
+  for (int i = 0; i < 100; i++) {
+    if (i < 90) total += classify(3);
+    else total += classify(i);
+  }
+  return total;
+}`;
+
+test("instrumented counters", async t => {
+    const exports = await compile(source, undefined, {instrument: true}).execute({});
+    const result = (exports.main as () => number)();
+
+    const profile = runtime.dumpProfile(exports);
+    t.is(profile.functions.main, 1);
+    t.is(profile.functions.classify, 100);
+    t.deepEqual(profile.branches.main, [90, 10]);
+    t.deepEqual(profile.branches.classify, [2, 2, 93, 3]);
+
+    // compiling with the profile doesn't change the result
+    const {main} = await compile(source, undefined, {profile}).execute({}) as {main: () => number};
+    t.is(main(), result);
+});
+
+test("uninstrumented module", async t => {
+    const exports = await compile(source).execute({});
+    t.throws(() => runtime.dumpProfile(exports));
+});
+
+test("re-encoding an instrumented module", t => {
+    const module = compile(source, undefined, {instrument: true});
+    const bytes = module.toBytes();
+    module.changed();
+    t.deepEqual(module.toBytes(), bytes);
+});
+
+test("static functions are counted per file", async t => {
+    const files = new Map([
+        ["a.c", `static int helper(void) { return 1; }\nint a(void) { return helper(); }`],
+        ["b.c", `static int helper(void) { return 2; }\nint b(void) { return helper(); }`],
+        ["main.c", `int a(void); int b(void);\nint main() { int x = 0; for (int i = 0; i < 3; i++) x += b(); return x + a(); }`]
+    ]);
+    const exports = await compile(files, undefined, {instrument: true}).execute({});
+    t.is((exports.main as () => number)(), 7);
+
+    const profile = runtime.dumpProfile(exports);
+    t.is(profile.functions["helper@a.c"], 1);
+    t.is(profile.functions["helper@b.c"], 3);
+    t.is(profile.functions.helper, undefined);
+});
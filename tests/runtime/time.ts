@@ -0,0 +1,48 @@
+import test from "ava";
+import {compile, runtime} from "../../src";
+
+const source = `
+#include <time.h>
+
+long now(void) { return __c2wasm_now_ns(); }
+
+long monotonic(void) {
+  struct timespec ts;
+  if (clock_gettime(CLOCK_MONOTONIC, &ts) != 0) return -1;
+  return ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+long seconds(void) {
+  time_t t;
+  long result = time(&t);
+  return result == t ? result : -1;
+}
+
+int invalid(void) {
+  struct timespec ts;
+  return clock_gettime(5, &ts);
+}`;
+
+type Exports = {now: () => bigint, monotonic: () => bigint, seconds: () => bigint, invalid: () => number};
+
+test("clocks", async t => {
+    const exports = await compile(source).execute({c2wasm: runtime.timeImports()}) as Exports;
+
+    const a = exports.now(), b = exports.monotonic(), c = exports.now();
+    t.true(a <= b && b <= c);
+    t.true(c - a < 1000000000n);
+
+    const seconds = Number(exports.seconds());
+    t.true(Math.abs(seconds - Date.now() / 1000) < 2);
+    t.is(exports.invalid(), -1);
+});
+
+test("deterministic clocks", async t => {
+    const exports = await compile(source, {DETERMINISTIC_TIME: "1000"}).execute({}) as Exports;
+
+    // every read advances the shared counter by 1000ns, without any imports
+    t.is(exports.now(), 1000n);
+    t.is(exports.monotonic(), 2000n);
+    t.is(exports.now(), 3000n);
+    t.is(exports.seconds(), 0n);
+});
@@ -0,0 +1,41 @@
+import test from "ava";
+import {compile} from "../../src/compile";
+
+test("c2wasm/arena.h", async t => {
+    const {main} = await compile(`
+#include <c2wasm/arena.h>
+#include <stdint.h>
+
+int main() {
+  arena_t* arena = arena_create();
+
+  int* a = arena_alloc(arena, sizeof(int));
+  int* b = arena_alloc(arena, sizeof(int));
+  if ((uintptr_t) a % 16 != 0 || b <= a) return 1;
+
+  char* aligned = arena_alloc_aligned(arena, 3, 256);
+  if ((uintptr_t) aligned % 256 != 0) return 2;
+
+  // reset releases everything after the mark, including extra blocks
+  arena_mark_t mark = arena_mark(arena);
+  char* first = arena_alloc(arena, 100);
+  for (int i = 0; i < 100; i++) arena_alloc(arena, 10000);
+  arena_reset(arena, mark);
+  if (arena_alloc(arena, 100) != first) return 3;
+
+  // allocations larger than a block
+  char* large = arena_alloc(arena, 200000);
+  if (!large) return 4;
+  large[199999] = 1;
+
+  arena_destroy(arena);
+
+  // the released blocks are reused
+  arena_t* arena2 = arena_create();
+  if (!arena2) return 5;
+  arena_destroy(arena2);
+  return 0;
+}`).execute({}) as {main: () => number};
+
+    t.is(main(), 0);
+});
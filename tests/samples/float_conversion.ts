@@ -0,0 +1,120 @@
+import test from "ava";
+import {compile} from "../../src/compile";
+import {Files} from "../../src/c_library/runtime/files";
+
+let seed = 12345;
+function random(): number {
+    seed = (Math.imul(seed, 1103515245) + 12345) >>> 0;
+    return seed / 4294967296;
+}
+const int = (n: number) => Math.floor(random() * n);
+const digits = (n: number) => Array.from({length: n}, () => int(10)).join("");
+
+const f64 = new Float64Array(1), u32 = new Uint32Array(f64.buffer);
+function randomDouble(): number {
+    do {
+        u32[0] = int(2 ** 32);
+        u32[1] = int(2 ** 32);
+    } while (!Number.isFinite(f64[0]));
+    return f64[0];
+}
+
+// decimal strings of every kind, including long ones and ones halfway between doubles which need the exact fallback
+const inputs: string[] = ["0", "-0", "1", "+1.5e3", ".5", "5.", "1e-400", "1e400", "-inf", "Infinity", "nan",
+    "2.2250738585072011e-308", "4.9406564584124654e-324", "2.4703282292062328e-324", "1.7976931348623158e308",
+    "9007199254740993", "9007199254740993.0000000000000000000001", "0.1", "123456789012345678901234567890",
+    `1${"0".repeat(400)}e-400`, `0.${"0".repeat(300)}${digits(500)}`];
+for (let i = 0; i < 2000; i++) {
+    const x = randomDouble();
+    const kind = i % 4;
+    if (kind === 0) inputs.push(String(x));
+    else if (kind === 1) inputs.push(x.toExponential(int(25)));
+    else if (kind === 2) inputs.push(`${digits(1 + int(12))}.${digits(int(8))}`);
+    else inputs.push(`${digits(1 + int(40))}e${int(700) - 350}`);
+}
+
+const source = `
+#include <stdio.h>
+#include <stdlib.h>
+
+static char* inputs[] = {${inputs.map(s => `"${s}"`).join(", ")}};
+
+double parse(int i) { return strtod(inputs[i], NULL); }
+double parse_atof(int i) { return atof(inputs[i]); }
+double parse_scanf(int i) {
+  double d = -1;
+  sscanf(inputs[i], "%lf", &d);
+  return d;
+}
+
+void print(double x, int prec, int fixed) {
+  if (fixed) printf("%.*f|", prec, x);
+  printf("%.*e|%.17g\\n", prec, x, x);
+}
+
+void print_literals(void) {
+  printf("[%.0f|%.0f|%.0f|%.1f|%.2f|%.0e|%.1e]\\n", 0.5, 2.5, 3.5, 0.25, 1.005, 2.5, 1.25);
+  printf("[%g|%g|%g|%g|%g|%g|%g]\\n", 100000.0, 1000000.0, 0.0001, 0.00001, 123456789.0, 0.1, 1e23);
+  printf("[%.3g|%#.3g|%.0g|%#g|%G|%g|%g]\\n", 3.14159, 2.0, 0.5, 1.0, 1e-10, 0.0, -0.0);
+  printf("[%f|%e|%.20e|%.30f]\\n", 1e23, 5e-324, 0.1, 0.1);
+  printf("[%10.3f|%-10.2e|%+08.2f|% g|%010g|%-+8.1f]\\n", 3.14159, 314.159, -2.5, 1.5, -1.5, 2.25);
+  printf("[%f|%F|%e|%5f|%-6f|%+f]\\n", 1.0 / 0.0, 1.0 / 0.0, -1.0 / 0.0, 1.0 / 0.0, -1.0 / 0.0, 1.0 / 0.0);
+  printf("[%.0f|%.17g|%.17g]\\n", 1e300, 2.2250738585072014e-308, 9007199254740993.0);
+}`;
+
+type Exports = {
+    parse: (i: number) => number,
+    parse_atof: (i: number) => number,
+    parse_scanf: (i: number) => number,
+    print: (x: number, prec: number, fixed: number) => void,
+    print_literals: () => void,
+};
+
+async function instantiate(): Promise<[Exports, () => string]> {
+    let output = "";
+    const files = new Files(c => output += c);
+    const exports = await compile(source, {FILES: "1"}).execute({c2wasm: files.getImports()}) as Exports;
+    return [exports, () => {
+        const result = output;
+        output = "";
+        return result;
+    }];
+}
+
+test("strtod, atof and scanf are correctly rounded", async t => {
+    const [exports] = await instantiate();
+
+    for (const [i, input] of inputs.entries()) {
+        const expected = input.endsWith("inf") ? -Infinity : input === "nan" ? NaN : Number(input);
+        t.is(exports.parse(i), expected, input);
+        t.is(exports.parse_atof(i), expected, input);
+        t.is(exports.parse_scanf(i), expected, input);
+    }
+});
+
+test("printf float conversions are exact", async t => {
+    const [exports, output] = await instantiate();
+
+    // JavaScript rounds exact ties up rather than to even, which random doubles don't hit
+    for (let i = 0; i < 3000; i++) {
+        const x = i % 2 ? randomDouble() : (random() - 0.5) * 10 ** int(30);
+        const prec = i % 10 ? int(20) : int(100);
+        const fixed = Math.abs(x) < 1e21;
+        exports.print(x, prec, fixed ? 1 : 0);
+
+        const parts = output().trimEnd().split("|");
+        const exponential = x.toExponential(prec).replace(/e([+-])(\d)$/, "e$10$2");
+        t.deepEqual(parts, [...(fixed ? [x.toFixed(prec)] : []), exponential, parts[parts.length - 1]]);
+        t.is(Number(parts[parts.length - 1]), x, "%.17g round trips");
+    }
+
+    exports.print_literals();
+    t.is(output(), `[0|2|4|0.2|1.00|2e+00|1.2e+00]
+[100000|1e+06|0.0001|1e-05|1.23457e+08|0.1|1e+23]
+[3.14|2.00|0.5|1.00000|1E-10|0|-0]
+[99999999999999991611392.000000|4.940656e-324|1.00000000000000005551e-01|0.100000000000000005551115123126]
+[     3.142|3.14e+02  |-0002.50| 1.5|-0000001.5|+2.2    ]
+[inf|INF|-inf|  inf|-inf  |+inf]
+[${BigInt(1e300)}|2.2250738585072014e-308|9007199254740992]
+`);
+});
@@ -0,0 +1,181 @@
+import test from "ava";
+import {compile} from "../../src/compile";
+
+const unary = ["sin", "cos", "tan", "asin", "acos", "atan", "exp", "expm1", "log", "log2", "log10", "log1p", "sinh",
+    "cosh", "tanh"] as const;
+
+const source = `
+#include <math.h>
+${unary.map(f => `double t_${f}(double x) { return ${f}(x); }`).join("\n")}
+double t_pow(double x, double y) { return pow(x, y); }
+double t_atan2(double y, double x) { return atan2(y, x); }
+double t_fmod(double x, double y) { return fmod(x, y); }
+double t_ldexp(double x, int n) { return ldexp(x, n); }
+double t_exp2(double x) { return exp2(x); }
+
+static int exponent;
+double t_frexp(double x) { return frexp(x, &exponent); }
+int t_frexp_exponent(void) { return exponent; }
+
+static double integral;
+double t_modf(double x) { return modf(x, &integral); }
+double t_modf_integral(void) { return integral; }
+
+float t_sinf(float x) { return sinf(x); }
+float t_expf(float x) { return expf(x); }
+float t_powf(float x, float y) { return powf(x, y); }`;
+
+type Exports = {[name: string]: (...args: number[]) => number};
+
+const f64 = new Float64Array(1), u64 = new BigInt64Array(f64.buffer);
+const f32 = new Float32Array(1), u32 = new Int32Array(f32.buffer);
+
+/** Distance in units in the last place between two doubles, counting representable values between them */
+function ulps(a: number, b: number, float = false): number {
+    if (Number.isNaN(a) || Number.isNaN(b)) return Number.isNaN(a) && Number.isNaN(b) ? 0 : Infinity;
+    if (a === b) return 0;
+    const ordered = (x: number) => {
+        if (float) {
+            f32[0] = x;
+            return BigInt(u32[0] < 0 ? -(u32[0] & 0x7fffffff) : u32[0]);
+        }
+        f64[0] = x;
+        return u64[0] < 0n ? -(u64[0] & 0x7fffffffffffffffn) : u64[0];
+    };
+    const d = ordered(a) - ordered(b);
+    return Number(d < 0n ? -d : d);
+}
+
+let seed = 12345;
+function random(): number {
+    seed = (Math.imul(seed, 1103515245) + 12345) >>> 0;
+    return seed / 4294967296;
+}
+const uniform = (a: number, b: number) => a + (b - a) * random();
+const logUniform = (a: number, b: number) => Math.exp(uniform(Math.log(a), Math.log(b))) * (random() < 0.5 ? -1 : 1);
+
+/*
+ * Node's Math functions are within 1 ulp, so these bounds are the error of each implementation plus 1, rounded down.
+ * Checked natively, the errors are under 0.9 ulp except cosh (0.999), expm1 (1.0), atan2 (1.4), sinh (1.5) and
+ * tanh (1.8). Math.pow is only within a few ulp.
+ */
+const bounds: {[name: string]: [number, () => number]} = {
+    sin: [1, () => logUniform(1e-10, 1e20)],
+    cos: [1, () => logUniform(1e-10, 1e20)],
+    tan: [1, () => logUniform(1e-10, 1e20)],
+    asin: [1, () => uniform(-1, 1)],
+    acos: [1, () => uniform(-1, 1)],
+    atan: [1, () => logUniform(1e-10, 1e20)],
+    exp: [1, () => uniform(-745, 710)],
+    expm1: [2, () => logUniform(1e-10, 700)],
+    log: [1, () => Math.abs(logUniform(1e-310, 1e308))],
+    log2: [1, () => Math.abs(logUniform(1e-310, 1e308))],
+    log10: [1, () => Math.abs(logUniform(1e-310, 1e308))],
+    log1p: [1, () => logUniform(1e-10, 0.9)],
+    sinh: [2, () => logUniform(1e-10, 710)],
+    cosh: [2, () => logUniform(1e-10, 710)],
+    tanh: [2, () => logUniform(1e-10, 20)],
+};
+
+test("math.h accuracy", async t => {
+    const exports = await compile(source).execute({}) as Exports;
+
+    for (const f of unary) {
+        const [bound, input] = bounds[f];
+        let worst = 0, worstInput = 0;
+        for (let i = 0; i < 20000; i++) {
+            const x = input();
+            const error = ulps(exports[`t_${f}`](x), Math[f](x));
+            if (error > worst) [worst, worstInput] = [error, x];
+        }
+        t.true(worst <= bound, `${f}(${worstInput}) is ${worst} ulp from Math.${f}`);
+    }
+
+    let worstPow = 0, worstAtan2 = 0, worstExp2 = 0;
+    for (let i = 0; i < 20000; i++) {
+        const x = Math.abs(logUniform(1e-5, 1e5)), y = uniform(-700, 700) / Math.log(x);
+        worstPow = Math.max(worstPow, ulps(exports.t_pow(x, y), Math.pow(x, y)));
+        const a = logUniform(1e-200, 1e200), b = logUniform(1e-200, 1e200);
+        worstAtan2 = Math.max(worstAtan2, ulps(exports.t_atan2(a, b), Math.atan2(a, b)));
+        const e = uniform(-1074, 1023);
+        worstExp2 = Math.max(worstExp2, ulps(exports.t_exp2(e), Math.pow(2, e)));
+    }
+    t.true(worstPow <= 2, `pow is ${worstPow} ulp from Math.pow`);
+    t.true(worstAtan2 <= 2, `atan2 is ${worstAtan2} ulp from Math.atan2`);
+    t.true(worstExp2 <= 2, `exp2 is ${worstExp2} ulp from Math.pow(2, x)`);
+
+    // float versions are within 1 ulp of the rounded double result
+    for (let i = 0; i < 5000; i++) {
+        const x = Math.fround(uniform(-100, 100)), y = Math.fround(uniform(-10, 10));
+        t.true(ulps(exports.t_sinf(x), Math.fround(Math.sin(x)), true) <= 1);
+        t.true(ulps(exports.t_expf(x), Math.fround(Math.exp(x)), true) <= 1);
+        t.true(ulps(exports.t_powf(Math.abs(x), y), Math.fround(Math.pow(Math.abs(x), y)), true) <= 1);
+    }
+});
+
+test("math.h exact functions", async t => {
+    const exports = await compile(source).execute({}) as Exports;
+
+    for (let i = 0; i < 20000; i++) {
+        const x = logUniform(1e-310, 1e308), y = logUniform(1e-310, 1e308);
+        t.true(Object.is(exports.t_fmod(x, y), x % y), `fmod(${x}, ${y})`);
+
+        const m = exports.t_frexp(x), e = exports.t_frexp_exponent();
+        const scaled = e > 0 ? m * 2 ** (e - 1) * 2 : m * 2 ** e; // 2^e overflows for the largest values
+        t.true(Math.abs(m) >= 0.5 && Math.abs(m) < 1 && scaled === x, `frexp(${x})`);
+
+        const n = Math.floor(uniform(-60, 60));
+        t.is(exports.t_ldexp(x, n), x * 2 ** n);
+
+        const frac = exports.t_modf(x);
+        t.is(exports.t_modf_integral(), Math.trunc(x));
+        t.true(Object.is(frac, x - Math.trunc(x) || (x < 0 ? -0 : 0)), `modf(${x})`);
+    }
+});
+
+test("math.h special cases", async t => {
+    const {t_pow, t_atan2, t_fmod, t_log, t_exp, t_sin, t_modf} = await compile(source).execute({}) as Exports;
+
+    // C99 Annex F, which differs from Math.pow for 1^nan and (-1)^inf
+    t.is(t_pow(1, NaN), 1);
+    t.is(t_pow(NaN, 0), 1);
+    t.is(t_pow(-1, Infinity), 1);
+    t.is(t_pow(-1, -Infinity), 1);
+    t.is(t_pow(-0, -3), -Infinity);
+    t.is(t_pow(-0, -2), Infinity);
+    t.is(t_pow(-0, 3), -0);
+    t.is(t_pow(-2, 3), -8);
+    t.is(t_pow(-2, 0.5), NaN);
+    t.is(t_pow(0.5, Infinity), 0);
+    t.is(t_pow(2, -Infinity), 0);
+    t.is(t_pow(-Infinity, -3), -0);
+    t.is(t_pow(-Infinity, 3), -Infinity);
+    t.is(t_pow(2, 1024), Infinity);
+    t.is(t_pow(-2, 1025), -Infinity);
+    t.is(t_pow(2, -1074), 5e-324);
+    t.is(t_pow(10, 15), 1e15);
+
+    t.is(t_atan2(0, -0), Math.PI);
+    t.is(t_atan2(-0, -0), -Math.PI);
+    t.is(t_atan2(-0, 0), -0);
+    t.is(t_atan2(Infinity, -Infinity), 3 * Math.PI / 4);
+    t.is(t_atan2(-1, -Infinity), -Math.PI);
+
+    t.is(t_fmod(-7, 0), NaN);
+    t.is(t_fmod(Infinity, 2), NaN);
+    t.is(t_fmod(-0, 2), -0);
+    t.is(t_fmod(5, Infinity), 5);
+
+    t.is(t_log(0), -Infinity);
+    t.is(t_log(-1), NaN);
+    t.is(t_log(1), 0);
+    t.is(t_log(Infinity), Infinity);
+    t.is(t_exp(-Infinity), 0);
+    t.is(t_exp(710), Infinity);
+    t.is(t_exp(-746), 0);
+    t.is(t_sin(Infinity), NaN);
+    t.is(t_sin(-0), -0);
+
+    t.is(t_modf(-Infinity), -0);
+    t.is(t_modf(NaN), NaN);
+});
@@ -0,0 +1,102 @@
+import test from "ava";
+import {compile} from "../../src/compile";
+import {setFlags} from "../../src/optimisation/flags";
+
+const source = `
+#include <stdlib.h>
+#include <string.h>
+
+struct small { unsigned char key, value[2]; };
+struct record { int key; int value; long tag; };
+struct wide { double key; int value[5]; };
+
+static unsigned char buffer[32 * 3000];
+static unsigned int seed = 1;
+
+static unsigned int next(void) {
+  seed = seed * 1103515245 + 12345;
+  return seed >> 8;
+}
+
+static int cmp_int(const void* a, const void* b) {
+  int x = *(const int*) a, y = *(const int*) b;
+  return (x > y) - (x < y);
+}
+
+static int cmp_small(const void* a, const void* b) {
+  return ((const struct small*) a)->key - ((const struct small*) b)->key;
+}
+
+static int cmp_record(const void* a, const void* b) {
+  return cmp_int(&((const struct record*) a)->key, &((const struct record*) b)->key);
+}
+
+static int cmp_wide(const void* a, const void* b) {
+  double x = ((const struct wide*) a)->key, y = ((const struct wide*) b)->key;
+  return (x > y) - (x < y);
+}
+
+// order independent checksum of the elements
+static unsigned int checksum(const unsigned char* p, size_t n, size_t size) {
+  unsigned int sum = 0;
+  for (size_t i = 0; i < n; i++) {
+    unsigned int h = 0;
+    for (size_t j = 0; j < size; j++) h = h * 31 + p[i * size + j];
+    sum += h * h;
+  }
+  return sum;
+}
+
+// sorts random, sorted, reversed and mostly equal arrays with each element size, comparing the elements afterwards
+int test(void) {
+  int (*cmps[4])(const void*, const void*) = {cmp_small, cmp_int, cmp_record, cmp_wide};
+  size_t sizes[4] = {sizeof(struct small), sizeof(int), sizeof(struct record), sizeof(struct wide)};
+  int fails = 0;
+
+  for (int iter = 0; iter < 400; iter++) {
+    int type = iter % 4, pattern = (iter / 4) % 4;
+    size_t size = sizes[type], n = iter % 10 == 0 ? next() % 3000 : next() % 100;
+
+    for (size_t i = 0; i < n * size; i++) buffer[i] = (unsigned char) next();
+    for (size_t i = 0; i < n; i++) {
+      int key = pattern == 0 ? (int) next() % 1000 : pattern == 1 ? (int) i : pattern == 2 ? (int) (n - i) : (int) next() % 3;
+      if (type == 0) ((struct small*) buffer)[i].key = (unsigned char) key;
+      if (type == 1) ((int*) buffer)[i] = key;
+      if (type == 2) ((struct record*) buffer)[i].key = key;
+      if (type == 3) ((struct wide*) buffer)[i].key = key * 0.5;
+    }
+    unsigned int before = checksum(buffer, n, size);
+
+    // constant comparators, and one through a pointer which can't be specialised
+    if (iter % 12 >= 8) qsort(buffer, n, size, cmps[type]);
+    else if (type == 0) qsort(buffer, n, sizeof(struct small), cmp_small);
+    else if (type == 1) qsort(buffer, n, sizeof(int), cmp_int);
+    else if (type == 2) qsort(buffer, n, sizeof(struct record), cmp_record);
+    else qsort(buffer, n, sizeof(struct wide), cmp_wide);
+
+    if (checksum(buffer, n, size) != before) fails++;
+    for (size_t i = 1; i < n; i++) {
+      if (cmps[type](buffer + (i - 1) * size, buffer + i * size) > 0) {
+        fails++;
+        break;
+      }
+    }
+  }
+  return fails;
+}`;
+
+for (const [name, definitions, flags] of [
+    ["words", {}, {}],
+    ["simd", {QSORT_SIMD: "1"}, {}],
+    ["unspecialised", {}, {specialise_function_pointers: false}],
+    ["inlined", {}, {inlining: true}],
+] as const) {
+    test.serial(`qsort ${name}`, async t => {
+        setFlags(flags);
+        const module = compile(source, definitions);
+        setFlags("default");
+
+        const exports = await module.execute({}) as {test: () => number};
+        t.is(exports.test(), 0);
+    });
+}
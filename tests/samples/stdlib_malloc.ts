@@ -73,3 +73,95 @@ void main() {
     t.assert(output.indexOf("finished\n") > 0);
     t.assert(output.indexOf("Failed!") < 0);
 });
+
+const CALLOC_SOURCE = `
+#include <stdlib.h>
+#include <string.h>
+
+int dirty() {
+  char* a = malloc(100);
+  memset(a, 0xFF, 100);
+  free(a);
+
+  // reuses a
+  char* b = calloc(25, 4);
+  int sum = 0;
+  for (int i = 0; i < 100; i++) sum += b[i];
+  free(b);
+  return b == a ? sum : -1;
+}
+
+int freed(int offset) {
+  unsigned char* a = malloc(64);
+  unsigned char* b = malloc(64);
+  unsigned char* c = malloc(64);
+  memset(b, 1, 64);
+  free(b);
+  return b[offset];
+}`;
+
+test("stdlib.h calloc", async t => {
+    const {dirty, freed} = await compile(CALLOC_SOURCE).execute({}) as {
+        dirty: () => number,
+        freed: (offset: number) => number
+    };
+
+    t.is(dirty(), 0);
+    // free doesn't touch the allocation by default
+    t.is(freed(40), 1);
+});
+
+test("stdlib.h poison freed memory", async t => {
+    const {freed} = await compile(CALLOC_SOURCE, {ALLOC_POISON: "1"}).execute({}) as {
+        freed: (offset: number) => number
+    };
+
+    t.is(freed(40), 0xDD);
+});
+
+test("stdlib.h realloc in place", async t => {
+    const {grow, neighbour, shrink} = await compile(`
+#include <stdlib.h>
+#include <string.h>
+
+// extend into the end of the heap
+int grow() {
+  char* a = malloc(100);
+  memset(a, 7, 100);
+  char* b = realloc(a, 100000);
+  int result = a == b && b[99] == 7;
+  free(b);
+  return result;
+}
+
+// extend into a free chunk after the allocation
+int neighbour() {
+  char* a = malloc(100);
+  char* b = malloc(100);
+  char* c = malloc(100);
+  memset(a, 7, 100);
+  free(b);
+  char* d = realloc(a, 200);
+  int result = a == d && d[99] == 7;
+  free(c);
+  free(d);
+  return result;
+}
+
+// free the end of the allocation
+int shrink() {
+  char* a = malloc(1000);
+  char* b = malloc(100);
+  char* c = realloc(a, 100);
+  char* d = malloc(500);
+  int result = a == c && d > c && d < b;
+  free(b);
+  free(c);
+  free(d);
+  return result;
+}`).execute({}) as {[name: string]: () => number};
+
+    t.is(grow(), 1);
+    t.is(neighbour(), 1);
+    t.is(shrink(), 1);
+});
@@ -0,0 +1,81 @@
+import test from "ava";
+import {compile} from "../../src/compile";
+
+const source = `
+#include <string.h>
+
+static char a[400], b[400];
+static unsigned int seed = 1;
+
+static unsigned int next(void) {
+  seed = seed * 1103515245 + 12345;
+  return seed >> 8;
+}
+
+static int sign(int x) {
+  return (x > 0) - (x < 0);
+}
+
+static size_t ref_strlen(const char* s) {
+  size_t n = 0;
+  while (s[n]) n++;
+  return n;
+}
+
+static const char* ref_memchr(const char* s, int c, size_t n) {
+  for (size_t i = 0; i < n; i++) if ((unsigned char) s[i] == (unsigned char) c) return s + i;
+  return 0;
+}
+
+static int ref_memcmp(const char* l, const char* r, size_t n) {
+  for (size_t i = 0; i < n; i++) if (l[i] != r[i]) return (unsigned char) l[i] - (unsigned char) r[i];
+  return 0;
+}
+
+// compares against simple implementations with random lengths, alignments and contents
+int test(void) {
+  int fails = 0;
+  for (int iter = 0; iter < 3000; iter++) {
+    size_t off = next() % 40, off2 = iter % 2 ? off : next() % 40, len = next() % 200;
+    for (int i = 0; i < 400; i++) a[i] = b[i] = (char) ('a' + next() % 4);
+    a[off + len] = 0;
+    memcpy(b + off2, a + off, len + 1);
+    if (len && next() % 2) b[off2 + next() % len] = (char) (next() % 2 ? 'e' : 0x90);
+
+    char *s = a + off, *t = b + off2;
+    int c = next() % 6 ? 'a' + next() % 6 : 0;
+    size_t n = next() % 250;
+
+    if (strlen(s) != len) fails++;
+    if (strnlen(s, n) != (n < len ? n : len)) fails++;
+    if (memchr(s, c, n) != ref_memchr(s, c, n)) fails++;
+    if (strchr(s, c) != ref_memchr(s, c, len + 1)) fails++;
+    if (sign(strcmp(s, t)) != sign(ref_memcmp(s, t, (ref_strlen(t) < len ? ref_strlen(t) : len) + 1))) fails++;
+    if (sign(memcmp(s, t, len)) != sign(ref_memcmp(s, t, len))) fails++;
+  }
+  return fails;
+}
+
+// strings ending in the last byte of memory
+int memory_end(void) {
+  char* end = (char*) ((size_t) __wasm_i32__(0, 0x3F, 0) * 65536); // wasm: memory.size
+  int fails = 0;
+  for (size_t len = 0; len < 40; len++) {
+    char* s = end - len - 1;
+    for (size_t i = 0; i < len; i++) s[i] = 'x';
+    s[len] = 0;
+    if (strlen(s) != len) fails++;
+    if (strchr(s, 'y') != 0 || strchr(s, 0) != s + len) fails++;
+    if (memchr(s, 'y', len + 1) != 0) fails++;
+    if (strcmp(s, s) != 0 || memcmp(s, s, len + 1) != 0) fails++;
+  }
+  return fails;
+}`;
+
+for (const [name, definitions] of [["word", {}], ["bytewise", {STRING_BYTEWISE: "1"}], ["simd", {STRING_SIMD: "1"}]] as const) {
+    test(`string.h ${name}`, async t => {
+        const exports = await compile(source, definitions).execute({}) as {test: () => number, memory_end: () => number};
+        t.is(exports.test(), 0);
+        t.is(exports.memory_end(), 0);
+    });
+}
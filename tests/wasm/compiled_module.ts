@@ -0,0 +1,30 @@
+import test from "ava";
+import {ModuleBuilder, i32Type, Instructions} from "../../src/wasm";
+
+test("encoded and compiled once", async t => {
+    const m = new ModuleBuilder();
+    m.global(i32Type, true, 5, "counter");
+
+    const bytes = m.toBytes();
+    t.is(m.toBytes(), bytes);
+    t.is(await m.compileModule(), await m.compileModule());
+
+    // each execution is a new instance of the same module
+    const a = await m.execute({}), b = await m.execute({});
+    (a.counter as WebAssembly.Global).value = 10;
+    t.is((b.counter as WebAssembly.Global).value, 5);
+});
+
+test("builder changes are encoded", async t => {
+    const m = new ModuleBuilder();
+    m.function([], [i32Type], () => [Instructions.i32.const(1)], "one");
+    const before = m.toBytes();
+    const module = await m.compileModule();
+
+    m.function([], [i32Type], () => [Instructions.i32.const(2)], "two");
+    t.not(m.toBytes(), before);
+    t.not(await m.compileModule(), module);
+
+    const {two} = await m.execute({}) as {two: () => number};
+    t.is(two(), 2);
+});
@@ -1,3 +1,4 @@
+import {createHash} from "crypto";
 import fs from "fs";
 import {join} from "path";
 
@@ -33,6 +34,21 @@ function bundle(folder: string, outputFile: string, simplify: boolean) {
 const cLib = join(__dirname, '..', 'src', 'c_library');
 bundle(join(cLib, 'impl'),  join(cLib, '_standard_library.json'), true);
 
+// Build id, a hash of the compiler and library sources used to key compileCached's disk cache
+const srcDir = join(__dirname, '..', 'src');
+const hash = createHash("sha256");
+(function hashFolder(path: string) {
+    for (const child of fs.readdirSync(join(srcDir, path)).sort()) {
+        const childPath = path ? path + '/' + child : child;
+        if (fs.statSync(join(srcDir, childPath)).isDirectory()) {
+            hashFolder(childPath);
+        } else if (!child.startsWith("_")) { // generated files
+            hash.update(childPath).update(fs.readFileSync(join(srcDir, childPath)));
+        }
+    }
+})("");
+fs.writeFileSync(join(srcDir, '_build_id.json'), JSON.stringify({id: hash.digest("hex")}));
+
 // Examples
 const exampleDir = join(__dirname, '..', 'tests', 'benchmark');
 const buildDir = join(__dirname, '..', 'build', 'examples');
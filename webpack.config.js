@@ -78,7 +78,7 @@ module.exports = (env, argv) => {
         },
         resolve: {
             extensions: [".ts", ".js"],
-            fallback: {fs: false}
+            fallback: {fs: false, crypto: false}
         },
         module: {
             rules: [{test: /\.ts$/, loader: "ts-loader", options: tsLoaderOptions}]